@@ -114,6 +114,9 @@ public:
     size_t alloc_unused_size() const;
     size_t alloc_free_size() const;
     size_t alloc_commited_size() const;
+    size_t block_read() const { // number of blocks read from file (pool misses)
+        return m_block_read.load(std::memory_order_relaxed);
+    }
 private:
     enum class unlock_result { false_, true_, fixed_ };
     using threadId_mask = thread_id_t::pos_mask;
@@ -151,6 +154,7 @@ private:
     using lock_guard = std::lock_guard<std::mutex>;
     mutable std::mutex m_mutex; // should be improved
     mutable uint32 m_pageAccessTime = 0;
+    std::atomic<size_t> m_block_read{ 0 };
     char * m_zero_block_address = nullptr;
     std::vector<block_index> m_block;
     thread_id_t m_thread_id;
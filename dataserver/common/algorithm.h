@@ -6,6 +6,11 @@
 
 #include "dataserver/common/common.h"
 #include "dataserver/common/time_util.h"
+#include <bitset>
+
+#if defined(SDL_OS_WIN32)
+#include <intrin.h>
+#endif
 
 namespace sdl { namespace algo { namespace scope_exit { 
 
@@ -444,6 +449,21 @@ inline std::string to_lower(std::string s) {
     return s;
 }
 
+inline size_t bit_scan_forward(uint64 const w) { // index of lowest set bit, w != 0
+    SDL_ASSERT(w);
+#if defined(SDL_OS_WIN32)
+    unsigned long index;
+    _BitScanForward64(&index, w);
+    return index;
+#else
+    return static_cast<size_t>(__builtin_ctzll(w));
+#endif
+}
+
+inline size_t bit_count(uint64 const w) {
+    return std::bitset<64>(w).count();
+}
+
 //--------------------------------------------------------------
 
 } // algo
@@ -27,6 +27,9 @@ public:
     const_iterator end() const {
         return data.end();
     }
+    size_t size() const {
+        return data.size();
+    }
     const_iterator find(const key_type & k) const {
         auto const i = std::lower_bound(data.begin(), data.end(), k, 
             [](value_type const & x, const key_type & k) {
@@ -57,6 +57,25 @@ inline void hash_combine_impl(uint32 & h1, uint32 k1)
     h1 = h1 * 5 + 0xe6546b64;
 }
 
+inline uint64 hash_bytes(void const * const p, size_t const size)
+{
+    const char * const begin = static_cast<const char *>(p);
+    const char * const end = begin + size;
+    uint64 h = size;
+    const char * it = begin;
+    for (; it + sizeof(uint64) <= end; it += sizeof(uint64)) {
+        uint64 k;
+        memcpy(&k, it, sizeof(k));
+        hash_combine_impl(h, k);
+    }
+    if (it < end) {
+        uint64 k = 0;
+        memcpy(&k, it, end - it);
+        hash_combine_impl(h, k);
+    }
+    return h;
+}
+
 template <class T>
 inline void hash_combine(std::size_t & seed, T const & v) // see boost::hash_combine
 {
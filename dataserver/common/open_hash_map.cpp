@@ -0,0 +1,38 @@
+// open_hash_map.cpp
+//
+#include "dataserver/common/open_hash_map.h"
+
+#if SDL_DEBUG
+namespace sdl { namespace {
+    class unit_test {
+    public:
+        unit_test() {
+            using T = open_hash_map<int, int>;
+            T m;
+            SDL_ASSERT(m.empty());
+            SDL_ASSERT(m.find(0) == m.end());
+            for (int i = 0; i < 1000; ++i) {
+                m[i % 100] += 1;
+            }
+            SDL_ASSERT(m.size() == 100);
+            int i = 0;
+            for (auto const & it : m) { // insertion order
+                SDL_ASSERT(it.first == i++);
+                SDL_ASSERT(it.second == 10);
+            }
+            SDL_ASSERT(m.find(50)->second == 10);
+            SDL_ASSERT(m.find(100) == m.end());
+            const auto v = m.release();
+            SDL_ASSERT(v.size() == 100);
+            SDL_ASSERT(m.empty());
+            T m2(10);
+            m2[1] = 1;
+            SDL_ASSERT(m2.find(1)->second == 1);
+            const char s[] = "0123456789";
+            SDL_ASSERT(hash_detail::hash_bytes(s, 9) != hash_detail::hash_bytes(s, 10));
+            SDL_ASSERT(hash_detail::hash_bytes(s, 10) == hash_detail::hash_bytes(s, 10));
+        }
+    };
+    static unit_test s_test;
+}} // sdl
+#endif //#if SDL_DEBUG
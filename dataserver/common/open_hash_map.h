@@ -0,0 +1,141 @@
+// open_hash_map.h
+//
+#pragma once
+#ifndef __SDL_COMMON_OPEN_HASH_MAP_H__
+#define __SDL_COMMON_OPEN_HASH_MAP_H__
+
+#include "dataserver/common/hash_combine.h"
+
+namespace sdl {
+
+// open addressing with linear probing;
+// values are kept dense in insertion order, slots hold 32-bit hash tag and value position
+template<class Key, class T, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+class open_hash_map {
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<key_type, mapped_type>;
+private:
+    using vector_type = std::vector<value_type>;
+    struct slot_type {
+        uint32 hash;
+        uint32 pos; // 0 = empty slot, else position in m_data + 1
+    };
+    using slot_vector = std::vector<slot_type>;
+    enum { min_capacity = 16 };
+    vector_type m_data;
+    slot_vector m_slot;
+    size_t m_mask = 0;
+public:
+    using iterator = typename vector_type::iterator;
+    using const_iterator = typename vector_type::const_iterator;
+    open_hash_map() = default;
+    explicit open_hash_map(size_t n) {
+        reserve(n);
+    }
+    open_hash_map(open_hash_map &&) = default;
+    open_hash_map & operator=(open_hash_map &&) = default;
+
+    size_t size() const {
+        return m_data.size();
+    }
+    bool empty() const {
+        return m_data.empty();
+    }
+    iterator begin() {
+        return m_data.begin();
+    }
+    iterator end() {
+        return m_data.end();
+    }
+    const_iterator begin() const {
+        return m_data.begin();
+    }
+    const_iterator end() const {
+        return m_data.end();
+    }
+    vector_type const & data() const {
+        return m_data;
+    }
+    vector_type release() { // moves values out, map becomes empty
+        vector_type result(std::move(m_data));
+        clear();
+        return result;
+    }
+    void clear() {
+        m_data.clear();
+        m_slot.clear();
+        m_mask = 0;
+    }
+    void reserve(size_t n) {
+        m_data.reserve(n);
+        size_t capacity = min_capacity;
+        while (capacity < n * 2) { // load factor <= 0.5
+            capacity <<= 1;
+        }
+        if (capacity > m_slot.size()) {
+            rehash(capacity);
+        }
+    }
+    const_iterator find(key_type const & k) const {
+        if (!m_slot.empty()) {
+            const uint32 h = hash_value(k);
+            for (size_t i = h & m_mask;; i = (i + 1) & m_mask) {
+                slot_type const & s = m_slot[i];
+                if (!s.pos) {
+                    break;
+                }
+                if ((s.hash == h) && KeyEqual()(m_data[s.pos - 1].first, k)) {
+                    return m_data.begin() + (s.pos - 1);
+                }
+            }
+        }
+        return m_data.end();
+    }
+    mapped_type & operator[](key_type const & k) {
+        if ((m_data.size() + 1) * 2 > m_slot.size()) {
+            rehash(m_slot.empty() ? size_t(min_capacity) : m_slot.size() * 2);
+        }
+        const uint32 h = hash_value(k);
+        size_t i = h & m_mask;
+        for (;; i = (i + 1) & m_mask) {
+            slot_type const & s = m_slot[i];
+            if (!s.pos) {
+                break;
+            }
+            if ((s.hash == h) && KeyEqual()(m_data[s.pos - 1].first, k)) {
+                return m_data[s.pos - 1].second;
+            }
+        }
+        SDL_ASSERT(m_data.size() < uint32(-1));
+        m_data.emplace_back(k, T{});
+        m_slot[i] = slot_type{ h, static_cast<uint32>(m_data.size()) };
+        return m_data.back().second;
+    }
+private:
+    static uint32 hash_value(key_type const & k) {
+        const uint64 h = static_cast<uint64>(Hash()(k));
+        return static_cast<uint32>(h ^ (h >> 32));
+    }
+    void rehash(size_t const capacity) {
+        SDL_ASSERT(is_power_two(capacity));
+        SDL_ASSERT(capacity >= m_data.size() * 2);
+        slot_vector old(capacity, slot_type{});
+        old.swap(m_slot);
+        m_mask = capacity - 1;
+        for (slot_type const & s : old) { // hash tag is reused, keys are not rehashed
+            if (s.pos) {
+                size_t i = s.hash & m_mask;
+                while (m_slot[i].pos) {
+                    i = (i + 1) & m_mask;
+                }
+                m_slot[i] = s;
+            }
+        }
+    }
+};
+
+} // sdl
+
+#endif // __SDL_COMMON_OPEN_HASH_MAP_H__
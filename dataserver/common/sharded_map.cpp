@@ -0,0 +1,27 @@
+// sharded_map.cpp
+//
+#include "dataserver/common/sharded_map.h"
+
+#if SDL_DEBUG
+namespace sdl { namespace {
+    class unit_test {
+    public:
+        unit_test() {
+            sharded_map<int, int, std::hash<int>, 4> m;
+            for (int i = 0; i < 10; ++i) {
+                m.set(i, i * 10, 8);
+            }
+            SDL_ASSERT(m.size() == 8);
+            SDL_ASSERT(m.find(7).second && (m.find(7).first == 70));
+            SDL_ASSERT(!m.find(8).second);
+            m.set(7, 77, 8);
+            m.set(9, 90, 8);
+            SDL_ASSERT(m.find(7).first == 77);
+            SDL_ASSERT(!m.find(9).second && (m.size() == 8));
+            m.set(9, 90);
+            SDL_ASSERT(m.find(9).second && (m.size() == 9));
+        }
+    };
+    static unit_test s_test;
+}} // sdl
+#endif //#if SDL_DEBUG
@@ -0,0 +1,69 @@
+// sharded_map.h
+//
+#pragma once
+#ifndef __SDL_COMMON_SHARDED_MAP_H__
+#define __SDL_COMMON_SHARDED_MAP_H__
+
+#include "dataserver/common/compact_map.h"
+#include <mutex>
+#include <atomic>
+
+namespace sdl {
+
+// Map for caches filled on query path: keys are spread over shards, each with its own lock,
+// so concurrent readers and writers of different shards do not contend and insert does not copy the map.
+template<class Key, class T, class Hash, size_t shard_count = 16>
+class sharded_map : noncopyable {
+    static_assert(shard_count && !(shard_count & (shard_count - 1)), "shard_count");
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using map_type = compact_map<key_type, mapped_type>;
+private:
+    using lock_guard = std::lock_guard<std::mutex>;
+    struct shard_type {
+        map_type map;
+        mutable std::mutex mutex;
+    };
+    shard_type m_shard[shard_count];
+    std::atomic<size_t> m_size{0};
+    shard_type & shard(key_type const & key) {
+        return m_shard[Hash()(key) & (shard_count - 1)];
+    }
+    shard_type const & shard(key_type const & key) const {
+        return m_shard[Hash()(key) & (shard_count - 1)];
+    }
+public:
+    sharded_map() = default;
+
+    std::pair<mapped_type, bool> find(key_type const & key) const { // second is false if key is not found
+        shard_type const & s = shard(key);
+        lock_guard lock(s.mutex);
+        auto const found = s.map.find(key);
+        if (found != s.map.end()) {
+            return { found->second, true };
+        }
+        return { mapped_type(), false };
+    }
+    size_t size() const {
+        return m_size.load(std::memory_order_relaxed);
+    }
+    // new key is not inserted if size() reached limit
+    void set(key_type const & key, mapped_type const & value, size_t const limit = size_t(-1)) {
+        shard_type & s = shard(key);
+        lock_guard lock(s.mutex);
+        if (s.map.find(key) != s.map.end()) {
+            s.map[key] = value;
+        }
+        else if (m_size.fetch_add(1, std::memory_order_relaxed) < limit) {
+            s.map[key] = value;
+        }
+        else {
+            m_size.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+};
+
+} // sdl
+
+#endif // __SDL_COMMON_SHARDED_MAP_H__
@@ -0,0 +1,30 @@
+// snapshot_map.cpp
+//
+#include "dataserver/common/snapshot_map.h"
+
+#if SDL_DEBUG
+namespace sdl { namespace {
+    class unit_test {
+    public:
+        unit_test() {
+            snapshot_map<int, int, std::hash<int>> m;
+            for (int i = 0; i < 8; ++i) {
+                m.set(i, i * 10);
+            }
+            SDL_ASSERT(m.find(7).second && (m.find(7).first == 70));
+            SDL_ASSERT(!m.find(8).second);
+            m.publish();
+            SDL_ASSERT(m.find(7).first == 70);
+            m.set(7, 77); // overrides snapshot
+            SDL_ASSERT(m.find(7).first == 77);
+            SDL_ASSERT(m.find(6).first == 60);
+            SDL_ASSERT(!m.find(9).second);
+            for (int i = 9; i < 1000; ++i) { // keys of tables loaded lazily
+                m.set(i, i * 10);
+            }
+            SDL_ASSERT(m.find(9).second && (m.find(999).first == 9990));
+        }
+    };
+    static unit_test s_test;
+}} // sdl
+#endif //#if SDL_DEBUG
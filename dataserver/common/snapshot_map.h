@@ -0,0 +1,83 @@
+// snapshot_map.h
+//
+#pragma once
+#ifndef __SDL_COMMON_SNAPSHOT_MAP_H__
+#define __SDL_COMMON_SNAPSHOT_MAP_H__
+
+#include "dataserver/common/sharded_map.h"
+
+namespace sdl {
+
+// Map is filled under lock until publish(); after that readers use immutable snapshot without lock.
+// Keys set after publish() (e.g. tables loaded lazily on query path) are kept in sharded_map, which overrides snapshot,
+// so insert does not copy the map.
+template<class Key, class T, class Hash>
+class snapshot_map : noncopyable {
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using map_type = compact_map<key_type, mapped_type>;
+private:
+    using lock_guard = std::lock_guard<std::mutex>;
+    using late_map = sharded_map<key_type, mapped_type, Hash>;
+    std::atomic<map_type const *> m_snapshot{ nullptr }; // published map, not changed after publish()
+    map_type m_build;           // map before publish()
+    late_map m_late;            // keys set after publish()
+    mutable std::mutex m_mutex; // readers and writers before publish()
+public:
+    snapshot_map() = default;
+    ~snapshot_map() {
+        delete m_snapshot.load();
+    }
+    std::pair<mapped_type, bool> find(key_type const & key) const { // second is false if key is not found
+        if (map_type const * const map = m_snapshot.load(std::memory_order_acquire)) {
+            return find_published(*map, key);
+        }
+        lock_guard lock(m_mutex);
+        if (map_type const * const map = m_snapshot.load(std::memory_order_relaxed)) {
+            return find_published(*map, key);
+        }
+        return find(m_build, key);
+    }
+    void set(key_type const & key, mapped_type const & value) {
+        if (m_snapshot.load(std::memory_order_acquire)) {
+            m_late.set(key, value);
+            return;
+        }
+        lock_guard lock(m_mutex);
+        if (m_snapshot.load(std::memory_order_relaxed)) {
+            m_late.set(key, value);
+        }
+        else {
+            m_build[key] = value;
+        }
+    }
+    void publish() {
+        lock_guard lock(m_mutex);
+        if (!m_snapshot.load(std::memory_order_relaxed)) {
+            m_snapshot.store(new map_type(std::move(m_build)), std::memory_order_release);
+            m_build = map_type();
+        }
+    }
+private:
+    std::pair<mapped_type, bool> find_published(map_type const & map, key_type const & key) const {
+        if (m_late.size()) { // lock of shard only if keys were set after publish()
+            auto found = m_late.find(key);
+            if (found.second) {
+                return found;
+            }
+        }
+        return find(map, key);
+    }
+    static std::pair<mapped_type, bool> find(map_type const & map, key_type const & key) {
+        auto const found = map.find(key);
+        if (found != map.end()) {
+            return { found->second, true };
+        }
+        return { mapped_type(), false };
+    }
+};
+
+} // sdl
+
+#endif // __SDL_COMMON_SNAPSHOT_MAP_H__
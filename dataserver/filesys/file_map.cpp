@@ -10,8 +10,9 @@ class FileMapping::data_t: noncopyable
 {
     void * m_pFileView = nullptr;
     uint64 m_FileSize = 0;
+    const std::string m_FileName;
 public:
-    explicit data_t(const char* filename);
+    data_t(const char* filename, bool populate);
     ~data_t();
 
     void const * GetFileView() const
@@ -22,9 +23,14 @@ public:
     {
         return m_FileSize;
     }
+    const char * GetFileName() const
+    {
+        return m_FileName.c_str();
+    }
 };
 
-FileMapping::data_t::data_t(const char * const filename)
+FileMapping::data_t::data_t(const char * const filename, bool const populate)
+    : m_FileName(filename)
 {
     const uint64 fsize = FileMapping::GetFileSize(filename);
     if (0 == fsize) {
@@ -33,7 +39,7 @@ FileMapping::data_t::data_t(const char * const filename)
         return;
     }
     A_STATIC_CHECK_TYPE(file_map_detail::view_of_file, m_pFileView);
-    m_pFileView = file_map_detail::map_view_of_file(filename, 0, fsize);
+    m_pFileView = file_map_detail::map_view_of_file(filename, 0, fsize, populate);
     if (m_pFileView) {
         m_FileSize = fsize; // success
     }
@@ -70,6 +76,32 @@ uint64 FileMapping::GetFileSize() const
     return 0;
 }
 
+bool FileMapping::Advise(uint64 const offset, uint64 const size, map_advice const advice) const
+{
+    if (m_data.get()) {
+        SDL_ASSERT(offset + size <= m_data->GetFileSize());
+        if (advice == map_advice::evict) {
+            return file_map_detail::evict(m_data->GetFileName(), const_cast<void *>(m_data->GetFileView()), offset, size);
+        }
+        return file_map_detail::advise(const_cast<void *>(m_data->GetFileView()), offset, size, advice);
+    }
+    return false;
+}
+
+bool FileMapping::Lock(uint64 const offset, uint64 const size, bool const lock) const
+{
+    if (m_data.get()) {
+        SDL_ASSERT(offset + size <= m_data->GetFileSize());
+        return file_map_detail::lock(const_cast<void *>(m_data->GetFileView()), offset, size, lock);
+    }
+    return false;
+}
+
+page_faults FileMapping::GetPageFaults()
+{
+    return file_map_detail::get_page_faults();
+}
+
 bool FileMapping::IsFileMapped() const
 {
     return (GetFileView() != nullptr);
@@ -80,11 +112,11 @@ void FileMapping::UnmapView()
     m_data.reset();
 }
 
-void const * FileMapping::CreateMapView(const char * const filename)
+void const * FileMapping::CreateMapView(const char * const filename, bool const populate)
 {
     UnmapView();
 
-    std::unique_ptr<data_t> p(new data_t(filename));
+    std::unique_ptr<data_t> p(new data_t(filename, populate));
 
     auto ret = p->GetFileView();
     if (ret) {
@@ -8,6 +8,15 @@
 
 namespace sdl {
 
+// access pattern of mapped range;
+// dontneed drops pages from mapping only (they stay in page cache), evict drops them from page cache of file also
+enum class map_advice { normal, random, sequential, willneed, dontneed, evict };
+
+struct page_faults { // of process
+    uint64 minor = 0; // page was in memory (page cache)
+    uint64 major = 0; // page was read from disk
+};
+
 class FileMapping: noncopyable {
     using FileMapping_error = sdl_exception_t<FileMapping>;
 public:
@@ -15,7 +24,8 @@ public:
     ~FileMapping();
 
     // Create file mapping for read-only. Returns nullptr if error
-    void const * CreateMapView(const char* filename);
+    // populate : file is read into memory when mapped (MAP_POPULATE)
+    void const * CreateMapView(const char* filename, bool populate = false);
 
     // Close file mapping
     void UnmapView();
@@ -26,6 +36,18 @@ public:
     
     uint64 GetFileSize() const;
 
+    // Hint for access pattern of range of file, returns false if not supported
+    bool Advise(uint64 offset, uint64 size, map_advice) const;
+
+    // Hint that range of file will be read soon
+    void WillNeed(uint64 offset, uint64 size) const {
+        Advise(offset, size, map_advice::willneed);
+    }
+    // Lock (unlock) range of file in memory, returns false if failed (e.g. limit of locked memory)
+    bool Lock(uint64 offset, uint64 size, bool lock) const;
+
+    static page_faults GetPageFaults(); // zeros if not supported
+
     static uint64 GetFileSize(const char* filename);
     static uint64 GetFileSize(const std::string & s) {
         return GetFileSize(s.c_str());
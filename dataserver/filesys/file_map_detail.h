@@ -4,7 +4,7 @@
 #ifndef __SDL_FILESYS_FILE_MAP_DETAIL_H__
 #define __SDL_FILESYS_FILE_MAP_DETAIL_H__
 
-#include "dataserver/common/common.h"
+#include "dataserver/filesys/file_map.h"
 
 namespace sdl {
 
@@ -15,11 +15,31 @@ struct file_map_detail : is_static
     static view_of_file map_view_of_file(
         const char* filename,
         uint64 offset,
-        uint64 size);
+        uint64 size,
+        bool populate);
 
     static bool unmap_view_of_file(view_of_file, 
         uint64 offset,
         uint64 size);    
+
+    // offset and size of range are relative to view
+    static bool advise(view_of_file,
+        uint64 offset,
+        uint64 size,
+        map_advice);
+
+    // drop range from view and from page cache of file, so that next access reads disk
+    static bool evict(const char * filename,
+        view_of_file,
+        uint64 offset,
+        uint64 size);
+
+    static bool lock(view_of_file,
+        uint64 offset,
+        uint64 size,
+        bool);
+
+    static page_faults get_page_faults();
 };
 
 } // sdl
@@ -5,13 +5,17 @@
 #include "dataserver/filesys/file_map_detail.h"
 #include "dataserver/filesys/file_h.h"
 #include "dataserver/filesys/mmap64_unix.h"
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/resource.h>
 
 namespace sdl {
 
 file_map_detail::view_of_file 
 file_map_detail::map_view_of_file(const char* filename,
                                   uint64 const offset,  
-                                  uint64 const size)
+                                  uint64 const size,
+                                  bool const populate)
 {
     A_STATIC_ASSERT_64_BIT; 
 
@@ -27,9 +31,17 @@ file_map_detail::map_view_of_file(const char* filename,
             SDL_ASSERT(false);
             return nullptr;
         }
+        int flags = MAP_PRIVATE;
+#if defined(MAP_POPULATE)
+        if (populate) {
+            flags |= MAP_POPULATE;
+        }
+#else
+        (void)populate;
+#endif
         auto pFileView = mmap64_t::call(
             nullptr, static_cast<size_t>(size), 
-            PROT_READ, MAP_PRIVATE, fileno(fp.get()), 0);
+            PROT_READ, flags, fileno(fp.get()), 0);
 
         if (pFileView == MAP_FAILED) {
             SDL_TRACE("mmap failed: ", filename);
@@ -59,6 +71,89 @@ bool file_map_detail::unmap_view_of_file(
     return false;
 }
 
+namespace {
+
+// address of range must be aligned to system page
+std::pair<char *, size_t> page_range(file_map_detail::view_of_file const p, uint64 const offset, uint64 const size) {
+    static const uint64 mask = static_cast<uint64>(::sysconf(_SC_PAGESIZE)) - 1;
+    uint64 const first = offset & ~mask;
+    return { static_cast<char *>(p) + first, static_cast<size_t>(offset + size - first) };
+}
+
+int madvise_flag(map_advice const advice) {
+    switch (advice) {
+    case map_advice::random:        return MADV_RANDOM;
+    case map_advice::sequential:    return MADV_SEQUENTIAL;
+    case map_advice::willneed:      return MADV_WILLNEED;
+    case map_advice::dontneed:
+    case map_advice::evict:         return MADV_DONTNEED;
+    default:
+        SDL_ASSERT(advice == map_advice::normal);
+        return MADV_NORMAL;
+    }
+}
+
+} // namespace
+
+bool file_map_detail::advise(
+    view_of_file const p,
+    uint64 const offset,
+    uint64 const size,
+    map_advice const advice)
+{
+    if (p && size) {
+        auto const range = page_range(p, offset, size);
+        if (0 == ::madvise(range.first, range.second, madvise_flag(advice))) {
+            return true;
+        }
+        SDL_ASSERT(!"madvise");
+    }
+    return false;
+}
+
+// MADV_DONTNEED unmaps pages of private mapping but keeps them in page cache;
+// POSIX_FADV_DONTNEED then drops clean pages of file that are not mapped by other processes
+bool file_map_detail::evict(
+    const char * const filename,
+    view_of_file const p,
+    uint64 const offset,
+    uint64 const size)
+{
+    if (!advise(p, offset, size, map_advice::dontneed)) {
+        return false;
+    }
+    FileHandler fp(filename, "rb");
+    if (!fp.is_open()) {
+        SDL_ASSERT(!"evict");
+        return false;
+    }
+    return 0 == ::posix_fadvise(fileno(fp.get()), static_cast<off_t>(offset), static_cast<off_t>(size), POSIX_FADV_DONTNEED);
+}
+
+bool file_map_detail::lock(
+    view_of_file const p,
+    uint64 const offset,
+    uint64 const size,
+    bool const lock)
+{
+    if (p && size) {
+        auto const range = page_range(p, offset, size);
+        return 0 == (lock ? ::mlock(range.first, range.second) : ::munlock(range.first, range.second));
+    }
+    return false;
+}
+
+page_faults file_map_detail::get_page_faults()
+{
+    page_faults result;
+    struct rusage usage {};
+    if (0 == ::getrusage(RUSAGE_SELF, &usage)) {
+        result.minor = static_cast<uint64>(usage.ru_minflt);
+        result.major = static_cast<uint64>(usage.ru_majflt);
+    }
+    return result;
+}
+
 } // sdl
 
 #if SDL_DEBUG
@@ -70,6 +165,7 @@ public:
     {
         SDL_TRACE_FILE;
         //SDL_TRACE("has_mmap64::value = ", has_mmap64::value);
+        SDL_ASSERT(file_map_detail::get_page_faults().minor); // process memory is faulted in
     }
 };
 static unit_test s_test;
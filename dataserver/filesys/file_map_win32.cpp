@@ -56,7 +56,8 @@ public:
 file_map_detail::view_of_file 
 file_map_detail::map_view_of_file(const char* filename,
                                   uint64 const offset,  
-                                  uint64 const size)
+                                  uint64 const size,
+                                  bool) // populate is not supported
 {
     A_STATIC_ASSERT_64_BIT;
 
@@ -133,6 +134,31 @@ bool file_map_detail::unmap_view_of_file(
     return false;
 }
 
+bool file_map_detail::advise(view_of_file, uint64, uint64, map_advice)
+{
+    return false; // PrefetchVirtualMemory needs Windows 8, pages are read on demand
+}
+
+bool file_map_detail::evict(const char *, view_of_file, uint64, uint64)
+{
+    return false; // file cache of mapped view is not dropped
+}
+
+bool file_map_detail::lock(view_of_file const p, uint64 const offset, uint64 const size, bool const lock)
+{
+    if (p && size) {
+        void * const address = static_cast<char *>(p) + offset;
+        return lock ? (::VirtualLock(address, static_cast<SIZE_T>(size)) != 0)
+                    : (::VirtualUnlock(address, static_cast<SIZE_T>(size)) != 0);
+    }
+    return false;
+}
+
+page_faults file_map_detail::get_page_faults()
+{
+    return {}; // GetProcessMemoryInfo needs psapi
+}
+
 } // sdl
 
 #if SDL_DEBUG
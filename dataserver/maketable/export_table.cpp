@@ -0,0 +1,533 @@
+// export_table.cpp
+//
+#include "dataserver/maketable/export_table.h"
+#include "dataserver/system/database.h"
+#include "dataserver/system/datapage.h"
+#include "dataserver/common/format.h"
+#include <fstream>
+#include <future>
+#include <map>
+#include <condition_variable>
+
+namespace sdl { namespace db { namespace make { namespace {
+
+using export_table_error = sdl_exception_t<export_table>;
+
+// columnar file layout (little-endian):
+// file header: magic "SDLCOL01", uint32 column_count,
+//   for each column: uint8 scalartype, uint32 fixed_size (0 if variable), uint32 name_length, name;
+// then blocks until end of file: uint32 row_count,
+//   for each column: null bitmap ((row_count + 7) / 8 bytes),
+//   fixed column: row_count * fixed_size raw bytes (zeros if NULL),
+//   variable column: uint32 offsets[row_count + 1] and raw bytes of values.
+const char columnar_magic[] = "SDLCOL01";
+
+template<class T>
+inline void append_pod(std::string & dest, T const & value) {
+    dest.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+inline bool is_number(scalartype::type const t) {
+    switch (t) {
+    case scalartype::t_int:
+    case scalartype::t_bigint:
+    case scalartype::t_smallint:
+    case scalartype::t_tinyint:
+    case scalartype::t_real:
+    case scalartype::t_float:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void append_csv(std::string & dest, std::string const & cell) {
+    if (cell.find_first_of(",\"\r\n") == std::string::npos) {
+        dest += cell;
+        return;
+    }
+    dest += '"';
+    for (const char c : cell) {
+        if (c == '"') {
+            dest += '"';
+        }
+        dest += c;
+    }
+    dest += '"';
+}
+
+void append_json(std::string & dest, std::string const & cell) {
+    dest += '"';
+    for (const char c : cell) {
+        switch (c) {
+        case '"':  dest += "\\\""; break;
+        case '\\': dest += "\\\\"; break;
+        case '\n': dest += "\\n"; break;
+        case '\r': dest += "\\r"; break;
+        case '\t': dest += "\\t"; break;
+        default:
+            if (static_cast<uint8>(c) < 0x20) {
+                char buf[32];
+                dest += format_s(buf, "\\u%04x", int(c));
+            }
+            else {
+                dest += c;
+            }
+            break;
+        }
+    }
+    dest += '"';
+}
+
+struct export_column {
+    size_t index;
+    usertable::column const * col;
+    bool number;
+    std::string json_key; // "name":
+};
+
+using export_columns = std::vector<export_column>;
+
+// formats records of one chunk, one formatter per worker thread
+class record_formatter : noncopyable {
+    using record_type = datatable::record_type;
+    export_table::format_type const m_format;
+    export_columns const & m_cols;
+    std::string m_cell; // reused
+    struct column_data {
+        std::string nulls;
+        std::string data;
+        std::vector<uint32> offsets;
+    };
+    std::vector<column_data> m_columns;
+    size_t m_rows = 0;
+public:
+    record_formatter(export_table::format_type const f, export_columns const & cols)
+        : m_format(f), m_cols(cols), m_columns(cols.size()) {}
+    void begin_chunk() {
+        m_rows = 0;
+        for (auto & c : m_columns) {
+            c.nulls.clear();
+            c.data.clear();
+            c.offsets.assign(1, 0);
+        }
+    }
+    void append(std::string & dest, record_type const & record) {
+        switch (m_format) {
+        case export_table::format_type::csv:    append_csv_row(dest, record); break;
+        case export_table::format_type::ndjson: append_json_row(dest, record); break;
+        default:                                append_columnar_row(record); break;
+        }
+        ++m_rows;
+    }
+    void end_chunk(std::string & dest);
+    static void append_header(std::string & dest, export_table::format_type, export_columns const &);
+private:
+    void append_csv_row(std::string & dest, record_type const &);
+    void append_json_row(std::string & dest, record_type const &);
+    void append_columnar_row(record_type const &);
+};
+
+void record_formatter::append_csv_row(std::string & dest, record_type const & record)
+{
+    for (size_t i = 0; i < m_cols.size(); ++i) {
+        export_column const & c = m_cols[i];
+        if (i) {
+            dest += ',';
+        }
+        if (record.is_null(c.index)) {
+            continue;
+        }
+        if (c.number) {
+            record.append_col(dest, c.index);
+        }
+        else {
+            m_cell.clear();
+            record.append_col_utf8(m_cell, c.index);
+            append_csv(dest, m_cell);
+        }
+    }
+    dest += '\n';
+}
+
+void record_formatter::append_json_row(std::string & dest, record_type const & record)
+{
+    dest += '{';
+    for (size_t i = 0; i < m_cols.size(); ++i) {
+        export_column const & c = m_cols[i];
+        if (i) {
+            dest += ',';
+        }
+        dest += c.json_key;
+        if (record.is_null(c.index)) {
+            dest += "null";
+        }
+        else if (c.number) {
+            record.append_col(dest, c.index);
+        }
+        else {
+            m_cell.clear();
+            record.append_col_utf8(m_cell, c.index);
+            append_json(dest, m_cell);
+        }
+    }
+    dest += "}\n";
+}
+
+void record_formatter::append_columnar_row(record_type const & record)
+{
+    const size_t bit = m_rows % 8;
+    for (size_t i = 0; i < m_cols.size(); ++i) {
+        export_column const & c = m_cols[i];
+        column_data & d = m_columns[i];
+        if (!bit) {
+            d.nulls += '\0';
+        }
+        const bool is_null = record.is_null(c.index);
+        if (is_null) {
+            d.nulls.back() = static_cast<char>(d.nulls.back() | (1 << bit));
+        }
+        if (c.col->is_fixed()) {
+            if (is_null) {
+                d.data.append(c.col->fixed_size(), '\0');
+            }
+            else {
+                for (auto const & m : record.data_col(c.index)) {
+                    d.data.append(m.first, m.second);
+                }
+            }
+        }
+        else {
+            if (!is_null) {
+                for (auto const & m : record.data_col(c.index)) {
+                    d.data.append(m.first, m.second);
+                }
+            }
+            d.offsets.push_back(static_cast<uint32>(d.data.size()));
+        }
+    }
+}
+
+void record_formatter::end_chunk(std::string & dest)
+{
+    if ((m_format != export_table::format_type::columnar) || !m_rows) {
+        return;
+    }
+    append_pod(dest, static_cast<uint32>(m_rows));
+    for (size_t i = 0; i < m_cols.size(); ++i) {
+        column_data const & d = m_columns[i];
+        dest += d.nulls;
+        if (!m_cols[i].col->is_fixed()) {
+            SDL_ASSERT(d.offsets.size() == m_rows + 1);
+            dest.append(reinterpret_cast<const char *>(d.offsets.data()), d.offsets.size() * sizeof(uint32));
+        }
+        dest += d.data;
+    }
+}
+
+void record_formatter::append_header(std::string & dest, export_table::format_type const f, export_columns const & cols)
+{
+    if (f == export_table::format_type::csv) {
+        for (size_t i = 0; i < cols.size(); ++i) {
+            if (i) {
+                dest += ',';
+            }
+            append_csv(dest, cols[i].col->name);
+        }
+        dest += '\n';
+    }
+    else if (f == export_table::format_type::columnar) {
+        dest.append(columnar_magic, sizeof(columnar_magic) - 1);
+        append_pod(dest, static_cast<uint32>(cols.size()));
+        for (auto const & c : cols) {
+            append_pod(dest, static_cast<uint8>(c.col->type));
+            append_pod(dest, static_cast<uint32>(c.col->is_fixed() ? c.col->fixed_size() : 0));
+            append_pod(dest, static_cast<uint32>(c.col->name.size()));
+            dest += c.col->name;
+        }
+    }
+}
+
+export_columns make_columns(datatable const & table, std::vector<std::string> const & names)
+{
+    usertable const & ut = table.ut();
+    std::vector<size_t> index;
+    if (names.empty()) {
+        for (size_t i = 0; i < ut.size(); ++i) {
+            index.push_back(i);
+        }
+    }
+    else {
+        index = ut.find(names); // column names are resolved once
+    }
+    export_columns result;
+    for (size_t const i : index) {
+        if (i >= ut.size()) {
+            throw_error<export_table_error>("column not found");
+        }
+        export_column c;
+        c.index = i;
+        c.col = &ut[i];
+        c.number = is_number(c.col->type);
+        append_json(c.json_key, c.col->name);
+        c.json_key += ':';
+        result.push_back(std::move(c));
+    }
+    return result;
+}
+
+// chunks formatted by workers and written in calling thread
+class chunk_queue : noncopyable {
+    using lock_type = std::unique_lock<std::mutex>;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::map<size_t, std::string> m_ready;
+    std::vector<std::string> m_free; // buffers for reuse
+    size_t const m_chunk_count;
+    size_t const m_max_pending;
+    bool const m_ordered;
+    size_t m_next_chunk = 0;
+    size_t m_written = 0;
+    size_t m_workers;
+    std::exception_ptr m_error;
+public:
+    chunk_queue(size_t chunk_count, size_t workers, bool ordered)
+        : m_chunk_count(chunk_count)
+        , m_max_pending(workers * 2)
+        , m_ordered(ordered)
+        , m_workers(workers)
+    {}
+    bool take(size_t & chunk, std::string & buf) { // called by worker
+        lock_type lock(m_mutex);
+        m_cv.wait(lock, [this]() {
+            return m_error || (m_next_chunk >= m_chunk_count) || (m_ordered ?
+                (m_next_chunk < m_written + m_max_pending) :
+                (m_ready.size() < m_max_pending));
+        });
+        if (m_error || (m_next_chunk >= m_chunk_count)) {
+            return false;
+        }
+        chunk = m_next_chunk++;
+        if (!m_free.empty()) {
+            buf.swap(m_free.back());
+            m_free.pop_back();
+        }
+        buf.clear();
+        return true;
+    }
+    void done(size_t const chunk, std::string && buf) {
+        lock_type lock(m_mutex);
+        m_ready.emplace(chunk, std::move(buf));
+        m_cv.notify_all();
+    }
+    void worker_exit(std::exception_ptr const & e) {
+        lock_type lock(m_mutex);
+        --m_workers;
+        if (e && !m_error) {
+            m_error = e;
+        }
+        m_cv.notify_all();
+    }
+    template<class fun_type>
+    void write(fun_type && fun) { // called by writer thread
+        std::string buf;
+        for (;;) {
+            {
+                lock_type lock(m_mutex);
+                m_cv.wait(lock, [this]() {
+                    return m_error || (!m_workers && m_ready.empty()) || (!m_ready.empty() &&
+                        (!m_ordered || (m_ready.begin()->first == m_written)));
+                });
+                if (m_error) {
+                    std::rethrow_exception(m_error);
+                }
+                if (m_ready.empty()) {
+                    SDL_ASSERT(m_written == m_chunk_count);
+                    return;
+                }
+                auto it = m_ready.begin();
+                buf.swap(it->second);
+                m_ready.erase(it);
+            }
+            fun(buf); // write without lock
+            {
+                lock_type lock(m_mutex);
+                ++m_written;
+                m_free.push_back(std::move(buf));
+                buf = std::string();
+                m_cv.notify_all();
+            }
+        }
+    }
+    void cancel(std::exception_ptr const & e) {
+        lock_type lock(m_mutex);
+        if (!m_error) {
+            m_error = e;
+        }
+        m_cv.notify_all();
+    }
+};
+
+} // namespace
+
+bool export_table::parse_format(format_type & result, std::string const & s)
+{
+    if (s == "csv") {
+        result = format_type::csv;
+    }
+    else if (s == "ndjson") {
+        result = format_type::ndjson;
+    }
+    else if (s == "columnar") {
+        result = format_type::columnar;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+export_table::result_type
+export_table::make_file(datatable const & table, param_type const & param)
+{
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    const export_columns cols = make_columns(table, param.columns);
+    database const & db = *table.db;
+    // data pages are loaded by workers, so pool blocks are locked by worker thread and released after chunk
+    const std::vector<pageFileID> pages = db.find_datapage_ids(table.get_id(),
+        dataType::type::IN_ROW_DATA, pageType::type::data);
+    std::ofstream out(param.out_file, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+    if (!out.is_open()) {
+        throw_error<export_table_error>("cannot open file");
+    }
+    result_type result;
+    auto write = [&out, &result](std::string const & buf) {
+        if (!buf.empty()) {
+            out.write(buf.data(), buf.size());
+            if (!out) {
+                throw_error<export_table_error>("cannot write file");
+            }
+            result.bytes += buf.size();
+        }
+    };
+    {
+        std::string header;
+        record_formatter::append_header(header, param.format, cols);
+        write(header);
+    }
+    const size_t chunk_pages = a_max(param.chunk_pages, size_t(1));
+    const size_t chunk_count = (pages.size() + chunk_pages - 1) / chunk_pages;
+    size_t thread_count = param.thread_count ? param.thread_count : std::thread::hardware_concurrency();
+    thread_count = a_max(a_min(thread_count, chunk_count), size_t(1));
+    chunk_queue queue(chunk_count, thread_count, param.page_order);
+    std::atomic<size_t> rows{ 0 };
+    auto worker = [&]() {
+        std::exception_ptr error;
+        try {
+            database::scoped_thread_lock lock(db); // pages locked by worker thread
+            record_formatter format(param.format, cols);
+            size_t chunk = 0;
+            std::string buf;
+            while (queue.take(chunk, buf)) {
+                format.begin_chunk();
+                const size_t first = chunk * chunk_pages;
+                const size_t last = a_min(first + chunk_pages, pages.size());
+                size_t count = 0;
+                for (size_t i = first; i < last; ++i) {
+                    page_head const * const head = db.load_page_head(pages[i]);
+                    if (!(head && (head->data.type == pageType::type::data))) { // heap extent may have other pages
+                        continue;
+                    }
+                    const datapage data(head);
+                    for (size_t slot = 0; slot < data.size(); ++slot) {
+                        row_head const * const row = data[slot];
+                        if (row->use_record()) {
+                            format.append(buf, table.make_record(row));
+                            ++count;
+                        }
+                    }
+                }
+                format.end_chunk(buf);
+                rows += count;
+                queue.done(chunk, std::move(buf));
+                buf = std::string();
+                db.unlock_thread(std::this_thread::get_id(), bpool::removef::false_); // release pool blocks of chunk
+            }
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+        queue.worker_exit(error);
+    };
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        tasks.push_back(std::async(std::launch::async, worker));
+    }
+    try {
+        queue.write(write);
+    }
+    catch (...) {
+        queue.cancel(std::current_exception()); // stop workers
+        for (auto & t : tasks) {
+            t.wait();
+        }
+        throw;
+    }
+    for (auto & t : tasks) {
+        t.get();
+    }
+    out.flush();
+    if (!out) {
+        throw_error<export_table_error>("cannot write file");
+    }
+    result.rows = rows;
+    result.milliseconds = static_cast<size_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        clock::now() - start).count());
+    return result;
+}
+
+} // make
+} // db
+} // sdl
+
+#if SDL_DEBUG
+namespace sdl { namespace db { namespace make { namespace {
+    class unit_test {
+    public:
+        unit_test() {
+            std::string s;
+            append_csv(s, "plain");
+            SDL_ASSERT(s == "plain");
+            s.clear();
+            append_csv(s, "a,\"b\"\n");
+            SDL_ASSERT(s == "\"a,\"\"b\"\"\n\"");
+            s.clear();
+            append_json(s, std::string("q\"\\\t\x01", 5));
+            SDL_ASSERT(s == "\"q\\\"\\\\\\t\\u0001\"");
+            export_table::format_type f = export_table::format_type::csv;
+            SDL_ASSERT(export_table::parse_format(f, "ndjson") && (f == export_table::format_type::ndjson));
+            SDL_ASSERT(!export_table::parse_format(f, "xml"));
+            {
+                chunk_queue queue(3, 2, true); // chunks done in reverse order are written in order
+                size_t chunk[3]{};
+                std::string buf;
+                for (size_t & c : chunk) {
+                    SDL_ASSERT(queue.take(c, buf));
+                }
+                SDL_ASSERT(!queue.take(chunk[0], buf));
+                for (size_t i = 3; i; --i) {
+                    queue.done(chunk[i - 1], std::to_string(chunk[i - 1]));
+                }
+                queue.worker_exit(nullptr);
+                queue.worker_exit(nullptr);
+                std::string result;
+                queue.write([&result](std::string const & b) { result += b; });
+                SDL_ASSERT(result == "012");
+            }
+        }
+    };
+    static unit_test s_test;
+}}}} // sdl
+#endif //#if SDL_DEBUG
@@ -0,0 +1,44 @@
+// export_table.h
+//
+#pragma once
+#ifndef __SDL_SYSTEM_EXPORT_TABLE_H__
+#define __SDL_SYSTEM_EXPORT_TABLE_H__
+
+#include "dataserver/system/datatable.h"
+
+namespace sdl { namespace db { namespace make {
+
+// exports rows of datatable into file;
+// pages are formatted by worker threads in chunks and written by calling thread
+class export_table : is_static {
+public:
+    enum class format_type {
+        csv,        // RFC 4180, UTF-8, header with column names
+        ndjson,     // one JSON object per line, UTF-8
+        columnar    // binary blocks of columns, see export_table.cpp
+    };
+    struct param_type {
+        std::string out_file;
+        format_type format = format_type::csv;
+        std::vector<std::string> columns;   // names of exported columns, all columns if empty
+        bool page_order = false;            // write rows in page order (cluster key order for clustered table)
+        size_t thread_count = 0;            // 0 = hardware concurrency
+        size_t chunk_pages = 64;            // pages formatted by worker in one buffer
+    };
+    struct result_type {
+        size_t rows = 0;
+        size_t bytes = 0;           // written to file
+        size_t milliseconds = 0;
+        double rows_per_sec() const {
+            return milliseconds ? (double(rows) * 1000 / milliseconds) : 0;
+        }
+    };
+    static result_type make_file(datatable const &, param_type const &); // throws on error
+    static bool parse_format(format_type &, std::string const &); // csv, ndjson, columnar
+};
+
+} // make
+} // db
+} // sdl
+
+#endif // __SDL_SYSTEM_EXPORT_TABLE_H__
@@ -72,6 +72,12 @@ public:
     public:
         record(this_table const * p, row_head const * h) noexcept : base(p, h) {}
         record() = default;%s{REC_TEMPLATE}
+        class view final : public base_view<this_table> { // row header parsed once
+            using base = base_view<this_table>;
+        public:
+            explicit view(record const & r) : base(r) {}%s{VIEW_TEMPLATE}
+        };
+        view decode() const { return view(*this); }
     };%s{static_record_count}
 private:
     record::access const _record;
@@ -104,6 +110,9 @@ const char REC_TEMPLATE[] = R"(
         decltype(auto) %s{col_name}() const { return val<col::%s{col_name}>(); })";
 #endif
 
+const char VIEW_TEMPLATE[] = R"(
+            decltype(auto) %s{col_name}() const { return val<col::%s{col_name}>(); })";
+
 const char INDEX_TEMPLATE[] = R"(
         struct %s{index_name} : meta::idxstat<%s{schobj_id}, %s{index_id}, idxtype::%s{idxtype}> { static constexpr const char * name() { return "%s{index_name}"; } };)";
 
@@ -346,6 +355,7 @@ std::string generator::make_table(database const & db, datatable const & table,
         std::string s_columns;
         std::string s_type_list;
         std::string s_record;
+        std::string s_view;
         const auto PK = db.get_primary_key(tab.get_id());
         for (size_t i = 0; i < tab.size(); ++i) {
             usertable::column_ref t = tab[i];
@@ -374,6 +384,7 @@ std::string generator::make_table(database const & db, datatable const & table,
             replace(s_col, "%s{KEY_TEMPLATE}", s_key);
             s_columns += s_col;
             s_record += replace_(REC_TEMPLATE, "%s{col_name}", t.name);
+            s_view += replace_(VIEW_TEMPLATE, "%s{col_name}", t.name);
             if (i) s_type_list += ",";
             std::string s_type(TYPE_LIST);
             s_type_list += replace(replace(s_type, "%s{col_name}", t.name), "%d", i);
@@ -381,6 +392,7 @@ std::string generator::make_table(database const & db, datatable const & table,
         replace(s, "%s{COL_TEMPLATE}", s_columns);
         replace(s, "%s{TYPE_LIST}", s_type_list);
         replace(s, "%s{REC_TEMPLATE}", s_record);
+        replace(s, "%s{VIEW_TEMPLATE}", s_view);
     }
     {
         std::string s_index_template;
@@ -73,6 +73,14 @@ public:
         record() = default;
         decltype(auto) Id() const { return val<col::Id>(); }
         decltype(auto) Col1() const { return val<col::Col1>(); }
+        class view final : public base_view<this_table> {
+            using base = base_view<this_table>;
+        public:
+            explicit view(record const & r) : base(r) {}
+            decltype(auto) Id() const { return val<col::Id>(); }
+            decltype(auto) Col1() const { return val<col::Col1>(); }
+        };
+        view decode() const { return view(*this); }
     };
     static constexpr size_t static_record_count = 0;
 public:
@@ -105,6 +113,8 @@ void test_sample_table(sample::dbo_table * const table) {
     using T = sample::dbo_table;
     static_assert(T::col_size == 3, "");
     static_assert(T::col_fixed, "");
+    static_assert(T::null_size == 3, "");
+    static_assert(T::var_size == 0, "");
     static_assert(sizeof(T::record) == sizeof(void *), "");
     using clustered = T::clustered;
     using query_type = T::query_type;
@@ -121,6 +131,9 @@ void test_sample_table(sample::dbo_table * const table) {
         T & tab = *table;
         for (auto p : tab) {
             if (p.Id()) {}
+            const auto v = p.decode();
+            SDL_ASSERT(v.Id() == p.Id());
+            SDL_ASSERT(v.is_null<T::col::Col1>() == p.is_null<T::col::Col1>());
         }
         tab->scan_if([](T::record p){
             return true;
@@ -133,6 +146,17 @@ void test_sample_table(sample::dbo_table * const table) {
         })) {
             SDL_ASSERT(found.Id() > 0);
         }
+        size_t batch_rows = 0;
+        tab->scan_batch<T::col::Id, T::col::Id2>([&batch_rows](column_batch<T::col::Id, T::col::Id2> const & batch) {
+            SDL_ASSERT(batch.values<T::col::Id>().size() == batch.size());
+            SDL_ASSERT(batch.get<1>().size() == batch.size());
+            for (size_t i = 0; i < batch.size(); ++i) {
+                SDL_ASSERT(T::record(nullptr, batch.head(i)).Id() == batch.values<T::col::Id>()[i]);
+            }
+            batch_rows += batch.size();
+            return true;
+        }, 2);
+        SDL_ASSERT(batch_rows == tab->record_count());
         std::vector<T::record> range;
         tab->scan_if([&range](T::record p){
             if (p.Id() > 0) {
@@ -165,6 +189,103 @@ void test_sample_table(sample::dbo_table * const table) {
                 ;
             //FIXME: failed build on Ubuntu ?
             //auto r1 = (tab->SELECT | BETWEEN<T::col::Id>{1,2} && ORDER_BY<T::col::Id>{}).VALUES();
+            auto r2 = (tab->SELECT | BETWEEN<T::col::Id>{1,2}).VALUES();
+            auto r3 = (tab->SELECT | LESS_EQ<T::col::Id>{5} | TOP{10}).VALUES();
+            auto r4 = (tab->SELECT | LESS<T::col::Id>{5} | GREATER_EQ<T::col::Id>{1}).VALUES();
+            for (auto const & p : r2) {
+                SDL_ASSERT((p.Id() >= 1) && (p.Id() <= 2));
+            }
+            SDL_ASSERT(r3.size() <= 10);
+            for (auto const & p : r4) {
+                SDL_ASSERT((p.Id() >= 1) && (p.Id() < 5));
+            }
+        }
+        if (1) {
+            using namespace where_;
+            auto g1 = (tab->SELECT | ALL{}).GROUP_BY<T::col::Id, T::col::Col1>(
+                COUNT<>{}, COUNT<T::col::Id2>{}, SUM<T::col::Id2>{}, MIN<T::col::Id2>{}, MAX<T::col::Id>{}, AVG<T::col::Id2>{});
+            for (auto const & g : g1) {
+                static_assert(std::is_same<int32 const &, decltype(g.key.get<0>())>::value, "");
+                static_assert(std::is_same<size_t const &, decltype(g.get<0>())>::value, "");
+                SDL_ASSERT(g.key.is_null<1>() || g.get<0>());
+                if (auto const & sum = g.get<2>()) {
+                    A_STATIC_CHECK_TYPE(int64, sum.value);
+                }
+            }
+            auto g2 = (tab->SELECT | WHERE<T::col::Id>{1}).GROUP_BY<T::col::Id2>(COUNT<>{});
+            auto d1 = (tab->SELECT | LESS<T::col::Id2>{1} | IF([](T::record p){ return p.Id() > 0; })).DISTINCT<T::col::Id2>();
+            auto a1 = (tab->SELECT | IN<T::col::Id>{1,2,3}).AGGREGATE(COUNT<>{}, MAX<T::col::Id2>{});
+            auto a2 = (tab->SELECT | GREATER<T::col::Id2>{1}).AGGREGATE(AVG<T::col::Id>{});
+            SDL_ASSERT(g2.size() <= std::get<0>(a1));
+            SDL_ASSERT(d1.size() <= tab->record_count());
+            SDL_ASSERT(!std::get<0>(a2) || (std::get<0>(a2).value > 0));
+            SDL_ASSERT((tab->SELECT | ALL{}).COUNT() == tab->record_count());
+            SDL_ASSERT((tab->SELECT | IN<T::col::Id>{1,1,2}).COUNT() == (tab->SELECT | IN<T::col::Id>{1,2}).VALUES().size());
+            SDL_ASSERT((tab->SELECT | WHERE<T::col::Id>{1} | WHERE<T::col::Id>{1}).COUNT() == 
+                       (tab->SELECT | WHERE<T::col::Id>{1}).COUNT());
+            SDL_ASSERT((tab->SELECT | IF_CONCURRENT([](T::record){ return true; })).COUNT() == tab->record_count());
+            auto s1 = (tab->SELECT | GREATER<T::col::Id>{1}).SELECT_AS<T::col::Id2, T::col::Id>();
+            static_assert(sizeof(s1[0]) == sizeof(uint32) + sizeof(int64) + sizeof(int32), "");
+            for (auto const & p : s1) {
+                SDL_ASSERT(p.is_null<1>() || (p.get<1>() > 1));
+            }
+            auto s2 = (tab->SELECT | IN<T::col::Id>{1,1,2} | WHERE<T::col::Id>{2}).SELECT_AS<T::col::Id>();
+            SDL_ASSERT(s2.size() == (tab->SELECT | IN<T::col::Id>{1,2}).VALUES().size());
+        }
+        if (1) {
+            using namespace where_;
+            static_assert(query_type::is_cluster_T0<T::col::Id>::value, "");
+            static_assert(!query_type::is_cluster_T0<T::col::Id2>::value, "");
+            auto j1 = (tab->SELECT | ALL{}).INNER_JOIN<T::col::Id, T::col::Id>(tab->SELECT | LESS<T::col::Id2>{10});
+            auto j2 = (tab->SELECT | ALL{}).INNER_JOIN<T::col::Id, T::col::Id, INDEX::IGNORE>(tab->SELECT | LESS<T::col::Id2>{10});
+            auto j3 = (tab->SELECT | WHERE<T::col::Id>{1}).INNER_JOIN<T::col::Id2, T::col::Id2>(tab->SELECT | ALL{}, megabyte<1>::value);
+            SDL_ASSERT(j1.size() == j2.size());
+            for (auto const & p : j3) {
+                SDL_ASSERT(p.first.val(identity<T::col::Id2>()) == p.second.val(identity<T::col::Id2>()));
+            }
+            size_t count = 0;
+            (tab->SELECT | ALL{}).for_join<T::col::Id, T::col::Id, INDEX::USE>(tab->SELECT | ALL{},
+                [&count](T::record, T::record) {
+                return ++count < 10; // break
+            });
+            SDL_ASSERT(count <= 10);
+            const auto bench = join_benchmark<T::col::Id, T::col::Id>(tab, tab);
+            SDL_ASSERT(bench.index_rows == bench.hash_rows);
+            const auto view = view_benchmark(tab);
+            SDL_ASSERT(view.rows == tab->record_count());
+        }
+        if (1) {
+            using namespace where_;
+            auto p1 = (tab->SELECT | WHERE<T::col::Id>{1} | IF([](T::record){ return true; })).EXPLAIN();
+            auto p2 = (tab->SELECT | LESS<T::col::Id2>{1} | TOP{10} && ORDER_BY<T::col::Id>{}).EXPLAIN();
+            SDL_ASSERT(p1.path == access_path::SEEK_TABLE);
+            SDL_ASSERT(p1.seek.size() == 1);
+            SDL_ASSERT(p1.conditions.size() == 2);
+            SDL_ASSERT(p2.path == access_path::SCAN_TABLE);
+            SDL_ASSERT(p2.seek.empty() && (p2.top == 10) && p2.order);
+            auto p3 = (tab->SELECT | BETWEEN<T::col::Id2>{1, 100} | IF([](T::record){ return true; })).EXPLAIN();
+            SDL_ASSERT((p3.path == access_path::SCAN_TABLE) || (p3.path == access_path::SEEK_SECONDARY));
+            SDL_ASSERT((p3.path == access_path::SCAN_TABLE) == p3.seek.empty());
+            auto r3 = (tab->SELECT | BETWEEN<T::col::Id2>{1, 100}).VALUES(); // non-clustered index seek if exists
+            auto r4 = (tab->SELECT | IF([](T::record p){
+                const int64 v = p.val(identity<T::col::Id2>());
+                return !p.is_null<T::col::Id2>() && (v >= 1) && (v <= 100);
+            })).VALUES();
+            SDL_ASSERT(r3.size() == r4.size());
+            auto scan_Id2 = [&tab](auto const & fun) { // rows with NULL Id2 are read as 0
+                return (tab->SELECT | IF([&fun](T::record p){
+                    return fun(p.val(identity<T::col::Id2>()));
+                })).VALUES().size();
+            };
+            SDL_ASSERT((tab->SELECT | WHERE<T::col::Id2>{0}).VALUES().size() == scan_Id2([](int64 v){ return v == 0; }));
+            SDL_ASSERT((tab->SELECT | LESS<T::col::Id2>{5}).VALUES().size() == scan_Id2([](int64 v){ return v < 5; }));
+            SDL_ASSERT((tab->SELECT | GREATER_EQ<T::col::Id2>{-1}).VALUES().size() == scan_Id2([](int64 v){ return v >= -1; }));
+            SDL_ASSERT((tab->SELECT | GREATER<T::col::Id2>{1} | TOP{3}).VALUES().size() == a_min(size_t(3), scan_Id2([](int64 v){ return v > 1; })));
+            query_stats stats;
+            auto r1 = (tab->SELECT | BETWEEN<T::col::Id>{1, 10}).ANALYZE(stats);
+            SDL_ASSERT(stats.rows_returned == r1.size());
+            SDL_ASSERT(stats.rows_examined >= stats.rows_returned);
+            SDL_TRACE(to_string(stats));
         }
     }
     if (1) {
@@ -183,6 +304,244 @@ void test_sample_table(sample::dbo_table * const table) {
         }
     }
 }
+struct test_group_record { // fake record for group_:: test
+    int32 id;
+    int64 id2;
+    bool null2;
+    template<class T> bool is_null(identity<T>) const {
+        return std::is_same<T, dbo_META::col::Id2>::value && null2;
+    }
+    int32 val(identity<dbo_META::col::Id>) const { return id; }
+    int64 val(identity<dbo_META::col::Id2>) const { return id2; }
+};
+void test_group_table() {
+    using col = dbo_META::col;
+    using key_type = group_::group_key<col::Id, col::Id2>;
+    using table_type = group_::group_table<key_type, where_::COUNT<>, where_::COUNT<col::Id2>, 
+        where_::SUM<col::Id2>, where_::MIN<col::Id2>, where_::MAX<col::Id2>, where_::AVG<col::Id2>>;
+    static_assert(sizeof(key_type) == sizeof(uint32) + sizeof(int32) + sizeof(int64), "");
+    A_STATIC_ASSERT_IS_POD(key_type);
+    table_type t1, t2;
+    for (int i = 0; i < 100; ++i) {
+        t1.apply(test_group_record{ i % 3, i % 2, false });
+        t2.apply(test_group_record{ i % 3, i % 2, (i % 10) == 0 });
+    }
+    SDL_ASSERT(t1.size() == 6);
+    SDL_ASSERT(t2.size() == 9); // NULL is separate group
+    t1.merge(t2);
+    const auto r = t1.result();
+    SDL_ASSERT(r.size() == 9);
+    size_t count = 0;
+    for (auto const & g : r) {
+        count += g.get<0>();
+        if (g.key.is_null<1>()) {
+            SDL_ASSERT(!g.get<1>());
+            SDL_ASSERT(!g.get<2>() && !g.get<3>() && !g.get<4>() && !g.get<5>());
+        }
+        else {
+            SDL_ASSERT(g.get<2>().value == static_cast<int64>(g.get<1>()) * g.key.get<1>());
+            SDL_ASSERT(g.get<3>().value == g.key.get<1>());
+            SDL_ASSERT(g.get<4>().value == g.key.get<1>());
+            SDL_ASSERT(fequal(g.get<5>().value, static_cast<double>(g.key.get<1>())));
+        }
+    }
+    SDL_ASSERT(count == 200);
+    SDL_ASSERT(r[0].key.get<0>() == 0);
+    SDL_ASSERT(r[0].key.get<1>() == 0);
+    using select_type = group_::select_table<group_::select_row<col::Id2>>;
+    select_type s1, s2;
+    for (int i = 0; i < 10; ++i) {
+        (i < 5 ? s1 : s2).apply(test_group_record{ i, i * 10, i == 7 });
+    }
+    s1.merge(s2);
+    const auto rows = s1.result();
+    SDL_ASSERT(rows.size() == 10);
+    for (int i = 0; i < 10; ++i) {
+        SDL_ASSERT(rows[i].is_null<0>() == (i == 7));
+        SDL_ASSERT(rows[i].is_null<0>() || (rows[i].get<0>() == i * 10));
+    }
+    using real_col = meta::col<0, 0, scalartype::t_float, 8>;
+    struct real_record {
+        double value;
+        bool is_null(identity<real_col>) const { return false; }
+        double val(identity<real_col>) const { return value; }
+    };
+    using real_key = group_::group_key<real_col>;
+    const real_key pos = real_key::read(real_record{ 0.0 });
+    const real_key neg = real_key::read(real_record{ -0.0 });
+    SDL_ASSERT(pos == neg);
+    SDL_ASSERT(real_key::hash()(pos) == real_key::hash()(neg));
+    SDL_ASSERT(real_key::read(real_record{ 1.5 }).get<0>() == 1.5);
+}
+void test_column_batch() {
+    using T = sample::dbo_table;
+    static_assert(column_batch<T::col::Id>::is_column_of<T::type_list>(), "");
+    static_assert(!column_batch<T::col::Id, meta::col<0, 0, scalartype::t_int, 4>>::is_column_of<T::type_list>(), "");
+    enum { fixedlen = sizeof(row_head) + 4 + 8 + 255 };
+    char row[fixedlen + 3] = {};
+    row[0] = 0x10; // has_null
+    row[2] = char(fixedlen & 0xFF);
+    row[3] = char(fixedlen >> 8);
+    row[fixedlen] = 3; // columns
+    int32 const id = 5;
+    int64 const id2 = -7;
+    memcpy(row + sizeof(row_head), &id, sizeof(id));
+    memcpy(row + sizeof(row_head) + 4, &id2, sizeof(id2));
+    row_head const * const head = reinterpret_cast<row_head const *>(row);
+    column_batch<T::col::Id, T::col::Id2> batch;
+    for (size_t i = 0; i < 70; ++i) {
+        row[fixedlen + 2] = (i % 3) ? 0 : 0x02; // Id2 is NULL
+        batch.push_back(row_view_t<T::null_size, 0>(head));
+    }
+    SDL_ASSERT(batch.size() == 70);
+    SDL_ASSERT(batch.nulls<T::col::Id2>().size() == 2);
+    for (size_t i = 0; i < batch.size(); ++i) {
+        SDL_ASSERT(batch.head(i) == head);
+        SDL_ASSERT(!batch.is_null<T::col::Id>(i));
+        SDL_ASSERT(batch.values<T::col::Id>()[i] == id);
+        SDL_ASSERT(batch.is_null<T::col::Id2>(i) == !(i % 3));
+        SDL_ASSERT(batch.get<1>()[i] == ((i % 3) ? id2 : 0));
+    }
+    batch.clear();
+    SDL_ASSERT(batch.empty() && batch.nulls<T::col::Id>().empty());
+}
+struct test_expr_query { // sub_expr of SELECT without database
+    using record = sample::dbo_table::record;
+    using record_range = std::vector<record>;
+    template<class sub_expr_type> void EXPLAIN(sub_expr_type const &) const; // not called
+};
+void test_snapshot_select() { // rows of SNAPSHOT_SELECT are rows of RECORD_SELECT (SCAN_TABLE without snapshot)
+    using T = sample::dbo_table;
+    enum { fixedlen = sizeof(row_head) + 4 + 8 + 255 };
+    enum { row_count = 300 };
+    std::vector<std::string> rows(row_count, std::string(fixedlen + 3, '\0'));
+    column_snapshot_builder builder;
+    builder.add_column(T::col::Id::name(), scalartype::t_int, column_snapshot::column_kind::fixed, sizeof(int32));
+    builder.add_column(T::col::Id2::name(), scalartype::t_bigint, column_snapshot::column_kind::fixed, sizeof(int64));
+    builder.add_column(T::col::Col1::name(), scalartype::t_char, column_snapshot::column_kind::none, 0);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        char * const row = &rows[i][0];
+        const bool null2 = !(i % 11);
+        const int32 id = static_cast<int32>(i % 50) - 10;
+        const int64 id2 = null2 ? 0 : static_cast<int64>((i * 7) % 100) - 20;
+        row[0] = 0x10; // has_null
+        row[2] = char(fixedlen & 0xFF);
+        row[3] = char(fixedlen >> 8);
+        row[fixedlen] = 3; // columns
+        row[fixedlen + 2] = null2 ? 0x02 : 0; // Id2 is NULL
+        memcpy(row + sizeof(row_head), &id, sizeof(id));
+        memcpy(row + sizeof(row_head) + 4, &id2, sizeof(id2));
+        builder.push_value(0, { mem_range_t(row + sizeof(row_head), row + sizeof(row_head) + 4) });
+        if (null2) {
+            builder.push_null(1);
+        }
+        else {
+            builder.push_value(1, { mem_range_t(row + sizeof(row_head) + 4, row + sizeof(row_head) + 12) });
+        }
+        builder.push_null(2);
+        pageFileID page{};
+        page.pageId = static_cast<uint32>(i / 10);
+        builder.push_row(page, i % 10);
+    }
+    std::ostringstream ss;
+    builder.write(ss, _schobj_id(T::id), 0);
+    const std::string buf = ss.str();
+    const column_snapshot snapshot(buf.data(), buf.size());
+    SDL_ASSERT(snapshot.size() == rows.size());
+    const test_expr_query query{};
+    const select_::select_expr<test_expr_query> SELECT(&query);
+    auto check = [&rows, &snapshot](auto const & expr) {
+        using expr_type = std::decay_t<decltype(expr)>;
+        using SEARCH = typename make_query_::SELECT_SEARCH_TYPE<expr_type>::Result;
+        using search_AND = make_query_::search_operator_t<where_::operator_::AND, SEARCH>;
+        using search_OR = make_query_::search_operator_t<where_::operator_::OR, SEARCH>;
+        column_snapshot::selection sel;
+        SDL_ASSERT(make_query_::SNAPSHOT_SELECT<expr_type>::select(sel, snapshot, expr));
+        size_t count = 0;
+        for (size_t i = 0; i < rows.size(); ++i) {
+            const T::record p(nullptr, reinterpret_cast<row_head const *>(rows[i].data()));
+            const bool selected =
+                make_query_::SELECT_OR<search_OR, true>::select(p, expr) &&
+                make_query_::SELECT_AND<search_AND, true>::select(p, expr);
+            SDL_ASSERT(selected == !!((sel[i / 64] >> (i % 64)) & 1));
+            count += selected;
+        }
+        SDL_ASSERT(count == column_snapshot::count(sel));
+        return count;
+    };
+    using namespace where_;
+    SDL_ASSERT(check(SELECT | WHERE<T::col::Id>{3}) == rows.size() / 50);
+    SDL_ASSERT(check(SELECT | WHERE<T::col::Id2>{0}) > 0); // NULL is compared as 0
+    check(SELECT | IN<T::col::Id>{1, 5, 7} | LESS<T::col::Id2>{0});
+    check(SELECT | BETWEEN<T::col::Id2>{-5, 30} && NOT<T::col::Id>{0, 1});
+    check(SELECT | GREATER_EQ<T::col::Id2>{-1} | LESS_EQ<T::col::Id>{-5});
+    check(SELECT | GREATER<T::col::Id>{20} && IS_NULL<T::col::Id2>{});
+    check(SELECT | LESS<T::col::Id>{30} && NOT_NULL<T::col::Id2>{} && GREATER<T::col::Id2>{10});
+}
+void test_secondary_select() { // index scan skips NULL keys which records read as 0
+    using T = sample::dbo_table;
+    const test_expr_query query{};
+    const select_::select_expr<test_expr_query> SELECT(&query);
+    auto use_index = [](auto const & expr) {
+        using expr_type = std::decay_t<decltype(expr)>;
+        using SEARCH = typename make_query_::SELECT_SEARCH_TYPE<expr_type>::Result;
+        return make_query_::SECONDARY_CONDITION<typename SEARCH::Head>::use_index(expr);
+    };
+    using namespace where_;
+    SDL_ASSERT(!use_index(SELECT | WHERE<T::col::Id2>{0}));
+    SDL_ASSERT(!use_index(SELECT | LESS<T::col::Id2>{5}));
+    SDL_ASSERT(!use_index(SELECT | GREATER_EQ<T::col::Id2>{-1}));
+    SDL_ASSERT(!use_index(SELECT | BETWEEN<T::col::Id2>{-1, 1}));
+    SDL_ASSERT(!use_index(SELECT | IN<T::col::Id2>{3, 0}));
+    SDL_ASSERT(use_index(SELECT | WHERE<T::col::Id2>{1}));
+    SDL_ASSERT(use_index(SELECT | LESS<T::col::Id2>{0}));
+    SDL_ASSERT(use_index(SELECT | GREATER<T::col::Id2>{0}));
+    SDL_ASSERT(use_index(SELECT | BETWEEN<T::col::Id2>{1, 100}));
+    SDL_ASSERT(use_index(SELECT | IN<T::col::Id2>{3, 3, -1}));
+    SDL_ASSERT(!use_index(SELECT | NOT<T::col::Id2>{1}));
+    SDL_ASSERT(!use_index(SELECT | WHERE<T::col::Id2, INDEX::IGNORE>{1}));
+}
+void test_scan_range_head() { // range of scan_range ends on page after first min_partition_pages pages
+    using query = sample::dbo_table::query_type;
+    enum { page_count = query::min_partition_pages + 2 };
+    enum { row_count = 4 };
+    using page_buf = std::array<uint64, page_head::page_size / sizeof(uint64)>;
+    std::vector<page_buf> buf(page_count, page_buf{});
+    std::vector<page_head const *> pages;
+    for (size_t i = 0; i < buf.size(); ++i) {
+        page_head * const head = reinterpret_cast<page_head *>(buf[i].data());
+        head->data.type = pageType::init(pageType::type::data);
+        head->data.pageId = pageFileID::init(static_cast<uint32>(i + 1));
+        head->data.slotCnt = row_count;
+        uint16 * const slot = reinterpret_cast<uint16 *>(buf[i].data() + buf[i].size());
+        for (size_t j = 0; j < row_count; ++j) {
+            *(slot - j - 1) = static_cast<uint16>(page_head::head_size + j * 16);
+        }
+        pages.push_back(head);
+    }
+    auto load_next = [&pages](page_head const * const p) -> page_head const * {
+        size_t const i = p->data.pageId.pageId;
+        return (i < pages.size()) ? pages[i] : nullptr;
+    };
+    auto scan = [&pages, &load_next](size_t const last_page, size_t const last_slot, size_t & rows) {
+        rows = 0;
+        const page_slot last = (last_page < pages.size()) ? page_slot(pages[last_page], last_slot) : page_slot();
+        return query::scan_range_head(page_slot(pages[0], 1), last, load_next, [&rows](row_head const *) {
+            ++rows;
+            return true;
+        });
+    };
+    size_t rows = 0;
+    size_t const last_page = query::min_partition_pages; // page min_partition_pages + 1
+    SDL_ASSERT(!scan(last_page, 3, rows));
+    SDL_ASSERT(rows == last_page * row_count - 1 + 3);
+    SDL_ASSERT(!scan(last_page, 0, rows));
+    SDL_ASSERT(rows == last_page * row_count - 1);
+    SDL_ASSERT(scan(last_page + 1, 2, rows) == pages[last_page]); // rest of range is partitioned
+    SDL_ASSERT(rows == last_page * row_count - 1);
+    SDL_ASSERT(scan(pages.size(), 0, rows) == pages[last_page]);
+    SDL_ASSERT(!scan(2, 2, rows) && (rows == 2 * row_count - 1 + 2));
+}
 class unit_test {
 public:
     unit_test() {
@@ -214,6 +573,11 @@ public:
         >::Type type_list;
         test_processor<type_list>::test();
         test_sample_table(nullptr);
+        test_group_table();
+        test_column_batch();
+        test_snapshot_select();
+        test_secondary_select();
+        test_scan_range_head();
         if (0) {
             SDL_TRACE(typeid(sample::dbo_META::col::Id).name());
             SDL_TRACE(typeid(sample::dbo_META::col::Col1).name());
@@ -221,6 +585,9 @@ public:
         if (0) {
             make::index_tree<dbo_META::clustered::key_type> test(nullptr, nullptr);
         }
+        if (0) {
+            table_benchmark<TL::Seq<dbo_table>::Type>::print(nullptr, dbo_table::name(), true, true, std::cout);
+        }
         if (0) {
             using namespace where_;
             using T1 = operator_list<operator_::OR>;
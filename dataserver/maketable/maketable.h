@@ -5,10 +5,14 @@
 #define __SDL_SYSTEM_MAKETABLE_H__
 
 #include "dataserver/maketable/maketable_base.h"
-#include "dataserver/maketable/maketable_where.h"
+#include "dataserver/maketable/maketable_explain.h"
+#include "dataserver/maketable/maketable_batch.h"
 #include "dataserver/system/index_tree_t.h"
 #include "dataserver/spatial/interval_set.h"
+#include "dataserver/spatial/geo_cache.h"
 #include "dataserver/common/algorithm.h"
+#include "dataserver/common/thread.h"
+#include "dataserver/common/time_util.h"
 
 namespace sdl { namespace db { namespace make {
 
@@ -61,9 +65,14 @@ public:
     using spatial_tree_T0 = typename clustered_traits::spatial_tree_T0;
     using spatial_page_row = typename clustered_traits::spatial_page_row;
     using pk0_type = T0_type;
+    template<class col> // col is first column of cluster key
+    using is_cluster_T0 = bool_constant<(index_size != 0) && std::is_same<col, T0_col>::value>;
 private:
+    using geo_cache_type = geo_cache<pk0_type>;
     this_table const & m_table;
     shared_cluster_index const m_cluster_index;
+    mutable std::once_flag m_geo_once;
+    mutable std::unique_ptr<geo_cache_type> m_geo_cache; // see database_cfg::geo_cache
     using page_slot_bool = std::pair<page_slot, bool>;
 public:
     make_query(this_table const * p, database const * const d)
@@ -82,6 +91,73 @@ public:
             }
         }
     }
+    using page_ids = std::vector<pageFileID>;
+    page_ids data_page_ids() const; // IN_ROW_DATA page ids in scan order (pages are not loaded)
+
+    // fun(state_type &, record const &) is called by worker threads only if concurrent is true
+    template<class state_type, class fun_type>
+    std::vector<state_type> scan_partition(bool concurrent, fun_type && fun) const;
+
+    shared_column_snapshot snapshot() const { // columnar snapshot attached to database, can be nullptr
+        return m_table.get_db()->get_column_snapshot(_schobj_id(this_table::id));
+    }
+    template<class fun_type> // fun(record) returns bool, records of selected rows in scan order
+    void scan_selection(column_snapshot const &, column_snapshot::selection const &, fun_type &&) const;
+
+    template<class state_type, class fun_type> // fun(state_type &, record const &)
+    std::vector<state_type> scan_partition(column_snapshot const &, column_snapshot::selection const &, bool concurrent, fun_type &&) const;
+
+    // rows of every batch_pages data pages are decoded into column_batch<Ts...> and fun(batch) is called,
+    // fun returns bool or break_or_continue; batch memory is reused between calls
+    template<typename... Ts, class fun_type> // Ts = col::
+    void scan_batch(fun_type &&, size_t batch_pages = 1) const;
+    template<typename... Ts> // Ts = col::
+    void decode_page(page_head const *, column_batch<Ts...> &) const; // appends rows of data page
+
+    template<class col> // non-clustered index with first key column col, can be nullptr
+    shared_secondary_index find_secondary_index() const {
+        return m_table.get_db()->find_secondary_index(_schobj_id(this_table::id), col::name());
+    }
+    using bookmark_type = Select_t<index_size != 0, KEY_TYPE, recordID>; // cluster key or RID of heap row
+    using bookmark_range = std::vector<bookmark_type>;
+
+    // appends bookmarks of index rows, see secondary_index::scan_range; stops if range has limit bookmarks (0 = no limit)
+    template<class before_type, class after_type>
+    void seek_secondary(secondary_index const &, bookmark_range &, before_type &&, after_type &&, size_t limit = 0) const;
+
+    // bookmarks are sorted and made unique, rows are loaded in this order (sequential for rows of the same page);
+    // pages of next prefetch_bookmarks rows are prefetched before rows are loaded (see database::prefetch_pages)
+    template<class fun_type> // fun(record) returns bool
+    void fetch_bookmarks(bookmark_range &, fun_type &&) const;
+    enum { prefetch_bookmarks = 256 };
+    enum { min_partition_pages = 64 };
+private:
+    enum { min_partition_rows = min_partition_pages * 64 };
+    static size_t partition_count(size_t page_count);
+    template<class fun_type> // fun(size_t partition)
+    void run_partition(size_t count, fun_type &&) const;
+    template<class fun_type>
+    void scan_page(page_head const *, fun_type &&) const;
+    record snapshot_record(column_snapshot::row_locator const &, page_head const * & page) const;
+    bookmark_type read_bookmark(secondary_index const &, row_head const *, std::true_type) const;
+    bookmark_type read_bookmark(secondary_index const &, row_head const *, std::false_type) const;
+    template<class fun_type> void fetch_bookmarks(bookmark_range const &, fun_type &&, std::true_type) const;
+    template<class fun_type> void fetch_bookmarks(bookmark_range const &, fun_type &&, std::false_type) const;
+    page_head const * load_key_page(pageFileID const &, pageType_t<pageType::type::index>) const;
+    page_head const * load_key_page(pageFileID const &, pageType_t<pageType::type::data>) const;
+    pageFileID find_key_page_id(key_type const &, pageType_t<pageType::type::index>) const;
+    pageFileID find_key_page_id(key_type const &, pageType_t<pageType::type::data>) const {
+        return {}; // root data page is loaded
+    }
+    pageFileID bookmark_page(bookmark_type const & key, std::true_type) const {
+        return find_key_page_id(key, pageType_t<table_clustered::root_page_type>());
+    }
+    pageFileID bookmark_page(bookmark_type const & id, std::false_type) const {
+        return id.id;
+    }
+    // pages[i - first] is page of bookmark range[i]; it is found once and reused to load row
+    void prefetch_range(bookmark_range const &, size_t first, std::vector<pageFileID> & pages) const;
+public:
     template<class fun_type>
     record find(fun_type && fun) const {
         for (record const & p : m_table) { // linear search
@@ -108,11 +184,38 @@ public:
     template<class fun_type> page_slot scan_next(page_slot const &, fun_type &&) const;
     template<class fun_type> page_slot scan_prev(page_slot const &, fun_type &&) const;
 
+    page_slot first_slot() const; // first record in key order
+    page_slot upper_bound(T0_type const &) const; // first record with T0 key greater than value
+
+    // records from first to last (not included) in key order, last = {} is end of table;
+    // fun is called in calling thread; if range is not finished after first min_partition_pages pages,
+    // leaf pages of the rest are split between worker threads which read them ahead of the scan
+    template<class fun_type> // fun(record) returns break_or_continue
+    break_or_continue scan_range(page_slot const & first, page_slot const & last, fun_type &&) const;
+    // rows of first min_partition_pages pages of range (and of last page of range if it is next) are passed to fun(row_head);
+    // returns first page of the rest of range, nullptr if range is finished or fun returns false
+    template<class load_next_type, class fun_type>
+    static page_head const * scan_range_head(page_slot const & first, page_slot const & last, load_next_type &&, fun_type &&);
+private:
+    enum { read_ahead_pages = 8 }; // pages read by worker between checks of cancel
+    page_ids range_pages(page_slot const &, page_slot const &, pageType_t<pageType::type::index>) const;
+    page_ids range_pages(page_slot const &, page_slot const &, pageType_t<pageType::type::data>) const {
+        return {}; // single leaf page
+    }
+    template<class fun_type>
+    static bool scan_range_page(page_head const *, page_slot const &, page_slot const &, fun_type &&);
+public:
+
     unique_spatial_tree_t<T0_type> get_spatial_tree() const {
         A_STATIC_ASSERT_NOT_TYPE(NullType, T0_type);
         return m_table.get_table().get_spatial_tree(identity<T0_type>());
     }
+    // fun(geo_mem const &) returns bool; geography of record found by spatial seek is decoded once
+    // and kept by pk0 if database_cfg::geo_cache is set
+    template<class col, class fun_type>
+    bool geography_if(record const &, pk0_type const &, fun_type &&) const;
 private:
+    geo_cache_type * get_geo_cache() const; // nullptr if cache is not used
     size_t record_count(identity<void>) const { 
         return m_table.get_table()._record.count(); // can be slow
     }
@@ -243,6 +346,27 @@ public:
 
     template<class sub_expr_type, class fun_type>
     void for_record(sub_expr_type const &, fun_type &&) const;
+
+    template<class sub_expr_type>
+    query_plan EXPLAIN(sub_expr_type const &) const;
+
+    template<class sub_expr_type>
+    record_range ANALYZE(sub_expr_type const &, query_stats &) const;
+
+    template<class sub_expr_type, class key_type, class... aggs>
+    group_::group_range<key_type, aggs...> GROUP_BY(sub_expr_type const &) const;
+
+    template<class sub_expr_type, class key_type>
+    std::vector<key_type> DISTINCT(sub_expr_type const &) const;
+
+    template<class sub_expr_type, class... aggs>
+    group_::aggregate_result<aggs...> AGGREGATE(sub_expr_type const &) const;
+
+    template<class sub_expr_type, class key_type>
+    std::vector<key_type> SELECT_AS(sub_expr_type const &) const;
+
+    template<class sub_expr_type, class col, class right_col, where_::INDEX hint, class right_expr, class fun_type>
+    void for_join(sub_expr_type const &, right_expr const &, size_t memory_budget, fun_type &&) const;
 public:
     const select_expr SELECT { this };
 };
@@ -253,5 +377,7 @@ public:
 
 #include "dataserver/maketable/maketable_scan.hpp"
 #include "dataserver/maketable/maketable_select.hpp"
+#include "dataserver/maketable/maketable_group.hpp"
+#include "dataserver/maketable/maketable_join.hpp"
 
 #endif // __SDL_SYSTEM_MAKETABLE_H__
@@ -95,6 +95,9 @@ class make_base_table: public _make_base_table {
 public:
     enum { col_size = TL::Length<TYPE_LIST>::value };
     enum { col_fixed = meta::IsFixed<TYPE_LIST>::value };
+    enum { null_size = meta::NullSize<TYPE_LIST>::value };
+    enum { var_size = meta::VarSize<TYPE_LIST>::value };
+    using row_view = row_view_t<null_size, var_size>;
 protected:
     make_base_table(database const * p, shared_usertable const & s): _make_base_table(p, s) {}
     ~make_base_table() = default;
@@ -124,6 +127,9 @@ private:
         static_assert(T::fixed, "");
         return fixed_val<T>(p, meta::is_fixed<T::fixed>());
     }
+protected:
+    template<class this_table>
+    class base_view;
 private:
     class null_record {
     protected:
@@ -193,6 +199,10 @@ private:
 
     template<class this_table>
     class base_record_t<this_table, true> : public null_record {
+        friend base_view<this_table>;
+        this_table const * view_table() const {
+            return nullptr;
+        }
     protected:
         base_record_t(this_table const *, row_head const * h) noexcept
             : null_record(h) {
@@ -209,6 +219,10 @@ private:
     template<class this_table>
     class base_record_t<this_table, false> : public null_record {
         this_table const * table = nullptr;
+        friend base_view<this_table>;
+        this_table const * view_table() const {
+            return this->table;
+        }
     protected:
         base_record_t(this_table const * p, row_head const * h) noexcept
             : null_record(h), table(p) {
@@ -320,6 +334,70 @@ protected:
             return this->type_col_wide(identity<T>());
         }
     }; // base_record
+protected:
+    // columns of record read from row_view, row header is parsed once for all columns
+    template<class this_table>
+    class base_view {
+        this_table const * table; // nullptr if col_fixed
+        row_view m_row;
+    protected:
+        template<class record_type>
+        explicit base_view(record_type const & r)
+            : table(r.view_table()), m_row(r.head()) {
+            SDL_ASSERT(col_fixed || table);
+        }
+        ~base_view() = default;
+    private:
+        template<class T> // T = col::
+        ret_type<T> get_value(identity<T>, meta::is_fixed<1>) const {
+            if (m_row.is_null(T::place)) {
+                return get_empty<T>();
+            }
+            return fixed_val<T>(m_row.head(), meta::is_fixed<1>());
+        }
+        template<class T> // T = col::
+        ret_type<T> get_value(identity<T>, meta::is_fixed<0>) const {
+            if (m_row.is_null(T::place)) {
+                return get_empty<T>();
+            }
+            if ((T::offset < m_row.var_count()) && !m_row.is_complex(T::offset)) { // in-row-data
+                const mem_range_t m = m_row.var_data(T::offset);
+                if (mem_size(m)) {
+                    return vector_mem_range_t{ m };
+                }
+                return vector_mem_range_t();
+            }
+            return table->get_db()->template var_data_t<T::type>(m_row.head(), T::offset);
+        }
+    public:
+        using table_type = this_table;
+        row_head const * head() const {
+            return m_row.head();
+        }
+        template<class T> // T = col::
+        bool is_null(identity<T>) const {
+            static_assert(col_index<T>::value != -1, "column must belong to table");
+            return m_row.is_null(T::place);
+        }
+        template<class T> // T = col::
+        bool is_null() const {
+            return is_null(identity<T>());
+        }
+        template<class T> // T = col::
+        ret_type<T> val(identity<T>) const {
+            static_assert(col_index<T>::value != -1, "column must belong to table");
+            return get_value(identity<T>(), meta::is_fixed<T::fixed>());
+        }
+        template<class T> // T = col::
+        ret_type<T> val() const {
+            return val(identity<T>());
+        }
+        template<size_t i>
+        col_ret_type<i> get() const {
+            static_assert(i < col_size, "");
+            return val(identity<col_t<i>>());
+        }
+    }; // base_view
 }; // make_base_table
 
 template<class META>
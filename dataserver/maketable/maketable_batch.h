@@ -0,0 +1,107 @@
+// maketable_batch.h
+//
+#pragma once
+#ifndef __SDL_SYSTEM_MAKETABLE_BATCH_H__
+#define __SDL_SYSTEM_MAKETABLE_BATCH_H__
+
+#include "dataserver/maketable/maketable_meta.h"
+#include <tuple>
+
+namespace sdl { namespace db { namespace make {
+
+// values of one column of batch, NULL values are stored as zero (like record value of NULL column)
+template<class T> // T = col::
+struct batch_column {
+    static_assert(T::fixed && !T::is_array, "batch_column: fixed scalar column expected");
+    using value_type = typename T::val_type;
+    std::vector<value_type> values;
+    std::vector<uint64> nulls; // bit per row
+    void clear() { // capacity is reused
+        values.clear();
+        nulls.clear();
+    }
+    template<class row_view>
+    void push_back(row_view const & row) {
+        const size_t i = values.size();
+        if (!(i & 63)) {
+            nulls.push_back(0);
+        }
+        if (row.is_null(T::place)) {
+            nulls.back() |= uint64(1) << (i & 63);
+            values.push_back(value_type{});
+        }
+        else {
+            values.push_back(row.head()->template fixed_val_t<value_type, T::offset>());
+        }
+    }
+};
+
+// rows of data pages decoded into column vectors (structure of arrays), see make_query::scan_batch
+template<typename... Ts> // Ts = col::
+class column_batch : noncopyable {
+    using col_list = TL::Seq_t<Ts...>;
+    static_assert(sizeof...(Ts) != 0, "column_batch");
+    static_assert(TL::IsDistinct<col_list>::value, "column duplicate");
+    template<class T>
+    using col_index = TL::IndexOf<col_list, T>;
+    template<size_t i>
+    using col_t = typename TL::TypeAt<col_list, i>::Result;
+    using swallow = int[];
+public:
+    enum { col_size = sizeof...(Ts) };
+    template<class TList> // TList = type_list of table
+    static constexpr bool is_column_of() {
+        const bool found[] = { (TL::IndexOf<TList, Ts>::value != -1)... };
+        for (bool const b : found) {
+            if (!b) return false;
+        }
+        return true;
+    }
+    column_batch() = default;
+    size_t size() const {
+        return m_rows.size();
+    }
+    bool empty() const {
+        return m_rows.empty();
+    }
+    void clear() {
+        m_rows.clear();
+        (void)swallow{ 0, (std::get<batch_column<Ts>>(m_data).clear(), 0)... };
+    }
+    row_head const * head(size_t const row) const { // to read other columns of record
+        return m_rows[row];
+    }
+    template<class T> // T = col::
+    std::vector<typename T::val_type> const & values() const {
+        static_assert(col_index<T>::value != -1, "column must belong to batch");
+        return std::get<batch_column<T>>(m_data).values;
+    }
+    template<class T> // T = col::
+    std::vector<uint64> const & nulls() const {
+        static_assert(col_index<T>::value != -1, "column must belong to batch");
+        return std::get<batch_column<T>>(m_data).nulls;
+    }
+    template<class T> // T = col::
+    bool is_null(size_t const row) const {
+        SDL_ASSERT(row < size());
+        return (nulls<T>()[row >> 6] >> (row & 63)) & 1;
+    }
+    template<size_t i>
+    std::vector<typename col_t<i>::val_type> const & get() const {
+        return values<col_t<i>>();
+    }
+    template<class row_view> // row_view_t of table
+    void push_back(row_view const & row) {
+        m_rows.push_back(row.head());
+        (void)swallow{ 0, (std::get<batch_column<Ts>>(m_data).push_back(row), 0)... };
+    }
+private:
+    std::vector<row_head const *> m_rows;
+    std::tuple<batch_column<Ts>...> m_data;
+};
+
+} // make
+} // db
+} // sdl
+
+#endif // __SDL_SYSTEM_MAKETABLE_BATCH_H__
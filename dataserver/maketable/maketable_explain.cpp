@@ -0,0 +1,88 @@
+// maketable_explain.cpp
+//
+#include "dataserver/maketable/maketable_explain.h"
+#include <sstream>
+
+namespace sdl { namespace db { namespace make {
+
+const char * access_path_name(access_path const p)
+{
+    switch (p) {
+    case access_path::SCAN_TABLE:   return "SCAN_TABLE";
+    case access_path::SEEK_TABLE:   return "SEEK_TABLE";
+    case access_path::SEEK_SPATIAL: return "SEEK_SPATIAL";
+    case access_path::SEEK_SECONDARY: return "SEEK_SECONDARY";
+    default:
+        SDL_ASSERT(0);
+        return "";
+    }
+}
+
+namespace {
+    void print_list(std::ostream & ss, const char * const title, std::vector<std::string> const & list) {
+        if (!list.empty()) {
+            ss << "\n" << title << ":";
+            for (auto const & s : list) {
+                ss << " " << s;
+            }
+        }
+    }
+}
+
+std::string to_string(query_plan const & plan)
+{
+    std::stringstream ss;
+    ss << access_path_name(plan.path);
+    if (plan.top) {
+        ss << " TOP " << plan.top;
+    }
+    if (plan.order) {
+        ss << " SORT";
+    }
+    print_list(ss, "seek", plan.seek);
+    print_list(ss, "conditions", plan.conditions);
+    return ss.str();
+}
+
+std::string to_string(query_stats const & stats)
+{
+    std::stringstream ss;
+    ss << to_string(stats.plan)
+        << "\nrows_examined = " << stats.rows_examined
+        << "\nrows_returned = " << stats.rows_returned
+        << "\npages = " << stats.pages
+        << "\npool_misses = " << stats.pool_misses
+        << "\nselect_time = " << stats.select_time << " us"
+        << "\nsort_time = " << stats.sort_time << " us";
+    return ss.str();
+}
+
+} // make
+} // db
+} // sdl
+
+#if SDL_DEBUG
+namespace sdl { namespace db { namespace make { namespace {
+    class unit_test {
+    public:
+        unit_test() {
+            query_stats stats;
+            stats.plan.path = access_path::SEEK_TABLE;
+            stats.plan.top = 10;
+            stats.plan.seek.push_back("WHERE<Id> INDEX::AUTO");
+            stats.rows_examined = 20;
+            const std::string s = to_string(stats);
+            SDL_ASSERT(s.find("SEEK_TABLE TOP 10\nseek: WHERE<Id> INDEX::AUTO") == 0);
+            SDL_ASSERT(s.find("rows_examined = 20") != std::string::npos);
+            SDL_ASSERT(to_string(query_plan()) == "SCAN_TABLE");
+            {
+                explain_::operator_timer test(nullptr);
+                SDL_ASSERT(!test.examined());
+                test.select_done();
+                test.sort_done();
+            }
+        }
+    };
+    static unit_test s_test;
+}}}} // sdl
+#endif //#if SDL_DEBUG
@@ -0,0 +1,110 @@
+// maketable_explain.h
+//
+#pragma once
+#ifndef __SDL_SYSTEM_MAKETABLE_EXPLAIN_H__
+#define __SDL_SYSTEM_MAKETABLE_EXPLAIN_H__
+
+#include "dataserver/maketable/maketable_where.h"
+#include "dataserver/common/time_util.h"
+
+namespace sdl { namespace db { namespace make {
+
+enum class access_path {
+    SCAN_TABLE,     // full table scan
+    SEEK_TABLE,     // cluster index seek
+    SEEK_SPATIAL,   // spatial index seek
+    SEEK_SECONDARY  // non-clustered index seek
+};
+
+const char * access_path_name(access_path);
+
+struct query_plan { // EXPLAIN
+    access_path path = access_path::SCAN_TABLE;
+    size_t top = 0;                         // TOP value, 0 if not used
+    bool order = false;                     // result is sorted after select
+    std::vector<std::string> seek;          // conditions used for index seek
+    std::vector<std::string> conditions;    // all conditions with index hints
+};
+
+struct query_stats { // ANALYZE
+    query_plan plan;
+    size_t rows_examined = 0;   // rows read by scan or seek
+    size_t rows_returned = 0;
+    size_t pages = 0;           // pages loaded by query (index and data)
+    size_t pool_misses = 0;     // blocks read from file by buffer pool during query (all threads)
+    long_long select_time = 0;  // microseconds
+    long_long sort_time = 0;    // microseconds, ORDER BY and TOP
+};
+
+std::string to_string(query_plan const &);
+std::string to_string(query_stats const &);
+
+namespace explain_ {
+
+struct condition_name {
+    std::vector<std::string> & result;
+    explicit condition_name(std::vector<std::string> & r) : result(r) {}
+
+    template<where_::condition _c, class T, where_::INDEX _h> // T = col::
+    bool operator()(identity<where_::SEARCH<_c, T, T::is_array, _h>>) {
+        result.push_back(std::string(where_::condition_name<_c>()) + "<" + T::name() + "> INDEX::" + where_::index_name<_h>());
+        return true;
+    }
+    template<class T, sortorder ord> // T = col::
+    bool operator()(identity<where_::ORDER_BY<T, ord>>) {
+        result.push_back(std::string("ORDER_BY<") + T::name() + "> " + to_string::type_name(ord));
+        return true;
+    }
+    template<class T>
+    bool operator()(identity<T>) {
+        result.push_back(where_::condition_name<T::cond>());
+        return true;
+    }
+};
+
+struct search_where_name { // T = make_query_::SEARCH_WHERE
+    condition_name fun;
+    explicit search_where_name(std::vector<std::string> & r) : fun(r) {}
+    template<class T>
+    bool operator()(identity<T>) {
+        return fun(identity<typename T::type>());
+    }
+};
+
+// per-operator timing for ANALYZE (monotonic clock), clock is not read if stats is nullptr
+class operator_timer : noncopyable {
+    query_stats * const m_stats;
+    long_long m_start = 0;
+    static long_long now() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+public:
+    explicit operator_timer(query_stats * const p) : m_stats(p) {
+        if (m_stats) {
+            m_start = now();
+        }
+    }
+    size_t * examined() const {
+        return m_stats ? &(m_stats->rows_examined) : nullptr;
+    }
+    void select_done() {
+        if (m_stats) {
+            const long_long t = now();
+            m_stats->select_time = t - m_start;
+            m_start = t;
+        }
+    }
+    void sort_done() {
+        if (m_stats) {
+            m_stats->sort_time = now() - m_start;
+        }
+    }
+};
+
+} // explain_
+} // make
+} // db
+} // sdl
+
+#endif // __SDL_SYSTEM_MAKETABLE_EXPLAIN_H__
@@ -0,0 +1,401 @@
+// maketable_group.h
+//
+#pragma once
+#ifndef __SDL_SYSTEM_MAKETABLE_GROUP_H__
+#define __SDL_SYSTEM_MAKETABLE_GROUP_H__
+
+#include "dataserver/maketable/maketable_meta.h"
+#include "dataserver/common/open_hash_map.h"
+#include "dataserver/common/optional.h"
+#include <tuple>
+
+namespace sdl { namespace db { namespace make {
+namespace where_ {
+
+enum class aggregate {
+    COUNT,
+    SUM,
+    MIN,
+    MAX,
+    AVG
+};
+
+// aggregate functions ignore NULL values like SQL does;
+// SUM/MIN/MAX/AVG over no values returns empty optional (= NULL)
+
+template<class T = void> // T = col:: or void for COUNT(*)
+struct COUNT {
+    static constexpr aggregate agg = aggregate::COUNT;
+    using col = T;
+    using state_type = size_t;
+    using result_type = size_t;
+    template<class record>
+    static void apply(state_type & s, record const & p) {
+        if (!p.is_null(identity<col>())) {
+            ++s;
+        }
+    }
+    static void merge(state_type & s, state_type const & src) {
+        s += src;
+    }
+    static result_type result(state_type const & s) {
+        return s;
+    }
+};
+
+template<>
+struct COUNT<void> {
+    static constexpr aggregate agg = aggregate::COUNT;
+    using col = void;
+    using state_type = size_t;
+    using result_type = size_t;
+    template<class record>
+    static void apply(state_type & s, record const &) {
+        ++s;
+    }
+    static void merge(state_type & s, state_type const & src) {
+        s += src;
+    }
+    static result_type result(state_type const & s) {
+        return s;
+    }
+};
+
+namespace aggregate_ {
+
+template<class T>
+using sum_type = Select_t<std::is_floating_point<T>::value, double,
+                 Select_t<std::is_signed<T>::value, int64, uint64>>;
+
+template<class T> // T = col::
+struct check_arithmetic {
+    static_assert(T::fixed && !T::is_array, "aggregate need fixed column");
+    static_assert(std::is_arithmetic<typename T::val_type>::value, "aggregate need arithmetic column");
+    using type = T;
+};
+
+template<class T> // T = col::
+struct check_compare {
+    static_assert(T::fixed && !T::is_array, "MIN/MAX need fixed column");
+    using type = T;
+};
+
+template<class T, bool is_min> // T = col::
+struct min_max {
+    using col = typename check_compare<T>::type;
+    using val_type = typename col::val_type;
+    using state_type = optional<val_type>;
+    using result_type = state_type;
+    static bool replace(val_type const & x, val_type const & value) {
+        return is_min ? (x < value) : (value < x);
+    }
+    template<class record>
+    static void apply(state_type & s, record const & p) {
+        if (!p.is_null(identity<col>())) {
+            val_type const x = p.val(identity<col>());
+            if (!s || replace(x, s.value)) {
+                s = x;
+            }
+        }
+    }
+    static void merge(state_type & s, state_type const & src) {
+        if (src && (!s || replace(src.value, s.value))) {
+            s = src.value;
+        }
+    }
+    static result_type result(state_type const & s) {
+        return s;
+    }
+};
+
+} // aggregate_
+
+template<class T> // T = col::
+struct SUM {
+    static constexpr aggregate agg = aggregate::SUM;
+    using col = typename aggregate_::check_arithmetic<T>::type;
+    using value_type = aggregate_::sum_type<typename col::val_type>;
+    using state_type = optional<value_type>;
+    using result_type = state_type;
+    template<class record>
+    static void apply(state_type & s, record const & p) {
+        if (!p.is_null(identity<col>())) {
+            s.value += static_cast<value_type>(p.val(identity<col>()));
+            s.initialized = true;
+        }
+    }
+    static void merge(state_type & s, state_type const & src) {
+        if (src) {
+            s.value += src.value;
+            s.initialized = true;
+        }
+    }
+    static result_type result(state_type const & s) {
+        return s;
+    }
+};
+
+template<class T> // T = col::
+struct MIN : aggregate_::min_max<T, true> {
+    static constexpr aggregate agg = aggregate::MIN;
+};
+
+template<class T> // T = col::
+struct MAX : aggregate_::min_max<T, false> {
+    static constexpr aggregate agg = aggregate::MAX;
+};
+
+template<class T> // T = col::
+struct AVG {
+    static constexpr aggregate agg = aggregate::AVG;
+    using col = typename aggregate_::check_arithmetic<T>::type;
+    struct state_type {
+        double sum;
+        size_t count;
+    };
+    using result_type = optional<double>;
+    template<class record>
+    static void apply(state_type & s, record const & p) {
+        if (!p.is_null(identity<col>())) {
+            s.sum += static_cast<double>(p.val(identity<col>()));
+            ++s.count;
+        }
+    }
+    static void merge(state_type & s, state_type const & src) {
+        s.sum += src.sum;
+        s.count += src.count;
+    }
+    static result_type result(state_type const & s) {
+        if (s.count) {
+            return s.sum / s.count;
+        }
+        return {};
+    }
+};
+
+} // where_
+
+namespace group_ {
+
+template<class... cols> struct key_size;
+
+template<> struct key_size<> {
+    enum { value = 0 };
+};
+
+template<class T, class... Ts>
+struct key_size<T, Ts...> {
+    static_assert(T::fixed, "group_key need fixed column");
+    enum { value = sizeof(typename T::val_type) + key_size<Ts...>::value };
+};
+
+template<size_t i, class... cols> struct key_offset;
+
+template<class T, class... Ts>
+struct key_offset<0, T, Ts...> {
+    enum { value = 0 };
+};
+
+template<size_t i, class T, class... Ts>
+struct key_offset<i, T, Ts...> {
+    enum { value = sizeof(typename T::val_type) + key_offset<i - 1, Ts...>::value };
+};
+
+// packed copy of fixed column values, compared and hashed as raw memory;
+// NULL columns are zero filled and marked in null_mask, -0.0 is stored as +0.0
+#pragma pack(push, 1)
+template<class... cols> // cols = col::
+struct group_key {
+    using col_list = TL::Seq_t<cols...>;
+    enum { col_size = sizeof...(cols) };
+    enum { data_size = key_size<cols...>::value };
+    static_assert((col_size > 0) && (col_size <= 32), "group_key");
+    static_assert(TL::IsDistinct<col_list>::value, "column duplicate");
+
+    template<size_t i> using col_t = typename TL::TypeAt<col_list, i>::Result;
+    template<size_t i> using val_t = typename col_t<i>::val_type;
+
+    uint32 null_mask;
+    char data[data_size];
+
+    template<size_t i>
+    bool is_null() const {
+        static_assert(i < col_size, "");
+        return (null_mask >> i) & 1;
+    }
+    template<size_t i>
+    val_t<i> const & get() const {
+        static_assert(i < col_size, "");
+        return *reinterpret_cast<val_t<i> const *>(data + key_offset<i, cols...>::value);
+    }
+    template<size_t i>
+    val_t<i> & set() {
+        static_assert(i < col_size, "");
+        return *reinterpret_cast<val_t<i> *>(data + key_offset<i, cols...>::value);
+    }
+    template<class record>
+    static group_key read(record const & p) {
+        group_key dest{}; // zero filled
+        read_cols<0>(dest, p, TL::Seq<cols...>());
+        return dest;
+    }
+    bool operator == (group_key const & y) const {
+        return memcmp_pod(*this, y) == 0;
+    }
+    bool operator != (group_key const & y) const {
+        return !((*this) == y);
+    }
+    struct hash {
+        size_t operator()(group_key const & k) const {
+            return static_cast<size_t>(hash_detail::hash_bytes(&k, sizeof(k)));
+        }
+    };
+private:
+    template<size_t i, class record>
+    static void read_cols(group_key &, record const &, TL::Seq<>) {}
+
+    template<size_t i, class record, class T, class... Ts>
+    static void read_cols(group_key & dest, record const & p, TL::Seq<T, Ts...>) {
+        if (p.is_null(identity<T>())) {
+            dest.null_mask |= (uint32(1) << i);
+        }
+        else {
+            meta::copy(dest.template set<i>(), p.val(identity<T>()));
+            normalize(dest.template set<i>());
+        }
+        read_cols<i + 1>(dest, p, TL::Seq<Ts...>());
+    }
+    template<class V> static void normalize(V &) {}
+    static void normalize(double & v) { // -0.0 == +0.0 must be same group
+        if (v == 0) v = 0;
+    }
+    static void normalize(float & v) {
+        if (v == 0) v = 0;
+    }
+};
+#pragma pack(pop)
+
+// SELECT AS: only listed columns are copied from row, other columns are not decoded
+template<class... cols> // cols = col::
+using select_row = group_key<cols...>;
+
+template<class key_type>
+class select_table {
+    std::vector<key_type> m_rows;
+public:
+    select_table() = default;
+    select_table(select_table &&) = default;
+    select_table & operator=(select_table &&) = default;
+    size_t size() const {
+        return m_rows.size();
+    }
+    template<class record>
+    void apply(record const & p) {
+        m_rows.push_back(key_type::read(p));
+    }
+    void merge(select_table const & src) { // keeps scan order
+        m_rows.insert(m_rows.end(), src.m_rows.begin(), src.m_rows.end());
+    }
+    std::vector<key_type> result() {
+        return std::move(m_rows);
+    }
+};
+
+template<class... aggs> // aggs = where_::COUNT | SUM | MIN | MAX | AVG
+struct aggregate_state {
+    using state_type = std::tuple<typename aggs::state_type...>;
+    using result_type = std::tuple<typename aggs::result_type...>;
+    state_type value{};
+
+    template<class record>
+    void apply(record const & p) {
+        apply(p, std::index_sequence_for<aggs...>());
+    }
+    void merge(aggregate_state const & src) {
+        merge(src, std::index_sequence_for<aggs...>());
+    }
+    result_type result() const {
+        return result(std::index_sequence_for<aggs...>());
+    }
+private:
+    using swallow = int[];
+    template<class record, size_t... i>
+    void apply(record const & p, std::index_sequence<i...>) {
+        (void)p;
+        (void)swallow{ 0, (aggs::apply(std::get<i>(value), p), 0)... };
+    }
+    template<size_t... i>
+    void merge(aggregate_state const & src, std::index_sequence<i...>) {
+        (void)src;
+        (void)swallow{ 0, (aggs::merge(std::get<i>(value), std::get<i>(src.value)), 0)... };
+    }
+    template<size_t... i>
+    result_type result(std::index_sequence<i...>) const {
+        return result_type(aggs::result(std::get<i>(value))...);
+    }
+};
+
+template<class key_type, class... aggs>
+struct group_row {
+    using result_type = std::tuple<typename aggs::result_type...>;
+    key_type key;
+    result_type value;
+    template<size_t i>
+    auto get() const -> decltype(std::get<i>(value)) {
+        return std::get<i>(value);
+    }
+};
+
+template<class key_type, class... aggs>
+using group_range = std::vector<group_row<key_type, aggs...>>;
+
+template<class... aggs>
+using aggregate_result = std::tuple<typename aggs::result_type...>;
+
+// hash aggregation, one table per scan partition;
+// groups are kept in order of first appearance, merge preserves it
+template<class key_type, class... aggs>
+class group_table {
+    using state_type = aggregate_state<aggs...>;
+    using map_type = open_hash_map<key_type, state_type, typename key_type::hash>;
+    map_type m_map;
+public:
+    group_table() = default;
+    group_table(group_table &&) = default;
+    group_table & operator=(group_table &&) = default;
+    size_t size() const {
+        return m_map.size();
+    }
+    template<class record>
+    void apply(record const & p) {
+        m_map[key_type::read(p)].apply(p);
+    }
+    void merge(group_table const & src) {
+        for (auto const & it : src.m_map) {
+            m_map[it.first].merge(it.second);
+        }
+    }
+    group_range<key_type, aggs...> result() const {
+        group_range<key_type, aggs...> range;
+        range.reserve(m_map.size());
+        for (auto const & it : m_map) {
+            range.push_back({ it.first, it.second.result() });
+        }
+        return range;
+    }
+    std::vector<key_type> keys() const {
+        std::vector<key_type> range;
+        range.reserve(m_map.size());
+        for (auto const & it : m_map) {
+            range.push_back(it.first);
+        }
+        return range;
+    }
+};
+
+} // group_
+} // make
+} // db
+} // sdl
+
+#endif // __SDL_SYSTEM_MAKETABLE_GROUP_H__
@@ -0,0 +1,329 @@
+// maketable_group.hpp
+//
+#pragma once
+#ifndef __SDL_SYSTEM_MAKETABLE_GROUP_HPP__
+#define __SDL_SYSTEM_MAKETABLE_GROUP_HPP__
+
+namespace sdl { namespace db { namespace make {
+
+template<class this_table, class record>
+typename make_query<this_table, record>::page_ids
+make_query<this_table, record>::data_page_ids() const
+{
+    return m_table.get_db()->find_datapage_ids(_schobj_id(this_table::id),
+        dataType::type::IN_ROW_DATA, pageType::type::data);
+}
+
+template<class this_table, class record>
+size_t make_query<this_table, record>::partition_count(size_t const page_count)
+{
+    const size_t hardware = std::thread::hardware_concurrency();
+    return a_max(a_min(hardware, page_count / min_partition_pages), size_t(1));
+}
+
+template<class this_table, class record>
+template<class fun_type> inline
+void make_query<this_table, record>::scan_page(page_head const * const page, fun_type && fun) const
+{
+    const datapage data(page);
+    for (size_t slot = 0; slot < data.size(); ++slot) {
+        row_head const * const row = data[slot];
+        if (row->use_record()) {
+            fun(record(&m_table, row));
+        }
+    }
+}
+
+// First partition is processed in calling thread, others in worker threads.
+template<class this_table, class record>
+template<class fun_type>
+void make_query<this_table, record>::run_partition(size_t const count, fun_type && scan_range) const
+{
+    if (count > 1) {
+        database const & db = *m_table.get_db();
+        database::scoped_page_count * const page_count = database::scoped_page_count::current();
+        std::vector<std::future<void>> tasks;
+        tasks.reserve(count - 1);
+        for (size_t i = 1; i < count; ++i) {
+            tasks.push_back(std::async(std::launch::async, [&db, &scan_range, page_count, i]() {
+                database::scoped_thread_lock lock(db); // pages locked by worker thread
+                database::scoped_page_count pages_read(page_count); // ANALYZE
+                scan_range(i);
+            }));
+        }
+        scan_range(0);
+        for (auto & t : tasks) {
+            t.get(); // rethrow worker exception
+        }
+    }
+    else {
+        scan_range(0);
+    }
+}
+
+// Splits data page ids into contiguous ranges, one state per range (in page order).
+// Pages of range are loaded by the thread that scans it; worker threads unlock pages after each read_ahead_pages.
+// If concurrent, fun must be thread-safe (where_::IF_CONCURRENT lambdas are called by worker threads).
+template<class this_table, class record>
+template<class state_type, class fun_type>
+std::vector<state_type>
+make_query<this_table, record>::scan_partition(bool const concurrent, fun_type && fun) const
+{
+    if (!concurrent) { // lazy scan in calling thread
+        std::vector<state_type> result(1);
+        state_type & state = result[0];
+        const datatable::datapage_access access(&m_table.get_table(),
+            dataType::type::IN_ROW_DATA, pageType::type::data);
+        for (page_head const * const p : access) {
+            scan_page(p, [&state, &fun](record const & row) {
+                fun(state, row);
+            });
+        }
+        return result;
+    }
+    database const & db = *m_table.get_db();
+    const page_ids ids = data_page_ids();
+    const size_t count = partition_count(ids.size());
+    std::vector<state_type> result(count);
+    run_partition(count, [this, &db, &ids, &result, &fun, count](size_t const i) {
+        const size_t first = ids.size() * i / count;
+        const size_t last = ids.size() * (i + 1) / count;
+        state_type & state = result[i];
+        for (size_t p = first; p < last; p += read_ahead_pages) {
+            const size_t next = a_min(p + read_ahead_pages, last);
+            page_ids chunk(ids.begin() + p, ids.begin() + next);
+            db.prefetch_pages(chunk);
+            for (size_t j = p; j < next; ++j) {
+                page_head const * const page = db.load_page_head(ids[j]);
+                if (page && page->is_data()) { // heap extents may contain pages of other type
+                    scan_page(page, [&state, &fun](record const & row) {
+                        fun(state, row);
+                    });
+                }
+            }
+            if (i) { // calling thread keeps its pages locked
+                db.unlock_thread(bpool::removef::false_);
+            }
+        }
+    });
+    return result;
+}
+
+template<class this_table, class record>
+record make_query<this_table, record>::snapshot_record(column_snapshot::row_locator const & pos, page_head const * & page) const
+{
+    if (!page || (page->data.pageId != pos.page)) {
+        page = m_table.get_db()->load_page_head(pos.page);
+        if (!page) {
+            throw_error<sdl_exception_t<column_snapshot>>("snapshot page not found");
+        }
+    }
+    return get_record(page_slot(page, pos.slot));
+}
+
+template<class this_table, class record>
+template<class fun_type>
+void make_query<this_table, record>::scan_selection(column_snapshot const & snapshot,
+    column_snapshot::selection const & sel, fun_type && fun) const
+{
+    page_head const * page = nullptr;
+    column_snapshot::for_selected(sel, 0, snapshot.size(), [this, &snapshot, &page, &fun](size_t const row) {
+        return fun(snapshot_record(snapshot.locator(row), page));
+    });
+}
+
+// Splits selected rows of snapshot into contiguous ranges, one state per range (in scan order).
+template<class this_table, class record>
+template<class state_type, class fun_type>
+std::vector<state_type>
+make_query<this_table, record>::scan_partition(column_snapshot const & snapshot,
+    column_snapshot::selection const & sel, bool const concurrent, fun_type && fun) const
+{
+    const size_t hardware = concurrent ? std::thread::hardware_concurrency() : 1;
+    const size_t count = a_max(a_min(hardware, column_snapshot::count(sel) / min_partition_rows), size_t(1));
+    std::vector<state_type> result(count);
+    run_partition(count, [this, &snapshot, &sel, &result, &fun, count](size_t const i) {
+        const size_t first = snapshot.size() * i / count;
+        const size_t last = snapshot.size() * (i + 1) / count;
+        state_type & state = result[i];
+        page_head const * page = nullptr;
+        column_snapshot::for_selected(sel, first, last, [this, &snapshot, &page, &state, &fun](size_t const row) {
+            fun(state, snapshot_record(snapshot.locator(row), page));
+            return true;
+        });
+    });
+    return result;
+}
+
+namespace make_query_ {
+
+// checks all search conditions of sub_expr for record
+template<class sub_expr_type>
+struct SELECT_RECORD : is_static {
+private:
+    using SEARCH = typename SELECT_SEARCH_TYPE<sub_expr_type>::Result;
+    using search_AND = search_operator_t<operator_::AND, SEARCH>;
+    using search_OR = search_operator_t<operator_::OR, SEARCH>;
+public:
+    template<class record>
+    static bool select(record const & p, sub_expr_type const & expr) {
+        return
+            SELECT_OR<search_OR, true>::select(p, expr) &&    // any of
+            SELECT_AND<search_AND, true>::select(p, expr);    // must be
+    }
+};
+
+// runs hash aggregation inside the scan, records are not materialized
+template<class sub_expr_type>
+class GROUP_SELECT : is_static {
+    template<class state_type, class query_type> // full scan split by data pages
+    static void select(state_type & state, query_type const & query, sub_expr_type const & expr, std::true_type) {
+        using record = typename query_type::record;
+        auto fun = [&expr](state_type & s, record const & p) {
+            if (SELECT_RECORD<sub_expr_type>::select(p, expr)) {
+                s.apply(p);
+            }
+        };
+        enum { concurrent = IS_CONCURRENT_SCAN<sub_expr_type>::value };
+        std::vector<state_type> partition;
+        column_snapshot::selection sel;
+        auto const snapshot = query.snapshot();
+        if (snapshot && SNAPSHOT_SELECT<sub_expr_type>::select(sel, *snapshot, expr)) {
+            partition = query.template scan_partition<state_type>(*snapshot, sel, concurrent, fun);
+        }
+        else {
+            partition = query.template scan_partition<state_type>(concurrent, fun);
+        }
+        SDL_ASSERT(!partition.empty());
+        auto it = partition.begin();
+        state = std::move(*it);
+        for (++it; it != partition.end(); ++it) {
+            state.merge(*it);
+        }
+    }
+    template<class state_type, class query_type> // index or spatial seek
+    static void select(state_type & state, query_type const & query, sub_expr_type const & expr, std::false_type) {
+        typename query_type::record_range result; // unique by key as in VALUES() (OR or duplicate IN)
+        SCAN_OR_SEEK<sub_expr_type>::select(result, query, expr);
+        for (auto const & p : result) {
+            state.apply(p);
+        }
+    }
+public:
+    template<class state_type, class query_type>
+    static void select(state_type & state, query_type const & query, sub_expr_type const & expr) {
+        using TOP = typename SELECT_TOP_TYPE<sub_expr_type>::Result;
+        static_assert(TL::IsEmpty<TOP>::value, "GROUP_SELECT TOP");
+        select(state, query, expr, bool_constant<IS_SCAN_TABLE<sub_expr_type>::value>());
+    }
+};
+
+template<class sub_expr_type, class TOP = typename SELECT_TOP_TYPE<sub_expr_type>::Result>
+struct QUERY_COUNT {
+    template<class query_type> static
+    size_t select(query_type const & query, sub_expr_type const & expr) {
+        using ORDER = typename SELECT_ORDER_TYPE<sub_expr_type>::Result;
+        typename query_type::record_range result;
+        QUERY_VALUES<sub_expr_type, TOP, ORDER>::select(result, query, expr);
+        return result.size();
+    }
+};
+
+template<class sub_expr_type>
+struct QUERY_COUNT<sub_expr_type, NullType> { // ORDER does not change count
+    template<class query_type> static
+    size_t select(query_type const & query, sub_expr_type const & expr) {
+        group_::aggregate_state<where_::COUNT<>> result;
+        GROUP_SELECT<sub_expr_type>::select(result, query, expr);
+        return std::get<0>(result.result());
+    }
+};
+
+} // make_query_
+
+//--------------------------------------------------------------
+
+template<class this_table, class record>
+template<class sub_expr_type> size_t
+make_query<this_table, record>::COUNT(sub_expr_type const & expr) const
+{
+    using namespace make_query_;
+    static_assert(CHECK_INDEX<sub_expr_type>::value, "");
+    static_assert(CHECK_COLUMN<this_table, sub_expr_type>::value, "");
+
+#if SDL_DEBUG_QUERY
+    SDL_TRACE_QUERY("\nCOUNT:");
+    where_::trace_::trace_sub_expr(expr);
+    SDL_TRACE_QUERY("\n------");
+    SDL_TRACE("IS_SCAN_TABLE = ", IS_SCAN_TABLE<sub_expr_type>::value);
+#endif
+    return QUERY_COUNT<sub_expr_type>::select(*this, expr);
+}
+
+template<class this_table, class record>
+template<class sub_expr_type, class key_type, class... aggs>
+group_::group_range<key_type, aggs...>
+make_query<this_table, record>::GROUP_BY(sub_expr_type const & expr) const
+{
+    using namespace make_query_;
+    static_assert(CHECK_INDEX<sub_expr_type>::value, "");
+    static_assert(CHECK_COLUMN<this_table, sub_expr_type>::value, "");
+    using ORDER = typename SELECT_ORDER_TYPE<sub_expr_type>::Result;
+    static_assert(TL::IsEmpty<ORDER>::value, "GROUP_BY ORDER");
+
+    group_::group_table<key_type, aggs...> result;
+    GROUP_SELECT<sub_expr_type>::select(result, *this, expr);
+    return result.result();
+}
+
+template<class this_table, class record>
+template<class sub_expr_type, class key_type>
+std::vector<key_type>
+make_query<this_table, record>::DISTINCT(sub_expr_type const & expr) const
+{
+    using namespace make_query_;
+    static_assert(CHECK_INDEX<sub_expr_type>::value, "");
+    static_assert(CHECK_COLUMN<this_table, sub_expr_type>::value, "");
+    using ORDER = typename SELECT_ORDER_TYPE<sub_expr_type>::Result;
+    static_assert(TL::IsEmpty<ORDER>::value, "DISTINCT ORDER");
+
+    group_::group_table<key_type> result;
+    GROUP_SELECT<sub_expr_type>::select(result, *this, expr);
+    return result.keys();
+}
+
+template<class this_table, class record>
+template<class sub_expr_type, class key_type>
+std::vector<key_type>
+make_query<this_table, record>::SELECT_AS(sub_expr_type const & expr) const
+{
+    using namespace make_query_;
+    static_assert(CHECK_INDEX<sub_expr_type>::value, "");
+    static_assert(CHECK_COLUMN<this_table, sub_expr_type>::value, "");
+    using ORDER = typename SELECT_ORDER_TYPE<sub_expr_type>::Result;
+    static_assert(TL::IsEmpty<ORDER>::value, "SELECT_AS ORDER");
+
+    group_::select_table<key_type> result;
+    GROUP_SELECT<sub_expr_type>::select(result, *this, expr);
+    return result.result();
+}
+
+template<class this_table, class record>
+template<class sub_expr_type, class... aggs>
+group_::aggregate_result<aggs...>
+make_query<this_table, record>::AGGREGATE(sub_expr_type const & expr) const
+{
+    using namespace make_query_;
+    static_assert(CHECK_INDEX<sub_expr_type>::value, "");
+    static_assert(CHECK_COLUMN<this_table, sub_expr_type>::value, "");
+
+    group_::aggregate_state<aggs...> result;
+    GROUP_SELECT<sub_expr_type>::select(result, *this, expr);
+    return result.result();
+}
+
+} // make
+} // db
+} // sdl
+
+#endif // __SDL_SYSTEM_MAKETABLE_GROUP_HPP__
@@ -0,0 +1,304 @@
+// maketable_join.hpp
+//
+#pragma once
+#ifndef __SDL_SYSTEM_MAKETABLE_JOIN_HPP__
+#define __SDL_SYSTEM_MAKETABLE_JOIN_HPP__
+
+namespace sdl { namespace db { namespace make { namespace make_query_ {
+
+template<class left_col, class right_col>
+struct JOIN_KEY : is_static {
+    static_assert(left_col::fixed && right_col::fixed, "JOIN need fixed column");
+    static_assert(std::is_same<typename left_col::val_type, typename right_col::val_type>::value,
+        "JOIN columns must have same type");
+    using type = group_::group_key<right_col>;
+
+    template<class col, class record> // returns false for NULL, NULL never matches
+    static bool read(type & dest, record const & p) {
+        if (p.is_null(identity<col>())) {
+            return false;
+        }
+        meta::copy(dest.template set<0>(), p.val(identity<col>()));
+        return true;
+    }
+};
+
+template<class right_expr, class right_col, where_::INDEX hint>
+struct JOIN_TYPE {
+private:
+    using right_query = typename right_expr::query_t;
+public:
+    enum { index_key = right_query::template is_cluster_T0<right_col>::value };
+    enum { index_join = index_key && (hint != where_::INDEX::IGNORE) };
+    static_assert(index_key || (hint != where_::INDEX::USE), "JOIN INDEX::USE need cluster key");
+};
+
+template<class sub_expr_type, class right_expr, class left_col, class right_col, class fun_type>
+class JOIN_TABLE final : noncopyable {
+    using left_query = typename sub_expr_type::query_t;
+    using right_query = typename right_expr::query_t;
+    using left_record = typename left_query::record;
+    using right_record = typename right_query::record;
+    using KEY = JOIN_KEY<left_col, right_col>;
+    using key_type = typename KEY::type;
+    enum { batch_size = 1024 };
+    enum { hash_slot_size = 32 }; // estimated open_hash_map slot overhead per row
+public:
+    sub_expr_type const &   m_left;
+    right_expr const &      m_right;
+    const size_t            m_budget;
+    fun_type &              m_fun;
+
+    JOIN_TABLE(sub_expr_type const & left, right_expr const & right, size_t const budget, fun_type & fun)
+        : m_left(left), m_right(right), m_budget(budget), m_fun(fun)
+    {}
+    void select(std::true_type);    // index nested-loop join
+    void select(std::false_type);   // hash join
+private:
+    bool m_done = false;
+    struct batch_row {
+        key_type key;
+        left_record rec;
+    };
+    using batch_type = std::vector<batch_row>;
+    void seek_batch(batch_type &);
+    bool emit(left_record const & x, right_record const & y) {
+        if (!m_fun(x, y)) {
+            m_done = true;
+        }
+        return !m_done;
+    }
+};
+
+// left records are collected into batches sorted by key,
+// so right cluster index is visited in key order and each distinct key is seeked once
+template<class sub_expr_type, class right_expr, class left_col, class right_col, class fun_type>
+void JOIN_TABLE<sub_expr_type, right_expr, left_col, right_col, fun_type>::seek_batch(batch_type & batch)
+{
+    std::stable_sort(batch.begin(), batch.end(), [](batch_row const & x, batch_row const & y) {
+        return meta::key_less<right_col>::less(x.key.template get<0>(), y.key.template get<0>());
+    });
+    right_query const & query = m_right.m_query;
+    auto first = batch.begin();
+    while ((first != batch.end()) && !m_done) {
+        auto last = first + 1;
+        while ((last != batch.end()) && (last->key == first->key)) {
+            ++last;
+        }
+        auto const & value = first->key.template get<0>();
+        auto const pos = query.lower_bound(value);
+        if (pos.second) {
+            query.scan_next(pos.first, [this, &query, &value, first, last](right_record const & p) {
+                if (!query.equal_first_key(p.head(), value)) {
+                    return false;
+                }
+                if (SELECT_RECORD<right_expr>::select(p, m_right)) {
+                    for (auto it = first; it != last; ++it) {
+                        if (!emit(it->rec, p)) {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            });
+        }
+        first = last;
+    }
+    batch.clear();
+}
+
+template<class sub_expr_type, class right_expr, class left_col, class right_col, class fun_type>
+void JOIN_TABLE<sub_expr_type, right_expr, left_col, right_col, fun_type>::select(std::true_type)
+{
+    batch_type batch;
+    batch.reserve(batch_size);
+    m_left.for_record([this, &batch](left_record const & p) {
+        key_type key{};
+        if (KEY::template read<left_col>(key, p)) {
+            batch.push_back({ key, p });
+            if (batch.size() == batch_size) {
+                seek_batch(batch);
+            }
+        }
+        return !m_done;
+    });
+    if (!m_done && !batch.empty()) {
+        seek_batch(batch);
+    }
+}
+
+// right side is build side; if it exceeds memory budget,
+// it is split into blocks and left side is probed once per block
+template<class sub_expr_type, class right_expr, class left_col, class right_col, class fun_type>
+void JOIN_TABLE<sub_expr_type, right_expr, left_col, right_col, fun_type>::select(std::false_type)
+{
+    struct build_row {
+        right_record rec;
+        uint32 next; // 0 = end of chain, else position in rows + 1
+    };
+    using map_type = open_hash_map<key_type, uint32, typename key_type::hash>;
+    enum { row_size = sizeof(build_row) + sizeof(typename map_type::value_type) + hash_slot_size };
+    size_t const max_rows = a_max(m_budget / row_size, size_t(batch_size));
+    map_type table;
+    std::vector<build_row> rows;
+    auto probe = [this, &table, &rows]() {
+        m_left.for_record([this, &table, &rows](left_record const & p) {
+            key_type key{};
+            if (KEY::template read<left_col>(key, p)) {
+                auto const found = table.find(key);
+                if (found != table.end()) {
+                    for (uint32 i = found->second; i; i = rows[i - 1].next) {
+                        if (!emit(p, rows[i - 1].rec)) {
+                            return false;
+                        }
+                    }
+                }
+            }
+            return true;
+        });
+        table.clear();
+        rows.clear();
+    };
+    m_right.for_record([this, &table, &rows, &probe, max_rows](right_record const & p) {
+        key_type key{};
+        if (KEY::template read<right_col>(key, p)) {
+            uint32 & head = table[key];
+            rows.push_back({ p, head });
+            head = static_cast<uint32>(rows.size());
+            if (rows.size() >= max_rows) {
+                probe();
+            }
+        }
+        return !m_done;
+    });
+    if (!m_done && !rows.empty()) {
+        probe();
+    }
+}
+
+} // make_query_
+
+template<class this_table, class record>
+template<class sub_expr_type, class col, class right_col, where_::INDEX hint, class right_expr, class fun_type>
+void make_query<this_table, record>::for_join(sub_expr_type const & expr, right_expr const & right,
+                                              size_t const memory_budget, fun_type && fun) const
+{
+    using namespace make_query_;
+    static_assert(CHECK_INDEX<sub_expr_type>::value, "");
+    static_assert(CHECK_COLUMN<this_table, sub_expr_type>::value, "");
+    static_assert(TL::IndexOf<typename this_table::type_list, col>::value != -1, "JOIN column must belong to table");
+    using join_type = JOIN_TYPE<right_expr, right_col, hint>;
+    using join_table = JOIN_TABLE<sub_expr_type, right_expr, col, right_col, remove_reference_t<fun_type>>;
+    join_table(expr, right, memory_budget, fun).select(bool_constant<join_type::index_join>());
+}
+
+struct join_benchmark_result {
+    size_t index_rows;
+    size_t hash_rows;
+    long_long index_time; // microseconds
+    long_long hash_time;  // microseconds
+};
+
+// times full INNER JOIN left.col = right.right_col with index nested-loop and hash join;
+// index_time is zero if right_col is not first column of right table cluster key
+template<class col, class right_col, class left_table, class right_table>
+join_benchmark_result join_benchmark(left_table const & left, right_table const & right,
+                                     size_t const memory_budget = select_::join_memory_budget)
+{
+    using namespace where_;
+    using left_record = typename left_table::record;
+    using right_record = typename right_table::record;
+    join_benchmark_result result{};
+    microseconds_span time;
+    if (right_table::query_type::template is_cluster_T0<right_col>::value) {
+        (left->SELECT | ALL{}).template for_join<col, right_col, INDEX::AUTO>(right->SELECT | ALL{},
+            [&result](left_record const &, right_record const &) {
+            ++result.index_rows;
+            return true;
+        }, memory_budget);
+        result.index_time = time.now_reset();
+    }
+    (left->SELECT | ALL{}).template for_join<col, right_col, INDEX::IGNORE>(right->SELECT | ALL{},
+        [&result](left_record const &, right_record const &) {
+        ++result.hash_rows;
+        return true;
+    }, memory_budget);
+    result.hash_time = time.now();
+    SDL_ASSERT(!result.index_time || (result.index_rows == result.hash_rows));
+    return result;
+}
+
+namespace make_query_ {
+
+template<class col> struct is_join_col : bool_constant<col::fixed != 0> {};
+template<> struct is_join_col<NullType> : std::false_type {}; // heap table
+
+template<class table_type, class T0_col = typename meta::clustered_traits<typename table_type::clustered>::T0_col,
+    bool = is_join_col<T0_col>::value>
+struct cluster_join_benchmark { // table is joined with itself on first column of cluster key
+    static bool run(table_type const & table, join_benchmark_result & result) {
+        result = join_benchmark<T0_col, T0_col>(table, table);
+        return true;
+    }
+};
+
+template<class table_type, class T0_col>
+struct cluster_join_benchmark<table_type, T0_col, false> {
+    static bool run(table_type const &, join_benchmark_result &) {
+        return false;
+    }
+};
+
+} // make_query_
+
+// prints join_benchmark (table joined with itself on first column of cluster key) and view_benchmark
+// of generated table with given name; TList is type_list of generated database_table_list;
+// returns false if table is not in TList or not found in database
+template<class TList> struct table_benchmark;
+
+template<> struct table_benchmark<NullType> {
+    static bool print(database const *, std::string const &, bool, bool, std::ostream &) {
+        return false;
+    }
+};
+
+template<class T, class U>
+struct table_benchmark<Typelist<T, U>> {
+    static bool print(database const * const db, std::string const & name, bool const join, bool const view, std::ostream & out) {
+        if (name != T::name()) {
+            return table_benchmark<U>::print(db, name, join, view, out);
+        }
+        shared_usertable const schema = db->find_table_schema(_schobj_id(T::id));
+        if (!schema) {
+            return false;
+        }
+        const T table(db, schema);
+        out << "\ntable_benchmark " << name;
+        if (join) {
+            join_benchmark_result bench{};
+            if (make_query_::cluster_join_benchmark<T>::run(table, bench)) {
+                out << "\njoin rows = " << bench.hash_rows
+                    << "\nindex nested loops microseconds = " << bench.index_time
+                    << "\nhash join microseconds = " << bench.hash_time;
+            }
+            else {
+                out << "\njoin: no fixed-length cluster key";
+            }
+        }
+        if (view) {
+            const view_benchmark_result bench = view_benchmark(table);
+            out << "\nrows = " << bench.rows
+                << "\ncolumn checksum = " << bench.checksum
+                << "\nrecord accessors microseconds = " << bench.record_time
+                << "\nrecord::view microseconds = " << bench.view_time;
+        }
+        out << std::endl;
+        return true;
+    }
+};
+
+} // make
+} // db
+} // sdl
+
+#endif // __SDL_SYSTEM_MAKETABLE_JOIN_HPP__
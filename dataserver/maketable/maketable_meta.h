@@ -111,6 +111,24 @@ struct IsFixed< Typelist<T, U> > {
     enum { value = T::fixed && IsFixed<U>::value };
 };
 
+template <class TList> struct NullSize; // columns in null bitmap
+template <> struct NullSize<NullType> {
+    enum { value = 0 };
+};
+template <class T, class U>
+struct NullSize< Typelist<T, U> > {
+    enum { value = a_max(size_t(T::place) + 1, size_t(NullSize<U>::value)) };
+};
+
+template <class TList> struct VarSize; // variable-length columns
+template <> struct VarSize<NullType> {
+    enum { value = 0 };
+};
+template <class T, class U>
+struct VarSize< Typelist<T, U> > {
+    enum { value = a_max(size_t(T::fixed ? 0 : (T::offset + 1)), size_t(VarSize<U>::value)) };
+};
+
 template<size_t _place, size_t off, scalartype::type _type, int len, typename base_key = key_false>
 struct col : base_key {
 private:
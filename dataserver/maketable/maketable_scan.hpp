@@ -6,10 +6,204 @@
 
 namespace sdl { namespace db { namespace make {
 
+template<class this_table, class record>
+template<typename... Ts>
+void make_query<this_table, record>::decode_page(page_head const * const page, column_batch<Ts...> & batch) const
+{
+    static_assert(column_batch<Ts...>::template is_column_of<typename this_table::type_list>(), "column must belong to table");
+    using row_view = row_view_t<this_table::null_size, 0>; // batch columns are fixed
+    const datapage data(page);
+    for (size_t slot = 0; slot < data.size(); ++slot) {
+        row_head const * const row = data[slot];
+        if (row->use_record()) {
+            batch.push_back(row_view(row));
+        }
+    }
+}
+
+template<class this_table, class record>
+template<typename... Ts, class fun_type>
+void make_query<this_table, record>::scan_batch(fun_type && fun, size_t const batch_pages) const
+{
+    SDL_ASSERT(batch_pages);
+    const datatable::datapage_access access(&m_table.get_table(),
+        dataType::type::IN_ROW_DATA, pageType::type::data);
+    column_batch<Ts...> batch;
+    column_batch<Ts...> const & result = batch;
+    size_t pages = 0;
+    for (page_head const * const p : access) {
+        decode_page(p, batch);
+        if (++pages == batch_pages) {
+            pages = 0;
+            if (!batch.empty()) {
+                if (is_break(make_break_or_continue(fun(result)))) {
+                    return;
+                }
+                batch.clear();
+            }
+        }
+    }
+    if (!batch.empty()) {
+        fun(result);
+    }
+}
+
+template<class this_table, class record>
+template<class before_type, class after_type>
+void make_query<this_table, record>::seek_secondary(secondary_index const & index, bookmark_range & result,
+    before_type && before, after_type && after, size_t const limit) const
+{
+    SDL_ASSERT(index.get_id() == _schobj_id(this_table::id));
+    SDL_ASSERT(index.is_heap() == (index_size == 0));
+    if (limit && (result.size() >= limit)) {
+        return;
+    }
+    database const * const db = m_table.get_db();
+    index.scan_range([db](pageFileID const & id) {
+            return db->load_page_head(id);
+        }, before, after,
+        [this, &index, &result, limit](row_head const * const row) {
+            result.push_back(read_bookmark(index, row, bool_constant<index_size != 0>()));
+            return !limit || (result.size() < limit);
+        });
+}
+
+template<class this_table, class record>
+typename make_query<this_table, record>::bookmark_type
+make_query<this_table, record>::read_bookmark(secondary_index const & index, row_head const * const row, std::true_type) const
+{
+    SDL_ASSERT(m_cluster_index->key_length() == sizeof(key_type));
+    key_type key; // uninitialized
+    index.get_cluster_key(row, reinterpret_cast<char *>(&key));
+    return key;
+}
+
+template<class this_table, class record>
+typename make_query<this_table, record>::bookmark_type
+make_query<this_table, record>::read_bookmark(secondary_index const & index, row_head const * const row, std::false_type) const
+{
+    return index.get_RID(row);
+}
+
+template<class this_table, class record>
+template<class fun_type>
+void make_query<this_table, record>::fetch_bookmarks(bookmark_range & range, fun_type && fun) const
+{
+    std::sort(range.begin(), range.end(), [](bookmark_type const & x, bookmark_type const & y) {
+        return x < y;
+    });
+    range.erase(std::unique(range.begin(), range.end(), [](bookmark_type const & x, bookmark_type const & y) {
+        return x == y;
+    }), range.end());
+    fetch_bookmarks(range, fun, bool_constant<index_size != 0>());
+}
+
+template<class this_table, class record>
+void make_query<this_table, record>::prefetch_range(bookmark_range const & range, size_t const first,
+                                                    std::vector<pageFileID> & pages) const
+{
+    SDL_ASSERT(first < range.size());
+    size_t const last = a_min(range.size(), first + prefetch_bookmarks);
+    pages.clear();
+    pages.reserve(last - first);
+    for (size_t i = first; i < last; ++i) {
+        pages.push_back(bookmark_page(range[i], bool_constant<index_size != 0>()));
+    }
+    std::vector<pageFileID> prefetch(pages); // sorted and made unique by prefetch_pages
+    m_table.get_db()->prefetch_pages(prefetch);
+}
+
+template<class this_table, class record>
+pageFileID make_query<this_table, record>::find_key_page_id(key_type const & key, pageType_t<pageType::type::index>) const
+{
+    return make::index_tree<key_type>(m_table.get_db(), m_cluster_index->root()).find_page(key);
+}
+
+template<class this_table, class record>
+page_head const * make_query<this_table, record>::load_key_page(pageFileID const & id, pageType_t<pageType::type::index>) const
+{
+    if (id) {
+        return m_table.get_db()->load_page_head(id);
+    }
+    return nullptr;
+}
+
+template<class this_table, class record>
+page_head const * make_query<this_table, record>::load_key_page(pageFileID const &, pageType_t<pageType::type::data>) const
+{
+    return m_cluster_index->root();
+}
+
+template<class this_table, class record>
+template<class fun_type>
+void make_query<this_table, record>::fetch_bookmarks(bookmark_range const & range, fun_type && fun, std::true_type) const
+{
+    std::vector<pageFileID> pages;
+    page_head const * page = nullptr; // keys are sorted, next key is often in the same page
+    for (size_t i = 0, end = range.size(); i < end; ++i) {
+        if (!(i % prefetch_bookmarks)) {
+            prefetch_range(range, i, pages);
+        }
+        key_type const & key = range[i];
+        pageFileID const & id = pages[i % prefetch_bookmarks];
+        if (!page || (page->data.pageId != id)) {
+            page = load_key_page(id, pageType_t<table_clustered::root_page_type>());
+            if (!(page && slot_array::size(page))) {
+                page = nullptr;
+                continue;
+            }
+        }
+        SDL_ASSERT(page->is_data());
+        const datapage data(page);
+        size_t const slot = data.lower_bound([this, &key](row_head const * const row) {
+            return (this->read_key(row) < key);
+        });
+        if (slot < data.size()) {
+            row_head const * const head = data[slot];
+            if (head->use_record() && !(key < read_key(head))) {
+                if (!fun(get_record(head))) {
+                    break;
+                }
+            }
+        }
+    }
+}
+
+template<class this_table, class record>
+template<class fun_type>
+void make_query<this_table, record>::fetch_bookmarks(bookmark_range const & range, fun_type && fun, std::false_type) const
+{
+    auto const db = m_table.get_db();
+    auto const load_row = [db](recordID const & id) -> row_head const * {
+        if (page_head const * const page = db->load_page_head(id.id)) {
+            if (id.slot < slot_array::size(page)) {
+                return datapage(page)[id.slot];
+            }
+        }
+        throw_error<sdl_exception_t<secondary_index>>("bookmark not found");
+        return nullptr;
+    };
+    std::vector<pageFileID> pages;
+    for (size_t i = 0, end = range.size(); i < end; ++i) { // pages are loaded in order of RID
+        if (!(i % prefetch_bookmarks)) {
+            prefetch_range(range, i, pages);
+        }
+        row_head const * row = load_row(range[i]);
+        if (row->is_forwarding_record()) {
+            row = load_row(forwarding_record(row).row());
+        }
+        if (row->use_record()) {
+            if (!fun(get_record(row))) {
+                break;
+            }
+        }
+    }
+}
+
 template<class this_table, class record>
 record make_query<this_table, record>::find_with_index(key_type const & key, pageType_t<pageType::type::index>) const
 {
-    static_assert(index_size, "");
+    static_assert(index_size != 0, "");
     static_assert(is_cluster_root_index(), "");
     auto const db = m_table.get_db();
     if (auto const id = make::index_tree<key_type>(db, m_cluster_index->root()).find_page(key)) {
@@ -37,7 +231,7 @@ record make_query<this_table, record>::find_with_index(key_type const & key, pag
 template<class this_table, class record>
 record make_query<this_table, record>::find_with_index(key_type const & key, pageType_t<pageType::type::data>) const
 {
-    static_assert(index_size, "");
+    static_assert(index_size != 0, "");
     static_assert(is_cluster_root_data(), "");
     if (record found = make_query::find([&key](record const & p){ 
         return !make_query::less_key(p, key); 
@@ -83,7 +277,7 @@ std::pair<page_slot, bool>
 make_query<this_table, record>::lower_bound(T0_type const & value, pageType_t<pageType::type::index>) const
 {
     static_assert(T0_col::order != sortorder::NONE, "");
-    static_assert(index_size, "");
+    static_assert(index_size != 0, "");
     static_assert(is_cluster_root_index(), "");
     SDL_ASSERT(m_cluster_index->is_root_index());
     auto const db = m_table.get_db();
@@ -98,7 +292,7 @@ std::pair<page_slot, bool>
 make_query<this_table, record>::lower_bound(T0_type const & value, pageType_t<pageType::type::data>) const
 {
     static_assert(T0_col::order != sortorder::NONE, "");
-    static_assert(index_size, "");
+    static_assert(index_size != 0, "");
     static_assert(is_cluster_root_data(), "");
     SDL_ASSERT(m_cluster_index->is_root_data());
     return lower_bound(m_cluster_index->root(), value);
@@ -114,7 +308,7 @@ template<class this_table, class record>
 template<class fun_type> page_slot
 make_query<this_table, record>::scan_next(page_slot const & pos, fun_type && fun) const
 {
-    static_assert(index_size, "");
+    static_assert(index_size != 0, "");
     if (pos.page) {
         size_t slot = pos.slot;
         page_head const * page = pos.page;
@@ -137,11 +331,178 @@ make_query<this_table, record>::scan_next(page_slot const & pos, fun_type && fun
     return {};
 }
 
+template<class this_table, class record>
+page_slot make_query<this_table, record>::first_slot() const
+{
+    static_assert(index_size != 0, "");
+    auto const db = m_table.get_db();
+    page_head const * page = m_cluster_index->root();
+    if (is_cluster_root_index()) {
+        page = db->load_page_head(make::index_tree<key_type>(db, page).min_page());
+    }
+    while (page) {
+        SDL_ASSERT(page->is_data());
+        if (!datapage(page).empty()) {
+            return { page, 0 };
+        }
+        page = db->load_next_head(page);
+    }
+    return {};
+}
+
+template<class this_table, class record>
+page_slot make_query<this_table, record>::upper_bound(T0_type const & value) const
+{
+    auto const found = lower_bound(value);
+    if (found.second) { // skip equal values
+        return scan_next(found.first, [this, &value](record const & p){
+            return equal_first_key(p.head(), value);
+        });
+    }
+    return found.first;
+}
+
+template<class this_table, class record>
+typename make_query<this_table, record>::geo_cache_type *
+make_query<this_table, record>::get_geo_cache() const
+{
+    std::call_once(m_geo_once, [this]() {
+        if (const size_t mb = m_table.get_db()->cfg().geo_cache) {
+            reset_new(m_geo_cache, mb * megabyte<1>::value);
+        }
+    });
+    return m_geo_cache.get();
+}
+
+template<class this_table, class record>
+template<class col, class fun_type>
+bool make_query<this_table, record>::geography_if(record const & p, pk0_type const & pk0, fun_type && fun) const
+{
+    static_assert(col::type == scalartype::t_geography, "geography_if");
+    if (geo_cache_type * const cache = get_geo_cache()) {
+        auto const geo = cache->load(pk0, [&p](pk0_type const &) {
+            return p.val(identity<col>{});
+        });
+        if (geo) {
+            return fun(*geo);
+        }
+    }
+    return fun(p.val(identity<col>{}));
+}
+
+template<class this_table, class record>
+typename make_query<this_table, record>::page_ids
+make_query<this_table, record>::range_pages(page_slot const & first, page_slot const & last,
+                                            pageType_t<pageType::type::index>) const
+{
+    SDL_ASSERT(first.page);
+    page_ids result;
+    if (first.page == last.page) {
+        result.push_back(first.page->data.pageId);
+    }
+    else { // leaf pages are not loaded
+        auto const db = m_table.get_db();
+        const pageFileID last_id = last.page ? last.page->data.pageId : pageFileID{};
+        result = make::index_tree<key_type>(db, m_cluster_index->root()).leaf_pages(
+            read_key(datapage(first.page)[first.slot]), first.page->data.pageId, last_id);
+        SDL_ASSERT(!result.empty() && (result[0] == first.page->data.pageId));
+    }
+    return result;
+}
+
+template<class this_table, class record>
+template<class fun_type> inline
+bool make_query<this_table, record>::scan_range_page(page_head const * const page,
+    page_slot const & first, page_slot const & last, fun_type && fun)
+{
+    const datapage data(page);
+    size_t const slot_end = (page == last.page) ? last.slot : data.size();
+    for (size_t slot = (page == first.page) ? first.slot : 0; slot < slot_end; ++slot) {
+        if (!fun(data[slot])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<class this_table, class record>
+template<class load_next_type, class fun_type> page_head const *
+make_query<this_table, record>::scan_range_head(page_slot const & first, page_slot const & last,
+                                                load_next_type && load_next, fun_type && fun)
+{
+    page_head const * page = first.page;
+    for (size_t n = 0; page; ++n) {
+        if (!scan_range_page(page, first, last, fun) || (page == last.page)) {
+            return nullptr;
+        }
+        page = load_next(page);
+        if ((n + 1 == min_partition_pages) && page && (page != last.page) && !datapage(page).empty()) {
+            return page; // rest of range has more than one page
+        }
+    }
+    return nullptr;
+}
+
+template<class this_table, class record>
+template<class fun_type> break_or_continue
+make_query<this_table, record>::scan_range(page_slot const & first, page_slot const & last, fun_type && fun) const
+{
+    static_assert(index_size != 0, "");
+    break_or_continue result = bc::continue_;
+    if (!first.page) {
+        return result;
+    }
+    auto call_fun = [this, &result, &fun](row_head const * const row) {
+        return bc::continue_ == (result = fun(get_record(row)));
+    };
+    database const & db = *m_table.get_db();
+    page_head const * const page = scan_range_head(first, last, [&db](page_head const * const p) {
+        return db.load_next_head(p);
+    }, call_fun);
+    if (!page) { // short ranges and TOP are finished in calling thread
+        return result;
+    }
+    const page_ids ids = range_pages(page_slot(page, 0), last, pageType_t<table_clustered::root_page_type>());
+    const size_t count = partition_count(ids.size());
+    // partitions 1..count-1 are read by worker threads (pages are loaded and unlocked by worker,
+    // so they stay in page_bpool or page cache) while calling thread passes rows to fun in key order
+    std::atomic<bool> cancel{ false };
+    database::scoped_page_count * const page_count = database::scoped_page_count::current();
+    std::vector<std::future<void>> tasks;
+    if (count > 1) {
+        tasks.reserve(count - 1);
+        for (size_t i = 1; i < count; ++i) {
+            const size_t p1 = ids.size() * i / count;
+            const size_t p2 = ids.size() * (i + 1) / count;
+            tasks.push_back(std::async(std::launch::async, [&db, &ids, &cancel, page_count, p1, p2]() {
+                database::scoped_thread_lock lock(db);
+                database::scoped_page_count pages_read(page_count); // ANALYZE
+                for (size_t p = p1; (p < p2) && !cancel; p += read_ahead_pages) {
+                    page_ids next(ids.begin() + p, ids.begin() + a_min(p + read_ahead_pages, p2));
+                    db.prefetch_pages(next);
+                    db.unlock_thread(bpool::removef::false_);
+                }
+            }));
+        }
+    }
+    for (size_t p = 0; p < ids.size(); ++p) {
+        page_head const * const next = p ? db.load_page_head(ids[p]) : page;
+        if (!scan_range_page(next, first, last, call_fun)) {
+            break;
+        }
+    }
+    cancel = true;
+    for (auto & t : tasks) {
+        t.get(); // rethrow worker exception
+    }
+    return result;
+}
+
 template<class this_table, class record>
 template<class fun_type> page_slot
 make_query<this_table, record>::scan_prev(page_slot const & pos, fun_type && fun) const
 {
-    static_assert(index_size, "");
+    static_assert(index_size != 0, "");
     auto const db = m_table.get_db();
     if (pos.page) {
         size_t slot = pos.slot;
@@ -202,6 +563,71 @@ bool make_query<this_table, record>::push_unique(record_range & result, record c
     return true;
 }
 
+namespace make_query_ {
+
+template<class TList> struct view_column_sum;
+template<> struct view_column_sum<NullType> : is_static {
+    template<class record_type>
+    static size_t get(record_type const &) {
+        return 0;
+    }
+};
+
+template<class T, class NextType> // T = col::
+struct view_column_sum<Typelist<T, NextType>> : is_static {
+private:
+    template<class value_type>
+    static size_t value_sum(value_type const & v, meta::is_fixed<1>) { // first byte of value
+        return *reinterpret_cast<const unsigned char *>(&v);
+    }
+    static size_t value_sum(vector_mem_range_t const & v, meta::is_fixed<0>) {
+        return mem_size_n(v);
+    }
+    template<class value_type>
+    static size_t value_sum(value_type const &, meta::is_fixed<0>) { // e.g. geo_mem
+        return 1;
+    }
+public:
+    template<class record_type> // record or record::view
+    static size_t get(record_type const & p) {
+        const size_t sum = p.is_null(identity<T>()) ? 0 :
+            value_sum(p.val(identity<T>()), meta::is_fixed<T::fixed>());
+        return sum + view_column_sum<NextType>::get(p);
+    }
+};
+
+} // make_query_
+
+struct view_benchmark_result {
+    size_t rows;
+    size_t checksum;
+    long_long record_time;  // microseconds
+    long_long view_time;    // microseconds
+};
+
+// times full scan reading every column with generated record accessors (row header is parsed per column)
+// and with record::view (row header is parsed once per row); both scans compute the same checksum
+template<class table_type>
+view_benchmark_result view_benchmark(table_type const & table)
+{
+    using record = typename table_type::record;
+    using column_sum = make_query_::view_column_sum<typename table_type::type_list>;
+    view_benchmark_result result{};
+    microseconds_span time;
+    for (record const p : table) {
+        result.checksum += column_sum::get(p);
+        ++result.rows;
+    }
+    result.record_time = time.now_reset();
+    size_t checksum = 0;
+    for (record const p : table) {
+        checksum += column_sum::get(p.decode());
+    }
+    result.view_time = time.now();
+    SDL_ASSERT(checksum == result.checksum);
+    return result;
+}
+
 } // make
 } // db
 } // sdl
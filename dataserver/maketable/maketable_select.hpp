@@ -361,7 +361,7 @@ struct SEARCH_KEY : SEARCH_KEY_BASE
         0
     >::Result;
 
-    static_assert(TL::Length<search_OR>::value, "SEARCH_KEY: empty OR clause");
+    static_assert(TL::Length<search_OR>::value != 0, "SEARCH_KEY: empty OR clause");
 };
 
 } // search_key_ 
@@ -666,6 +666,32 @@ inline size_t SELECT_TOP(sub_expr_type const & expr) {
 
 //--------------------------------------------------------------
 
+template <class T> struct is_serial_IF {
+    enum { value = false };
+};
+
+template <class F> struct is_serial_IF<where_::SELECT_IF<F, false>> {
+    enum { value = true };
+};
+
+template <class TList> struct has_serial_IF;
+template <> struct has_serial_IF<NullType> {
+    enum { value = false };
+};
+
+template <class Head, class Tail>
+struct has_serial_IF<Typelist<Head, Tail>> {
+    enum { value = is_serial_IF<Head>::value || has_serial_IF<Tail>::value };
+};
+
+// full scan can be split between threads if all lambdas are where_::IF_CONCURRENT
+template<class sub_expr_type>
+struct IS_CONCURRENT_SCAN {
+    enum { value = !has_serial_IF<typename sub_expr_type::type_list>::value };
+};
+
+//--------------------------------------------------------------
+
 template <class TList, class col> struct col_index;
 
 template <class col>
@@ -713,7 +739,7 @@ private:
         0>;
 public:
     using Result = typename T::search_where;
-    static_assert(TL::Length<Result>::value, "SEARCH");
+    static_assert(TL::Length<Result>::value != 0, "SEARCH");
 };
 
 //--------------------------------------------------------------
@@ -986,6 +1012,465 @@ public:
 
 //--------------------------------------------------------------
 
+// search conditions evaluated over columns of column_snapshot (see database::attach_snapshot);
+// NULL of fixed column is stored as zero and compared as value of empty record, like RECORD_SELECT
+template<class T, bool = !std::is_void<typename T::col>::value>
+struct SNAPSHOT_CONDITION;
+
+template<class T> // condition without column, e.g. lambda
+struct SNAPSHOT_CONDITION<T, false> : is_static {
+    template<class sub_expr_type>
+    static bool apply(column_snapshot const &, column_snapshot::selection &, sub_expr_type const &) {
+        return false;
+    }
+};
+
+template<class T> // T = SEARCH_WHERE
+struct SNAPSHOT_CONDITION<T, true> : is_static {
+private:
+    using col = typename T::col;
+    using val_type = typename col::val_type;
+    using selection = column_snapshot::selection;
+    enum { is_number = col::fixed && std::is_arithmetic<val_type>::value };
+
+    static bool equal(val_type const & x, val_type const & y) {
+        return meta::is_equal<col>::equal(x, y);
+    }
+    template<sortorder ord>
+    static bool less(val_type const & x, val_type const & y) {
+        return meta::col_less<col, ord>::less(x, y);
+    }
+    struct is_equal {
+        val_type const & value;
+        bool operator()(val_type const & x) const {
+            return equal(x, value);
+        }
+    };
+    template<sortorder ord>
+    struct is_less {
+        val_type const & value;
+        bool operator()(val_type const & x) const {
+            return less<ord>(x, value);
+        }
+    };
+    template<sortorder ord>
+    struct is_less_eq {
+        val_type const & value;
+        bool operator()(val_type const & x) const {
+            return equal(x, value) || less<ord>(x, value);
+        }
+    };
+    struct is_between {
+        val_type const & first;
+        val_type const & second;
+        bool operator()(val_type const & x) const {
+            return (equal(x, first) || less<sortorder::DESC>(x, first))
+                && (equal(x, second) || less<sortorder::ASC>(x, second));
+        }
+    };
+    template<class list_type, bool found>
+    struct is_in {
+        list_type const & values;
+        bool operator()(val_type const & x) const {
+            for (auto const & v : values) {
+                if (equal(x, static_cast<val_type const &>(v)))
+                    return found;
+            }
+            return !found;
+        }
+    };
+    static int find_column(column_snapshot const & snapshot, bool const fixed) {
+        const int i = snapshot.find(col::name());
+        if (i >= 0) {
+            auto const c = snapshot[i];
+            if ((c.type() == col::type) && (!fixed || ((c.kind() == column_snapshot::column_kind::fixed)
+                && (c.fixed_size() == sizeof(val_type))))) {
+                return i;
+            }
+        }
+        return -1;
+    }
+    template<class pred_type>
+    static bool filter(column_snapshot const & snapshot, selection & sel, pred_type && pred, std::true_type) {
+        const int i = find_column(snapshot, true);
+        if (i < 0) {
+            return false;
+        }
+        snapshot.template filter<val_type>(static_cast<size_t>(i), sel, pred);
+        return true;
+    }
+    template<class pred_type>
+    static bool filter(column_snapshot const &, selection &, pred_type &&, std::false_type) {
+        return false;
+    }
+    template<class pred_type>
+    static bool filter(column_snapshot const & snapshot, selection & sel, pred_type && pred) {
+        return filter(snapshot, sel, pred, bool_constant<is_number>());
+    }
+    template<class expr_type, condition cond>
+    static bool apply(column_snapshot const &, selection &, expr_type const *, condition_t<cond>) {
+        return false; // evaluated for records
+    }
+    template<class expr_type>
+    static bool apply(column_snapshot const & snapshot, selection & sel, expr_type const * const expr, condition_t<condition::WHERE>) {
+        return filter(snapshot, sel, is_equal{ static_cast<val_type const &>(expr->value.values) });
+    }
+    template<class expr_type>
+    static bool apply(column_snapshot const & snapshot, selection & sel, expr_type const * const expr, condition_t<condition::IN>) {
+        using list_type = remove_reference_t<decltype(expr->value.values)>;
+        return filter(snapshot, sel, is_in<list_type, true>{ expr->value.values });
+    }
+    template<class expr_type>
+    static bool apply(column_snapshot const & snapshot, selection & sel, expr_type const * const expr, condition_t<condition::NOT>) {
+        using list_type = remove_reference_t<decltype(expr->value.values)>;
+        return filter(snapshot, sel, is_in<list_type, false>{ expr->value.values });
+    }
+    template<class expr_type>
+    static bool apply(column_snapshot const & snapshot, selection & sel, expr_type const * const expr, condition_t<condition::LESS>) {
+        return filter(snapshot, sel, is_less<sortorder::ASC>{ static_cast<val_type const &>(expr->value.values) });
+    }
+    template<class expr_type>
+    static bool apply(column_snapshot const & snapshot, selection & sel, expr_type const * const expr, condition_t<condition::GREATER>) {
+        return filter(snapshot, sel, is_less<sortorder::DESC>{ static_cast<val_type const &>(expr->value.values) });
+    }
+    template<class expr_type>
+    static bool apply(column_snapshot const & snapshot, selection & sel, expr_type const * const expr, condition_t<condition::LESS_EQ>) {
+        return filter(snapshot, sel, is_less_eq<sortorder::ASC>{ static_cast<val_type const &>(expr->value.values) });
+    }
+    template<class expr_type>
+    static bool apply(column_snapshot const & snapshot, selection & sel, expr_type const * const expr, condition_t<condition::GREATER_EQ>) {
+        return filter(snapshot, sel, is_less_eq<sortorder::DESC>{ static_cast<val_type const &>(expr->value.values) });
+    }
+    template<class expr_type>
+    static bool apply(column_snapshot const & snapshot, selection & sel, expr_type const * const expr, condition_t<condition::BETWEEN>) {
+        return filter(snapshot, sel, is_between{
+            static_cast<val_type const &>(expr->value.values.first),
+            static_cast<val_type const &>(expr->value.values.second) });
+    }
+    template<class expr_type>
+    static bool apply(column_snapshot const & snapshot, selection & sel, expr_type const *, condition_t<condition::IS_NULL>) {
+        const int i = find_column(snapshot, false);
+        if (i < 0) {
+            return false;
+        }
+        snapshot.filter_null(static_cast<size_t>(i), sel, T::type::value);
+        return true;
+    }
+public:
+    template<class sub_expr_type> // returns false if condition is not evaluated
+    static bool apply(column_snapshot const & snapshot, selection & sel, sub_expr_type const & expr) {
+        return apply(snapshot, sel, expr.get(Size2Type<T::offset>()), condition_t<T::type::cond>{});
+    }
+};
+
+template<class TList> struct SNAPSHOT_OR;
+template<> struct SNAPSHOT_OR<NullType>
+{
+    template<class sub_expr_type> static
+    bool apply(column_snapshot const &, column_snapshot::selection &, sub_expr_type const &) {
+        return true;
+    }
+};
+
+template<class T, class NextType>
+struct SNAPSHOT_OR<Typelist<T, NextType>> // T = SEARCH_WHERE
+{
+    template<class sub_expr_type> static // result |= rows of condition, false if any condition is not evaluated
+    bool apply(column_snapshot const & snapshot, column_snapshot::selection & result, sub_expr_type const & expr) {
+        column_snapshot::selection sel = snapshot.select_all();
+        if (!SNAPSHOT_CONDITION<T>::apply(snapshot, sel, expr)) {
+            return false;
+        }
+        for (size_t i = 0; i < sel.size(); ++i) {
+            result[i] |= sel[i];
+        }
+        return SNAPSHOT_OR<NextType>::apply(snapshot, result, expr);
+    }
+};
+
+template<class TList> struct SNAPSHOT_AND;
+template<> struct SNAPSHOT_AND<NullType>
+{
+    template<class sub_expr_type> static
+    size_t apply(column_snapshot const &, column_snapshot::selection &, sub_expr_type const &) {
+        return 0;
+    }
+};
+
+template<class T, class NextType>
+struct SNAPSHOT_AND<Typelist<T, NextType>> // T = SEARCH_WHERE
+{
+    template<class sub_expr_type> static // returns number of evaluated conditions
+    size_t apply(column_snapshot const & snapshot, column_snapshot::selection & result, sub_expr_type const & expr) {
+        const size_t n = SNAPSHOT_CONDITION<T>::apply(snapshot, result, expr) ? 1 : 0;
+        return n + SNAPSHOT_AND<NextType>::apply(snapshot, result, expr);
+    }
+};
+
+// selects rows of snapshot which can satisfy sub_expr; selected records are checked again with all conditions;
+// returns false if no condition is evaluated with snapshot (records are scanned from database)
+template<class sub_expr_type>
+struct SNAPSHOT_SELECT : is_static {
+private:
+    using SEARCH = typename SELECT_SEARCH_TYPE<sub_expr_type>::Result;
+    using search_AND = search_operator_t<operator_::AND, SEARCH>;
+    using search_OR = search_operator_t<operator_::OR, SEARCH>;
+public:
+    static bool select(column_snapshot::selection & result, column_snapshot const & snapshot, sub_expr_type const & expr) {
+        bool applied = false;
+        result = snapshot.select_none();
+        if (!TL::IsEmpty<search_OR>::value && SNAPSHOT_OR<search_OR>::apply(snapshot, result, expr)) {
+            applied = true;
+        }
+        else {
+            result = snapshot.select_all();
+        }
+        if (SNAPSHOT_AND<search_AND>::apply(snapshot, result, expr)) {
+            applied = true;
+        }
+        return applied;
+    }
+};
+
+// seeks non-clustered index of table (see database::find_secondary_index) with first key column in condition;
+// index scan skips rows with NULL key, but record reads NULL of fixed column as empty value (zero),
+// so index is not used if range of condition contains empty value (records are scanned)
+template<class T, bool = !std::is_void<typename T::col>::value>
+struct SECONDARY_CONDITION;
+
+template<class T> // condition without column, e.g. lambda
+struct SECONDARY_CONDITION<T, false> : is_static {
+    template<class query_type>
+    static shared_secondary_index find(query_type const &) {
+        return {};
+    }
+    template<class sub_expr_type>
+    static bool use_index(sub_expr_type const &) {
+        return false;
+    }
+    template<class query_type, class sub_expr_type>
+    static void apply(query_type const &, secondary_index const &, typename query_type::bookmark_range &, sub_expr_type const &, size_t) {
+        SDL_ASSERT(0);
+    }
+};
+
+template<class T> // T = SEARCH_WHERE
+struct SECONDARY_CONDITION<T, true> : is_static {
+private:
+    using col = typename T::col;
+    using val_type = typename col::val_type;
+    enum { is_number = col::fixed && std::is_arithmetic<val_type>::value };
+    enum { is_seek = where_::is_condition_index<T::cond>::value && (T::cond != condition::NOT) };
+    enum { value = is_number && is_seek && (index_hint<typename T::type>::hint != where_::INDEX::IGNORE) };
+
+    struct value_range { // values from first to last, nullptr if not bounded
+        val_type const * first;
+        val_type const * last;
+        bool first_eq;
+        bool last_eq;
+    };
+    using value_ranges = std::vector<value_range>; // ranges do not overlap
+    static val_type read(mem_range_t const & m) {
+        SDL_ASSERT(mem_size(m) == sizeof(val_type));
+        val_type x;
+        memcpy(&x, m.first, sizeof(x));
+        return x;
+    }
+    static bool below(val_type const & x, value_range const & r) {
+        return r.first && (r.first_eq ? (x < *r.first) : !(*r.first < x));
+    }
+    static bool above(val_type const & x, value_range const & r) {
+        return r.last && (r.last_eq ? (*r.last < x) : !(x < *r.last));
+    }
+    static bool has_empty(value_ranges const & ranges) {
+        const val_type empty{};
+        for (auto const & r : ranges) {
+            if (!(below(empty, r) || above(empty, r))) {
+                return true;
+            }
+        }
+        return false;
+    }
+    template<class query_type>
+    static void seek(query_type const & query, secondary_index const & index,
+        typename query_type::bookmark_range & result, value_range const & r, size_t const limit) {
+        const bool desc = index.layout().descending;
+        query.seek_secondary(index, result,
+            [&r, desc](mem_range_t const & m) {
+                return desc ? above(read(m), r) : below(read(m), r);
+            },
+            [&r, desc](mem_range_t const & m) {
+                return desc ? below(read(m), r) : above(read(m), r);
+            }, limit);
+    }
+    template<class query_type>
+    static shared_secondary_index find(query_type const &, std::false_type) {
+        return {};
+    }
+    template<class query_type>
+    static shared_secondary_index find(query_type const & query, std::true_type) {
+        if (auto p = query.template find_secondary_index<col>()) {
+            if (((*p)[0].type == col::type) && ((*p)[0].fixed_size() == sizeof(val_type))) {
+                return p;
+            }
+        }
+        return {};
+    }
+    template<class sub_expr_type>
+    static value_ranges make_ranges(sub_expr_type const & expr) {
+        value_ranges result;
+        make_ranges(result, expr.get(Size2Type<T::offset>()), condition_t<T::type::cond>{});
+        return result;
+    }
+    template<class expr_type, condition cond>
+    static void make_ranges(value_ranges &, expr_type const *, condition_t<cond>) {
+        SDL_ASSERT(0);
+    }
+    template<class expr_type>
+    static void make_ranges(value_ranges & result, expr_type const * const expr, condition_t<condition::WHERE>) {
+        val_type const & v = expr->value.values;
+        result.push_back(value_range{ &v, &v, true, true });
+    }
+    template<class expr_type>
+    static void make_ranges(value_ranges & result, expr_type const * const expr, condition_t<condition::IN>) {
+        for (auto const & v : expr->value.values) {
+            val_type const & x = static_cast<val_type const &>(v);
+            result.push_back(value_range{ &x, &x, true, true });
+        }
+        std::sort(result.begin(), result.end(), [](value_range const & x, value_range const & y) {
+            return *x.first < *y.first;
+        });
+        result.erase(std::unique(result.begin(), result.end(), [](value_range const & x, value_range const & y) {
+            return !(*x.first < *y.first) && !(*y.first < *x.first);
+        }), result.end()); // duplicate values of IN are seeked once
+    }
+    template<class expr_type>
+    static void make_ranges(value_ranges & result, expr_type const * const expr, condition_t<condition::LESS>) {
+        result.push_back(value_range{ nullptr, &static_cast<val_type const &>(expr->value.values), false, false });
+    }
+    template<class expr_type>
+    static void make_ranges(value_ranges & result, expr_type const * const expr, condition_t<condition::LESS_EQ>) {
+        result.push_back(value_range{ nullptr, &static_cast<val_type const &>(expr->value.values), false, true });
+    }
+    template<class expr_type>
+    static void make_ranges(value_ranges & result, expr_type const * const expr, condition_t<condition::GREATER>) {
+        result.push_back(value_range{ &static_cast<val_type const &>(expr->value.values), nullptr, false, false });
+    }
+    template<class expr_type>
+    static void make_ranges(value_ranges & result, expr_type const * const expr, condition_t<condition::GREATER_EQ>) {
+        result.push_back(value_range{ &static_cast<val_type const &>(expr->value.values), nullptr, true, false });
+    }
+    template<class expr_type>
+    static void make_ranges(value_ranges & result, expr_type const * const expr, condition_t<condition::BETWEEN>) {
+        result.push_back(value_range{
+            &static_cast<val_type const &>(expr->value.values.first),
+            &static_cast<val_type const &>(expr->value.values.second), true, true });
+    }
+    template<class sub_expr_type>
+    static bool use_index(sub_expr_type const &, std::false_type) {
+        return false;
+    }
+    template<class sub_expr_type>
+    static bool use_index(sub_expr_type const & expr, std::true_type) {
+        return !has_empty(make_ranges(expr));
+    }
+    template<class query_type, class sub_expr_type>
+    static void apply(query_type const &, secondary_index const &, typename query_type::bookmark_range &,
+        sub_expr_type const &, size_t, std::false_type) {
+        SDL_ASSERT(0);
+    }
+    template<class query_type, class sub_expr_type>
+    static void apply(query_type const & query, secondary_index const & index,
+        typename query_type::bookmark_range & result, sub_expr_type const & expr, size_t const limit, std::true_type) {
+        for (auto const & r : make_ranges(expr)) {
+            seek(query, index, result, r, limit);
+        }
+    }
+public:
+    template<class query_type> // nullptr if condition cannot use index
+    static shared_secondary_index find(query_type const & query) {
+        return find(query, bool_constant<value>());
+    }
+    template<class sub_expr_type> // false if range of condition contains empty value (NULL key)
+    static bool use_index(sub_expr_type const & expr) {
+        return use_index(expr, bool_constant<value>());
+    }
+    // appends bookmarks of rows in range of condition, bookmarks are unique;
+    // index is not read after result has limit bookmarks (0 = no limit)
+    template<class query_type, class sub_expr_type>
+    static void apply(query_type const & query, secondary_index const & index,
+        typename query_type::bookmark_range & result, sub_expr_type const & expr, size_t const limit) {
+        SDL_ASSERT(use_index(expr));
+        apply(query, index, result, expr, limit, bool_constant<value>());
+    }
+};
+
+template<class TList> struct SECONDARY_AND;
+template<> struct SECONDARY_AND<NullType>
+{
+    template<class query_type, class sub_expr_type> static
+    bool apply(query_type const &, typename query_type::bookmark_range &, sub_expr_type const &, size_t) {
+        return false;
+    }
+    template<class query_type, class sub_expr_type> static
+    bool explain(query_type const &, sub_expr_type const &, std::vector<std::string> &) {
+        return false;
+    }
+};
+
+template<class T, class NextType>
+struct SECONDARY_AND<Typelist<T, NextType>> // T = SEARCH_WHERE
+{
+    template<class query_type, class sub_expr_type> static // first condition with index is used
+    bool apply(query_type const & query, typename query_type::bookmark_range & result, sub_expr_type const & expr, size_t const limit) {
+        if (SECONDARY_CONDITION<T>::use_index(expr)) {
+            if (auto const index = SECONDARY_CONDITION<T>::find(query)) {
+                SECONDARY_CONDITION<T>::apply(query, *index, result, expr, limit);
+                return true;
+            }
+        }
+        return SECONDARY_AND<NextType>::apply(query, result, expr, limit);
+    }
+    template<class query_type, class sub_expr_type> static
+    bool explain(query_type const & query, sub_expr_type const & expr, std::vector<std::string> & seek) {
+        if (SECONDARY_CONDITION<T>::use_index(expr) && SECONDARY_CONDITION<T>::find(query)) {
+            explain_::search_where_name name(seek);
+            name(identity<T>());
+            return true;
+        }
+        return SECONDARY_AND<NextType>::explain(query, expr, seek);
+    }
+};
+
+// selects bookmarks of rows with non-clustered index for condition which must be true (AND or single OR);
+// records are checked again with all conditions; returns false if index is not used (records are scanned)
+template<class sub_expr_type>
+struct SECONDARY_SELECT : is_static {
+private:
+    using SEARCH = typename SELECT_SEARCH_TYPE<sub_expr_type>::Result;
+    using search_AND = search_operator_t<operator_::AND, SEARCH>;
+    using search_OR = search_operator_t<operator_::OR, SEARCH>;
+    using search_seek = TL::Append_t<Select_t<TL::Length<search_OR>::value == 1, search_OR, NullType>, search_AND>;
+public:
+    // TOP of query limits bookmarks if condition of seek is the only condition (every bookmark is selected)
+    enum { is_single = (TL::Length<SEARCH>::value == 1) };
+    template<class query_type>
+    static bool select(typename query_type::bookmark_range & result, query_type const & query, sub_expr_type const & expr,
+        size_t const limit = 0) {
+        return SECONDARY_AND<search_seek>::apply(query, result, expr, is_single ? limit : 0);
+    }
+    template<class query_type>
+    static void explain(query_plan & plan, query_type const & query, sub_expr_type const & expr) {
+        if ((plan.path == access_path::SCAN_TABLE) && !query.snapshot()) {
+            if (SECONDARY_AND<search_seek>::explain(query, expr, plan.seek)) {
+                plan.path = access_path::SEEK_SECONDARY;
+            }
+        }
+    }
+};
+
+//--------------------------------------------------------------
+
 template<class record_range, class query_type, class sub_expr_type, bool is_limit>
 class SCAN_TABLE final : noncopyable {
 
@@ -1011,12 +1496,14 @@ public:
     query_type const &      m_query;
     sub_expr_type const &   m_expr;
     const size_t            m_limit;
+    size_t * const          m_examined; // ANALYZE
 
-    SCAN_TABLE(record_range & result, query_type const & query, sub_expr_type const & expr, size_t lim)
+    SCAN_TABLE(record_range & result, query_type const & query, sub_expr_type const & expr, size_t lim, size_t * examined)
         : m_result(result)
         , m_query(query)
         , m_expr(expr)
         , m_limit(lim)
+        , m_examined(examined)
     {
         SDL_ASSERT(is_limit == (m_limit > 0));
         static_assert(IS_SCAN_TABLE<sub_expr_type>::value, "SCAN_TABLE");
@@ -1026,7 +1513,10 @@ public:
 
 template<class record_range, class query_type, class sub_expr_type, bool is_limit>
 void SCAN_TABLE<record_range, query_type, sub_expr_type, is_limit>::select() {
-    m_query.scan_if([this](record const p){
+    auto fun = [this](record const p){
+        if (m_examined) {
+            ++(*m_examined);
+        }
         if (is_select(p)) {
             auto const push_result = query_type::push_back(m_result, p);
             if (push_result.first == bc::break_) {
@@ -1036,7 +1526,22 @@ void SCAN_TABLE<record_range, query_type, sub_expr_type, is_limit>::select() {
                 return false;
         }
         return true;
-    });
+    };
+    if (auto const snapshot = m_query.snapshot()) {
+        column_snapshot::selection sel;
+        if (SNAPSHOT_SELECT<sub_expr_type>::select(sel, *snapshot, m_expr)) {
+            m_query.scan_selection(*snapshot, sel, fun);
+            return;
+        }
+    }
+    else {
+        typename query_type::bookmark_range bookmarks;
+        if (SECONDARY_SELECT<sub_expr_type>::select(bookmarks, m_query, m_expr, m_limit)) {
+            m_query.fetch_bookmarks(bookmarks, fun);
+            return;
+        }
+    }
+    m_query.scan_if(fun);
 }
 
 } // make_query_
@@ -1051,7 +1556,7 @@ class make_query<this_table, _record>::seek_table final : is_static
     using col_type = typename query_type::T0_col;
     using value_type = typename query_type::T0_type;
 
-    static_assert(query_type::index_size, "seek_table need index_size");
+    static_assert(query_type::index_size != 0, "seek_table need index_size");
 
     enum { is_composite = query_type::index_size > 1 };
 
@@ -1077,6 +1582,14 @@ class make_query<this_table, _record>::seek_table final : is_static
         }
     };
 
+    template<sortorder ord> // end of range for LESS
+    static page_slot end_slot(query_type const & query, value_type const & v, identity<is_less<ord>>) {
+        return query.lower_bound(v).first;
+    }
+    template<sortorder ord> // end of range for LESS_EQ
+    static page_slot end_slot(query_type const & query, value_type const & v, identity<is_less_eq<ord>>) {
+        return query.upper_bound(v);
+    }
     template<class expr_type, class fun_type, class less_type> static
     break_or_continue scan_less(query_type const &, expr_type const *, fun_type &&, identity<less_type>);
 
@@ -1168,52 +1681,27 @@ template<class this_table, class _record>
 template<class expr_type, class fun_type, class less_type> break_or_continue
 make_query<this_table, _record>::seek_table::scan_less(query_type const & query, expr_type const * const expr, fun_type && fun, identity<less_type>)
 {
-    break_or_continue result = bc::continue_;
-    query.scan_if([&result, &fun, expr](record const & p){
-        if (less_type::apply(p, expr->value.values)) {
-            return bc::continue_ == (result = fun(p));
-        }
-        return false;
-    });
-    return result;
+    return query.scan_range(query.first_slot(), 
+        end_slot(query, expr->value.values, identity<less_type>{}), fun);
 }
 
 template<class this_table, class _record> 
 template<class expr_type, class fun_type> break_or_continue
 make_query<this_table, _record>::seek_table::scan_greater(query_type const & query, expr_type const * const expr, fun_type && fun)
 {
-    break_or_continue result = bc::continue_;
-    auto found = query.lower_bound(expr->value.values);
-    if (found.first.page) {
-        if (found.second) { // skip equal values
-            found.first = query.scan_next(found.first, [expr](record const & p){
-                return is_equal::apply(p, expr->value.values);
-            });
-        }
-        if (found.first.page) {
-            SDL_ASSERT(is_less<invert_sortorder<col_type::order>::value>::apply
-                (query.get_record(found.first), expr->value.values));
-            query.scan_next(found.first, [&result, &fun](record const & p){
-                return bc::continue_ == (result = fun(p));
-            });
-        }
-    }
-    return result;
+    const page_slot first = query.upper_bound(expr->value.values);
+    SDL_ASSERT(!first.page || is_less<invert_sortorder<col_type::order>::value>::apply
+        (query.get_record(first), expr->value.values));
+    return query.scan_range(first, page_slot(), fun);
 }
 
 template<class this_table, class _record> 
 template<class expr_type, class fun_type> break_or_continue
 make_query<this_table, _record>::seek_table::scan_greater_eq(query_type const & query, expr_type const * const expr, fun_type && fun)
 {
-    break_or_continue result = bc::continue_;
-    auto found = query.lower_bound(expr->value.values);
-    if (found.first.page) {
-        SDL_ASSERT(is_less_eq<invert_sortorder<col_type::order>::value>::apply(query.get_record(found.first), expr->value.values));
-        query.scan_next(found.first, [&result, &fun](record const & p){
-            return bc::continue_ == (result = fun(p));
-        });
-    }
-    return result;
+    const page_slot first = query.lower_bound(expr->value.values).first;
+    SDL_ASSERT(!first.page || is_less_eq<invert_sortorder<col_type::order>::value>::apply(query.get_record(first), expr->value.values));
+    return query.scan_range(first, page_slot(), fun);
 }
 
 //--------------------------------------------------------------------------------
@@ -1286,34 +1774,18 @@ template<class this_table, class _record>
 template<class expr_type, class fun_type> inline break_or_continue
 make_query<this_table, _record>::seek_table::scan_between(query_type const & query, expr_type const * const expr, fun_type && fun, sortorder_t<sortorder::ASC>) {
     static_assert(col_type::order == sortorder::ASC, "");
-    break_or_continue result = bc::continue_;
-    auto found = query.lower_bound(expr->value.values.first);
-    if (found.first.page) {
-        query.scan_next(found.first, [&result, expr, &fun](record const & p){
-            if (is_less_eq<sortorder::ASC>::apply(p, expr->value.values.second)) {
-                return bc::continue_ == (result = fun(p));
-            }
-            return false;
-        });
-    }
-    return result;
+    return query.scan_range(
+        query.lower_bound(expr->value.values.first).first,
+        query.upper_bound(expr->value.values.second), fun);
 }
 
 template<class this_table, class _record> 
 template<class expr_type, class fun_type> break_or_continue
 make_query<this_table, _record>::seek_table::scan_between(query_type const & query, expr_type const * const expr, fun_type && fun, sortorder_t<sortorder::DESC>) {
     static_assert(col_type::order == sortorder::DESC, "");
-    break_or_continue result = bc::continue_;
-    auto found = query.lower_bound(expr->value.values.second);
-    if (found.first.page) {
-        query.scan_next(found.first, [&result, expr, &fun](record const & p){
-            if (is_less_eq<sortorder::DESC>::apply(p, expr->value.values.first)) {
-                return bc::continue_ == (result = fun(p));
-            }
-            return false;
-        });
-    }
-    return result;
+    return query.scan_range(
+        query.lower_bound(expr->value.values.second).first,
+        query.upper_bound(expr->value.values.first), fun);
 }
 
 //--------------------------------------------------------------------------------
@@ -1349,7 +1821,9 @@ make_query<this_table, _record>::seek_table::scan_if(query_type const & query, e
 template<class this_table, class _record> 
 template<class expr_type, class fun_type, class T> inline break_or_continue
 make_query<this_table, _record>::seek_table::scan_if(query_type const & query, expr_type const * const expr, fun_type && fun, identity<T>, condition_t<condition::BETWEEN>) {
-    SDL_ASSERT(!(expr->value.values.second < expr->value.values.first));
+    if (expr->value.values.second < expr->value.values.first) { // empty range, upper_bound may precede lower_bound
+        return bc::continue_;
+    }
     return scan_between(query, expr, fun, sortorder_t<col_type::order>{});
 }
 
@@ -1374,12 +1848,16 @@ class make_query<this_table, _record>::seek_spatial final : is_static
         return bc::break_;
     }
     template<class T, class expr_type>
-    static bool STIntersects(expr_type const * const expr, record const & p, where_::intersect_hint_t<where_::intersect_hint::precise>) {
+    static bool STIntersects(query_type const & query, spatial_page_row const * const row, expr_type const * const expr,
+        record const & p, where_::intersect_hint_t<where_::intersect_hint::precise>) {
         static_assert(T::type::inter == where_::intersect_hint::precise, "");
-        return p.val(identity<typename T::col>{}).STIntersects(expr->value.values);
+        return query.template geography_if<typename T::col>(p, row->data.pk0, [expr](geo_mem const & geo) {
+            return geo.STIntersects(expr->value.values);
+        });
     } 
     template<class T, class expr_type>
-    static bool STIntersects(expr_type const *, record const &, where_::intersect_hint_t<where_::intersect_hint::fast>) {
+    static bool STIntersects(query_type const &, spatial_page_row const *, expr_type const *,
+        record const &, where_::intersect_hint_t<where_::intersect_hint::fast>) {
         static_assert(T::type::inter == where_::intersect_hint::fast, "");
         return true;
     }
@@ -1418,8 +1896,10 @@ make_query<this_table, _record>::seek_spatial::scan_if(query_type const & query,
                     if (row->cell_cover()) {
                         return seek_spatial::find_record(row, query, fun);
                     }
-                    return seek_spatial::find_record(row, query, [expr, &fun](record const & p){
-                        if (p.val(identity<typename T::col>{}).STContains(expr->value.values)) {
+                    return seek_spatial::find_record(row, query, [&query, row, expr, &fun](record const & p){
+                        if (query.template geography_if<typename T::col>(p, row->data.pk0, [expr](geo_mem const & geo) {
+                            return geo.STContains(expr->value.values);
+                        })) {
                            return fun(p);
                         }
                         return bc::continue_;
@@ -1445,8 +1925,8 @@ make_query<this_table, _record>::seek_spatial::scan_if(query_type const & query,
                     if (row->cell_cover()) {
                         return seek_spatial::find_record(row, query, fun);
                     }
-                    return seek_spatial::find_record(row, query, [expr, &fun](record const & p){
-                        if (seek_spatial::STIntersects<T>(expr, p, where_::intersect_hint_t<T::type::inter>())) {
+                    return seek_spatial::find_record(row, query, [&query, row, expr, &fun](record const & p){
+                        if (seek_spatial::STIntersects<T>(query, row, expr, p, where_::intersect_hint_t<T::type::inter>())) {
                             return fun(p);
                         }
                         return bc::continue_;
@@ -1535,12 +2015,14 @@ public:
     query_type const &      m_query;
     sub_expr_type const &   m_expr;
     const size_t            m_limit;
+    size_t * const          m_examined; // ANALYZE
 
-    SEEK_TABLE(record_range & result, query_type const & query, sub_expr_type const & expr, size_t const lim)
+    SEEK_TABLE(record_range & result, query_type const & query, sub_expr_type const & expr, size_t const lim, size_t * examined)
         : m_result(result)
         , m_query(query)
         , m_expr(expr)
         , m_limit(lim)
+        , m_examined(examined)
     {
         SDL_ASSERT(is_limit == (m_limit > 0));
         static_assert(IS_SEEK_TABLE<sub_expr_type>::use_index, "SEEK_TABLE");
@@ -1567,9 +2049,16 @@ template<class expr_type, class T> inline // T = SEARCH_WHERE
 bool SEEK_TABLE<record_range, query_type, sub_expr_type, is_limit>::seek_with_index(expr_type const * const expr, identity<T>)
 {
     return query_type::seek_table::scan_if(m_query, expr, [this](record const p) {
+        if (m_examined) {
+            ++(*m_examined);
+        }
         if (is_select(p, operator_t<T::OP>{})) { // check other part of condition 
             A_STATIC_ASSERT_NOT_TYPE(void, typename key_type::this_clustered);
-            if (query_type::push_unique(m_result, p) && has_limit(bool_constant<is_limit>{})) {
+            auto const push_result = make_break_or_continue_bool(query_type::push_unique(m_result, p));
+            if (push_result.first == bc::break_) {
+                return bc::break_;
+            }
+            if (push_result.second && has_limit(bool_constant<is_limit>{})) {
                 return bc::break_;
             }
         }
@@ -1623,12 +2112,14 @@ public:
     query_type const &      m_query;
     sub_expr_type const &   m_expr;
     const size_t            m_limit;
+    size_t * const          m_examined; // ANALYZE
 
-    SEEK_SPATIAL(record_range & result, query_type const & query, sub_expr_type const & expr, size_t const lim)
+    SEEK_SPATIAL(record_range & result, query_type const & query, sub_expr_type const & expr, size_t const lim, size_t * examined)
         : m_result(result)
         , m_query(query)
         , m_expr(expr)
         , m_limit(lim)
+        , m_examined(examined)
     {
         SDL_ASSERT(is_limit == (m_limit > 0));
         static_assert(IS_SEEK_TABLE<sub_expr_type>::spatial_index, "SEEK_SPATIAL");
@@ -1655,6 +2146,9 @@ template<class expr_type, class T> inline // T = SEARCH_WHERE
 bool SEEK_SPATIAL<record_range, query_type, sub_expr_type, is_limit>::seek_with_index(expr_type const * const expr, identity<T>)
 {
     return query_type::seek_spatial::scan_if(m_query, expr, [this](record const p) {
+        if (m_examined) {
+            ++(*m_examined);
+        }
         if (is_select(p, operator_t<T::OP>{})) { // check other part of condition 
             A_STATIC_ASSERT_NOT_TYPE(void, typename key_type::this_clustered);
             auto const push_result = make_break_or_continue_bool(query_type::push_unique(m_result, p));
@@ -1694,12 +2188,12 @@ private:
     }
 public:
     template<class record_range, class query_type> static
-    void select(record_range & result, query_type const & query, sub_expr_type const & expr);
+    void select(record_range & result, query_type const & query, sub_expr_type const & expr, size_t * examined = nullptr);
 };
 
 template<class sub_expr_type, class TOP>
 template<class record_range, class query_type> inline
-void SCAN_OR_SEEK<sub_expr_type, TOP>::select(record_range & result, query_type const & query, sub_expr_type const & expr)
+void SCAN_OR_SEEK<sub_expr_type, TOP>::select(record_range & result, query_type const & query, sub_expr_type const & expr, size_t * const examined)
 {
     using scan_table_type = SCAN_TABLE<record_range, query_type, sub_expr_type, is_limit>;
     using seek_table_type = SEEK_TABLE<record_range, query_type, sub_expr_type, is_limit>;
@@ -1711,7 +2205,7 @@ void SCAN_OR_SEEK<sub_expr_type, TOP>::select(record_range & result, query_type
     using select_table =
         Select_t<seek_sub_expr::spatial_index, seek_spatial_type, 
         Select_t<seek_sub_expr::use_index, seek_table_type, scan_table_type>>;
-    select_table(result, query, expr, limit(expr)).select();
+    select_table(result, query, expr, limit(expr), examined).select();
 }
 
 //--------------------------------------------------------------
@@ -1723,12 +2217,15 @@ struct QUERY_VALUES
     static_assert(TL::Length<ORDER>::value, "ORDER");
 
     template<class record_range, class query_type> static
-    void select(record_range & result, query_type const & query, sub_expr_type const & expr) {
+    void select(record_range & result, query_type const & query, sub_expr_type const & expr, query_stats * const stats = nullptr) {
         //FIXME: can be optimized for some cases
-        SCAN_OR_SEEK<sub_expr_type>::select(result, query, expr);
+        explain_::operator_timer timer(stats);
+        SCAN_OR_SEEK<sub_expr_type>::select(result, query, expr, timer.examined());
+        timer.select_done();
         SORT_RECORD_RANGE<ORDER>::sort(result, query, expr);
         result.resize(a_min(SELECT_TOP(expr), result.size()));
         result.shrink_to_fit();
+        timer.sort_done();
     }
 };
 
@@ -1736,8 +2233,10 @@ template<class sub_expr_type>
 struct QUERY_VALUES<sub_expr_type, NullType, NullType>
 {
     template<class record_range, class query_type> static
-    void select(record_range & result, query_type const & query, sub_expr_type const & expr) {
-       SCAN_OR_SEEK<sub_expr_type>::select(result, query, expr);
+    void select(record_range & result, query_type const & query, sub_expr_type const & expr, query_stats * const stats = nullptr) {
+        explain_::operator_timer timer(stats);
+        SCAN_OR_SEEK<sub_expr_type>::select(result, query, expr, timer.examined());
+        timer.select_done();
     }
 };
 
@@ -1745,8 +2244,10 @@ template<class sub_expr_type, class TOP>
 struct QUERY_VALUES<sub_expr_type, TOP, NullType>
 {
     template<class record_range, class query_type> static
-    void select(record_range & result, query_type const & query, sub_expr_type const & expr) {
-        SCAN_OR_SEEK<sub_expr_type, TOP>::select(result, query, expr);
+    void select(record_range & result, query_type const & query, sub_expr_type const & expr, query_stats * const stats = nullptr) {
+        explain_::operator_timer timer(stats);
+        SCAN_OR_SEEK<sub_expr_type, TOP>::select(result, query, expr, timer.examined());
+        timer.select_done();
     }
 };
 
@@ -1757,9 +2258,44 @@ private:
     using KEYS = SEARCH_KEY<sub_expr_type>;
 public:
     template<class record_range, class query_type> static
-    void select(record_range & result, query_type const & query, sub_expr_type const & expr) {
-        SCAN_OR_SEEK<sub_expr_type>::select(result, query, expr);
+    void select(record_range & result, query_type const & query, sub_expr_type const & expr, query_stats * const stats = nullptr) {
+        explain_::operator_timer timer(stats);
+        SCAN_OR_SEEK<sub_expr_type>::select(result, query, expr, timer.examined());
+        timer.select_done();
         SORT_RECORD_RANGE<ORDER>::sort(result, query, expr);
+        timer.sort_done();
+    }
+};
+
+template<class sub_expr_type>
+struct QUERY_PLAN : is_static {
+private:
+    using seek_sub_expr = IS_SEEK_TABLE<sub_expr_type>;
+    using KEYS = SEARCH_KEY<sub_expr_type>;
+    using TOP = typename SELECT_TOP_TYPE<sub_expr_type>::Result;
+    using ORDER = typename SELECT_ORDER_TYPE<sub_expr_type>::Result;
+    using seek_keys = Select_t<TL::IsEmpty<typename KEYS::key_AND_0>::value, typename KEYS::key_OR_0, typename KEYS::key_AND_0>;
+    using spatial_keys = Select_t<TL::IsEmpty<typename KEYS::spatial_AND>::value, typename KEYS::spatial_OR, typename KEYS::spatial_AND>;
+    using keylist = Select_t<seek_sub_expr::spatial_index, spatial_keys,
+                    Select_t<seek_sub_expr::use_index, seek_keys, NullType>>;
+    static size_t top(sub_expr_type const &, identity<NullType>) {
+        return 0;
+    }
+    template<class T> static size_t top(sub_expr_type const & expr, identity<T>) {
+        return SELECT_TOP(expr);
+    }
+public:
+    static query_plan make(sub_expr_type const & expr) { // same choice as SCAN_OR_SEEK
+        query_plan plan;
+        plan.path =
+            seek_sub_expr::spatial_index ? access_path::SEEK_SPATIAL :
+            seek_sub_expr::use_index ? access_path::SEEK_TABLE :
+            access_path::SCAN_TABLE;
+        plan.top = top(expr, identity<TOP>());
+        plan.order = !TL::IsEmpty<ORDER>::value;
+        meta::processor_if<keylist>::apply(explain_::search_where_name(plan.seek));
+        meta::processor_if<typename sub_expr_type::type_list>::apply(explain_::condition_name(plan.conditions));
+        return plan;
     }
 };
 
@@ -1794,28 +2330,42 @@ make_query<this_table, record>::VALUES(sub_expr_type const & expr) const
 }
 
 template<class this_table, class record>
-template<class sub_expr_type> size_t
-make_query<this_table, record>::COUNT(sub_expr_type const & expr) const // FIXME: not optimized
+template<class sub_expr_type>
+query_plan make_query<this_table, record>::EXPLAIN(sub_expr_type const & expr) const
 {
     using namespace make_query_;
     static_assert(CHECK_INDEX<sub_expr_type>::value, "");
     static_assert(CHECK_COLUMN<this_table, sub_expr_type>::value, "");
+    query_plan plan = QUERY_PLAN<sub_expr_type>::make(expr);
+    SECONDARY_SELECT<sub_expr_type>::explain(plan, *this, expr);
+    return plan;
+}
 
-#if SDL_DEBUG_QUERY
-    SDL_TRACE_QUERY("\nVALUES:");
-    where_::trace_::trace_sub_expr(expr);
-    SDL_TRACE_QUERY("\n------");
-#endif
+template<class this_table, class record>
+template<class sub_expr_type>
+typename make_query<this_table, record>::record_range
+make_query<this_table, record>::ANALYZE(sub_expr_type const & expr, query_stats & stats) const
+{
+    using namespace make_query_;
+    static_assert(CHECK_INDEX<sub_expr_type>::value, "");
+    static_assert(CHECK_COLUMN<this_table, sub_expr_type>::value, "");
     using TOP = typename SELECT_TOP_TYPE<sub_expr_type>::Result;
     using ORDER = typename SELECT_ORDER_TYPE<sub_expr_type>::Result;
 
-#if SDL_DEBUG_QUERY
-    SDL_TRACE("IS_SCAN_TABLE = ", IS_SCAN_TABLE<sub_expr_type>::value);
-    SDL_TRACE("ORDER = ", TL::Length<ORDER>::value);
-#endif
+    stats = query_stats();
+    stats.plan = QUERY_PLAN<sub_expr_type>::make(expr);
+    SECONDARY_SELECT<sub_expr_type>::explain(stats.plan, *this, expr);
+    database const * const db = m_table.get_db();
+    const size_t block_read = db->pool_block_read();
     record_range result;
-    QUERY_VALUES<sub_expr_type, TOP, ORDER>::select(result, *this, expr); 
-    return result.size(); 
+    {
+        database::scoped_page_count pages;
+        QUERY_VALUES<sub_expr_type, TOP, ORDER>::select(result, *this, expr, &stats);
+        stats.pages = pages.count();
+    }
+    stats.pool_misses = db->pool_block_read() - block_read;
+    stats.rows_returned = result.size();
+    return result;
 }
 
 template<class this_table, class record>
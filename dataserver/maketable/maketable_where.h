@@ -5,6 +5,7 @@
 #define __SDL_SYSTEM_MAKETABLE_WHERE_H__
 
 #include "dataserver/spatial/spatial_type.h"
+#include "dataserver/maketable/maketable_group.h"
 
 #if 0 //defined(SDL_OS_WIN32)
 #pragma warning(disable: 4503) //decorated name length exceeded, name was truncated
@@ -43,10 +44,6 @@ enum class condition {
     _end
 };
 
-//TODO: SELECT DISTINCT
-//TODO: SELECT GROUP BY
-//TODO: SELECT INNER JOIN
-//TODO: SELECT AS => tuple(columns)
 //TODO: Geography::UnionAggregate()
 //TODO: WHERE @build.STContains(Geoinfo) = 1;
 //TODO: STDistance<Geoinfo> && ORDER_BY<Geoinfo> => STDistanceASC<Geoinfo>
@@ -429,9 +426,10 @@ template<class T, INDEX h = INDEX::AUTO> using LESS_EQ     = SEARCH<condition::L
 template<class T, INDEX h = INDEX::AUTO> using GREATER_EQ  = SEARCH<condition::GREATER_EQ, T, T::is_array, h>;
 template<class T, INDEX h = INDEX::AUTO> using BETWEEN     = SEARCH<condition::BETWEEN,    T, T::is_array, h>;
 
-template<class F>
+template<class F, bool concurrent = false>
 struct SELECT_IF {
     static constexpr condition cond = condition::lambda;
+    static constexpr bool is_concurrent = concurrent;
     using value_type = F;
     value_type value;
     using col = void;
@@ -448,6 +446,13 @@ SELECT_IF<fun_type> IF(fun_type && f) {
     return SELECT_IF<fun_type>(std::forward<fun_type>(f));
 }
 
+// thread-safe lambda : full scan of COUNT, GROUP_BY, DISTINCT, SELECT_AS, AGGREGATE
+// can be split between worker threads (with IF lambda scan runs in calling thread)
+template<class fun_type> inline
+SELECT_IF<fun_type, true> IF_CONCURRENT(fun_type && f) {
+    return SELECT_IF<fun_type, true>(std::forward<fun_type>(f));
+}
+
 template<class T, sortorder ord, scalartype::type col_type> // T = col::
 struct ORDER_BY_col {
     static_assert(ord != sortorder::NONE, "ORDER_BY");
@@ -960,10 +965,10 @@ public:
     }
 };
 
-template<class F>
-struct sub_expr_value<where_::SELECT_IF<F>> {
+template<class F, bool concurrent>
+struct sub_expr_value<where_::SELECT_IF<F, concurrent>> {
 private:
-    using param_t = where_::SELECT_IF<F>;
+    using param_t = where_::SELECT_IF<F, concurrent>;
     using value_t = typename param_t::value_type;
 public:
     static constexpr condition cond = param_t::cond;
@@ -1003,9 +1008,22 @@ public:
 
 //------------------------------------------------------------------
 
+template<class left_record, class right_record>
+using join_range = std::vector<std::pair<left_record, right_record>>;
+
+enum { join_memory_budget = megabyte<64>::value }; // hash join build side limit
+
+} // select_
+
+struct query_stats; // maketable_explain.h
+
+namespace select_ {
+
 template<class query_type, class TList, class OList, class next_value, class prev_value>
 struct sub_expr : noncopyable
 {    
+    using query_t = query_type;
+    using record = typename query_type::record;
     using type_list = TList;                            // = Typelist<where_::SEARCH>
     using oper_list = OList;                            // = where_::operator_list
     enum { type_size = TL::Length<type_list>::value };
@@ -1071,6 +1089,53 @@ public:
         static_assert((int)type_size == (int)where_::oper_::length<oper_list>::value, "");
         m_query.for_record(*this, std::forward<fun_type>(fun));
     }
+    auto EXPLAIN() const -> decltype(m_query.EXPLAIN(*this)) { // access path and conditions, query is not executed
+        static_assert((int)type_size == (int)where_::oper_::length<oper_list>::value, "");
+        return m_query.EXPLAIN(*this);
+    }
+    record_range ANALYZE(query_stats & stats) const { // same as VALUES, fills stats
+        static_assert((int)type_size == (int)where_::oper_::length<oper_list>::value, "");
+        return m_query.ANALYZE(*this, stats);
+    }
+    template<class... cols, class... aggs> // cols = col::, aggs = where_::COUNT | SUM | MIN | MAX | AVG
+    group_::group_range<group_::group_key<cols...>, aggs...> GROUP_BY(aggs const &...) const {
+        static_assert((int)type_size == (int)where_::oper_::length<oper_list>::value, "");
+        return m_query.template GROUP_BY<sub_expr, group_::group_key<cols...>, aggs...>(*this);
+    }
+    template<class... cols> // cols = col::
+    std::vector<group_::group_key<cols...>> DISTINCT() const {
+        static_assert((int)type_size == (int)where_::oper_::length<oper_list>::value, "");
+        return m_query.template DISTINCT<sub_expr, group_::group_key<cols...>>(*this);
+    }
+    template<class... cols> // cols = col::, fixed columns only, rows in scan order
+    std::vector<group_::select_row<cols...>> SELECT_AS() const {
+        static_assert((int)type_size == (int)where_::oper_::length<oper_list>::value, "");
+        return m_query.template SELECT_AS<sub_expr, group_::select_row<cols...>>(*this);
+    }
+    template<class... aggs> // aggs = where_::COUNT | SUM | MIN | MAX | AVG
+    group_::aggregate_result<aggs...> AGGREGATE(aggs const &...) const {
+        static_assert(sizeof...(aggs) != 0, "AGGREGATE");
+        static_assert((int)type_size == (int)where_::oper_::length<oper_list>::value, "");
+        return m_query.template AGGREGATE<sub_expr, aggs...>(*this);
+    }
+    // INNER JOIN ON col = right_col; index nested-loop join if right_col is first column
+    // of right table cluster key (INDEX::AUTO or USE), hash join otherwise (or INDEX::IGNORE)
+    template<class col, class right_col, where_::INDEX hint = where_::INDEX::AUTO, class right_expr, class fun_type>
+    void for_join(right_expr const & right, fun_type && fun, size_t const memory_budget = join_memory_budget) const {
+        static_assert((int)type_size == (int)where_::oper_::length<oper_list>::value, "");
+        m_query.template for_join<sub_expr, col, right_col, hint>(*this, right, memory_budget, std::forward<fun_type>(fun));
+    }
+    template<class col, class right_col, where_::INDEX hint = where_::INDEX::AUTO, class right_expr>
+    join_range<record, typename right_expr::record>
+    INNER_JOIN(right_expr const & right, size_t const memory_budget = join_memory_budget) const {
+        using right_record = typename right_expr::record;
+        join_range<record, right_record> result;
+        for_join<col, right_col, hint>(right, [&result](record const & x, right_record const & y) {
+            result.emplace_back(x, y);
+            return true;
+        }, memory_budget);
+        return result;
+    }
 };
 
 template<class query_type>
@@ -4,6 +4,7 @@
 #include "dataserver/maketable/generator.h"
 #include "dataserver/maketable/generator_util.h"
 #include "dataserver/maketable/export_database.h"
+#include "dataserver/maketable/export_table.h"
 #include "dataserver/spatial/geography_info.h"
 #include "dataserver/spatial/interval_cell.h"
 #include "dataserver/spatial/interval_set.h"
@@ -13,11 +14,15 @@
 #include "dataserver/common/time_util.h"
 #include "dataserver/common/thread.h"
 #include "dataserver/utils/conv.h"
+#if defined(SDL_OS_UNIX)
+#include "dataserver/utils/conv_unix.h"
+#endif
 #include "dataserver/system/page_info.h"
 #include <map>
 #include <set>
 #include <fstream>
 #include <iomanip> // for std::setprecision
+#include <random>
 
 #if SDL_BOOST_FOUND && SDL_DEBUG
 #include <boost/optional.hpp>
@@ -68,6 +73,15 @@ struct cmd_option : noncopyable {
     std::string poi_file; //ID, POINT(Lon, Lat)
     size_t test_performance = 0;
     bool test_maketable = false;
+    size_t test_conv = 0; // megabytes
+    bool test_join = false; // index nested loops vs hash join of generated table --tab (SDL_DEBUG_maketable)
+    bool test_row_view = false; // record accessors vs record::view of generated table --tab (SDL_DEBUG_maketable)
+    bool test_faults = false; // page faults of scan and lookup of table --tab for each map_advice
+    std::string export_table; // output file for table --tab
+    std::string export_format = "csv"; // csv, ndjson, columnar
+    bool export_order = false; // write rows in page order
+    std::string make_snapshot; // output columnar snapshot file for table --tab
+    std::string snapshot; // columnar snapshot files attached to database, separated by comma
     bool trace_poi_csv = false;
     double range_meters = 0;
     bool test_for_range = false;
@@ -92,6 +106,12 @@ struct cmd_option : noncopyable {
     size_t max_memory = 0;
     size_t pool_period = 0;
     size_t pool_defrag = 0;
+    size_t init_tables = 0; // 0 : serial, 1 : parallel, 2 : lazy
+    size_t init_threads = 0;
+    size_t map_advice = 0; // 0 : normal, 1 : random, 2 : sequential, 3 : willneed
+    size_t map_populate = 0; // megabytes
+    std::string data_files; // secondary data files separated by comma
+    size_t geo_cache = 0; // megabytes
 };
 
 template<class sys_row>
@@ -735,6 +755,30 @@ void trace_record_value(std::string && s, db::vector_mem_range_t const & vm, db:
     }
 }
 
+// reads max_output characters of variable text column, LOB pages after them are not loaded
+template<class T>
+void trace_text_col(T const & record, size_t const col_index, db::scalartype::type const type,
+                    cmd_option const & opt)
+{
+    const db::lob_reader lob = record.lob_col(col_index);
+    if (lob.empty()) {
+        std::cout << "EMPTY";
+        return;
+    }
+    size_t const char_size = db::scalartype::is_ntext(type) ? sizeof(db::nchar_t) : 1;
+    size_t const max_output = (opt.max_output > 0) ? (size_t)(opt.max_output) : (size_t)(-1);
+    size_t const length = lob.length() / char_size;
+    const db::vector_mem_range_t vm = lob.data(0, a_min(length, max_output) * char_size);
+    std::string s;
+    for (auto const & m : vm) {
+        s.append(m.first, m.second);
+    }
+    trace_string_value(s, vm, type, opt);
+    if (length > max_output) {
+        std::cout << "(" << db::to_string::type(length) << ")";
+    }
+}
+
 template<class T>
 void test_geography(T const & record, size_t col_index)
 {
@@ -757,6 +801,10 @@ void trace_table_record(db::database const &, T const & record, cmd_option const
             std::cout << "NULL";
             continue;
         }
+        if (!col.is_fixed() && (db::scalartype::is_text(col.type) || db::scalartype::is_ntext(col.type))) {
+            trace_text_col(record, col_index, col.type, opt);
+            continue;
+        }
         if (record.data_col(col_index).empty()) {
             std::cout << "EMPTY";
             continue;
@@ -2552,6 +2600,142 @@ bool export_database(cmd_option const & opt)
     return db::make::export_database::make_file(opt.export_database);
 }
 
+void export_table(db::database const & db, cmd_option const & opt)
+{
+    using db::make::export_table;
+    export_table::param_type param;
+    param.out_file = opt.export_table;
+    param.page_order = opt.export_order;
+    if (!export_table::parse_format(param.format, opt.export_format)) {
+        std::cout << "\nexport_format not supported: " << opt.export_format << std::endl;
+        return;
+    }
+    if (auto table = db.find_table(opt.tab_name)) {
+        const export_table::result_type result = export_table::make_file(*table, param);
+        std::cout << "\nexport_table " << table->name()
+            << "\nrows = " << result.rows
+            << "\nbytes = " << result.bytes
+            << "\nseconds = " << (result.milliseconds / 1000.0)
+            << "\nrows/sec = " << result.rows_per_sec()
+            << std::endl;
+    }
+    else {
+        std::cout << "\ntable not found: " << opt.tab_name << std::endl;
+    }
+}
+
+// tables are generated into usertables/maketable_test.h (see --out_file) and compiled with SDL_DEBUG_maketable
+void test_table_benchmark(db::database const & db, cmd_option const & opt)
+{
+#if SDL_DEBUG_maketable
+    using table_list = db::make::database_table_list::type_list;
+    if (!db::make::table_benchmark<table_list>::print(&db, opt.tab_name, opt.test_join, opt.test_row_view, std::cout)) {
+        std::cout << "\ngenerated table not found: " << opt.tab_name << std::endl;
+    }
+#else
+    (void)db;
+    (void)opt;
+    std::cout << "\ntest_join, test_row_view: build with SDL_DEBUG_maketable and generated usertables/maketable_test.h" << std::endl;
+#endif
+}
+
+// page faults of full scan and random page lookups of table for each map_advice and with pages locked in memory;
+// pages of table are dropped from mapping and from page cache (map_advice::evict) before each run,
+// so first access of page is major fault unless file is cached by other process
+void test_faults(db::database const & db, cmd_option const & opt)
+{
+    auto const table = db.find_table(opt.tab_name);
+    if (!table) {
+        std::cout << "\ntable not found: " << opt.tab_name << std::endl;
+        return;
+    }
+    if (db.use_page_bpool()) {
+        std::cout << "\ntest_faults: file mapping is not used with page_bpool" << std::endl;
+        return;
+    }
+    using clock = std::chrono::steady_clock;
+    db::schobj_id const id = table->get_id();
+    std::vector<db::pageFileID> pages;
+    for (db::page_head const * const p : table->get_datapage(db::dataType::type::IN_ROW_DATA, db::pageType::type::data)) {
+        pages.push_back(p->data.pageId);
+    }
+    std::mt19937 gen(0);
+    std::shuffle(pages.begin(), pages.end(), gen);
+    size_t sum = 0;
+    auto run = [&db, id](map_advice const advice, bool const lock, auto && fun) {
+        db.advise_object(id, map_advice::evict);
+        db.advise_object(id, advice);
+        if (lock && !db.lock_object(id, true)) { // pages are read here
+            std::cout << " mlock failed (RLIMIT_MEMLOCK)";
+        }
+        page_faults const before = db::database::get_page_faults();
+        const auto start = clock::now();
+        fun();
+        const double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        page_faults const after = db::database::get_page_faults();
+        std::cout << " minor = " << (after.minor - before.minor)
+            << " major = " << (after.major - before.major)
+            << " ms = " << ms;
+        if (lock) {
+            db.lock_object(id, false);
+        }
+    };
+    static const char * const names[] = { "normal", "random", "sequential", "willneed", "mlock" };
+    std::cout << "\ntest_faults " << table->name() << " pages = " << pages.size();
+    for (size_t i = 0; i < count_of(names); ++i) {
+        bool const lock = (i == count_of(names) - 1); // normal access of locked pages
+        map_advice const advice = lock ? map_advice::normal : static_cast<map_advice>(i);
+        std::cout << "\n" << names[i] << "\n  scan:";
+        run(advice, lock, [&table, &sum]() {
+            for (db::row_head const * const row : table->_head) {
+                sum += row->fixed_size();
+            }
+        });
+        std::cout << "\n  lookup:";
+        run(advice, lock, [&db, &pages, &sum]() {
+            for (db::pageFileID const & p : pages) {
+                sum += db.load_page_head(p)->data.slotCnt;
+            }
+        });
+    }
+    std::cout << "\nchecksum = " << sum << std::endl;
+}
+
+void make_snapshot(db::database const & db, cmd_option const & opt)
+{
+    if (auto table = db.find_table(opt.tab_name)) {
+        using clock = std::chrono::steady_clock;
+        const auto start = clock::now();
+        db::column_snapshot::make_file(*table, opt.make_snapshot);
+        const double seconds = std::chrono::duration<double>(clock::now() - start).count();
+        const db::column_snapshot snapshot(opt.make_snapshot);
+        std::cout << "\nmake_snapshot " << table->name()
+            << "\nrows = " << snapshot.size()
+            << "\ncolumns = " << snapshot.column_count()
+            << "\nbytes = " << snapshot.memory_size()
+            << "\nseconds = " << seconds
+            << std::endl;
+    }
+    else {
+        std::cout << "\ntable not found: " << opt.tab_name << std::endl;
+    }
+}
+
+void attach_snapshot(db::database & db, cmd_option const & opt)
+{
+    for (auto const & file : db::make::util::split(opt.snapshot, ',')) {
+        auto const snapshot = std::make_shared<db::column_snapshot const>(file);
+        if (db.attach_snapshot(snapshot)) {
+            std::cout << "\nsnapshot attached: " << file
+                << "\nrows = " << snapshot->size()
+                << std::endl;
+        }
+        else {
+            std::cout << "\nsnapshot does not match data pages: " << file << std::endl;
+        }
+    }
+}
+
 void print_version()
 {
 #if defined(_MSC_VER)
@@ -2630,13 +2814,97 @@ void print_help(int argc, char* argv[])
         << "\n[--create_spatial_index] export database parameter"
         << "\n[--dump_pages]"
         << "\n[--checksum]"
+        << "\n[--test_conv] int : megabytes of text for transcoding benchmark"
+        << "\n[--test_join] 0|1 : index nested loops vs hash join of generated table --tab with itself on cluster key"
+        << "\n[--test_row_view] 0|1 : record accessors vs record::view scan of generated table --tab"
+        << "\n[--test_faults] 0|1 : page faults of scan and lookup of table --tab with cold page cache (without page_bpool)"
+        << "\n[--export_table] output file for table --tab"
+        << "\n[--export_format] csv|ndjson|columnar"
+        << "\n[--export_order] 0|1 : write rows in page order"
+        << "\n[--make_snapshot] output columnar snapshot file for table --tab"
+        << "\n[--snapshot] str : columnar snapshot files attached to database for make_query scans, separated by comma"
         << "\n[--min_memory]"
         << "\n[--max_memory]"
         << "\n[--pool_period]"
         << "\n[--pool_defrag]"
+        << "\n[--init_tables] 0|1|2 : serial|parallel|lazy init of tables at open"
+        << "\n[--init_threads] int : threads for parallel init of tables"
+        << "\n[--map_advice] 0|1|2|3 : normal|random|sequential|willneed access of file mapping"
+        << "\n[--map_populate] int : read file when mapped if file size is not greater (megabytes)"
+        << "\n[--data_files] str : secondary data files (.ndf) separated by comma"
+        << "\n[--geo_cache] int : cache of geographies decoded by spatial seeks (megabytes)"
         << std::endl;
 }
 
+// throughput of cp1251 and UTF-16LE transcoders to UTF-8 (MB of input per second)
+void test_conv(size_t const megabytes)
+{
+    using clock = std::chrono::steady_clock;
+    const size_t size = megabytes * megabyte<1>::value;
+    std::string cp1251(size, 0);
+    for (size_t i = 0; i < size; ++i) { // mixed latin and cyrillic words
+        cp1251[i] = ((i / 7) % 3) ? static_cast<char>(0xE0 + i % 32) : static_cast<char>('a' + i % 26);
+        if (!(i % 9)) cp1251[i] = ' ';
+    }
+    const std::wstring wide = db::conv::cp1251_to_wide(cp1251);
+    std::vector<uint16> nchar(wide.begin(), wide.end());
+    const char * const nchar_data = reinterpret_cast<const char *>(nchar.data());
+    const size_t nchar_size = nchar.size() * sizeof(uint16);
+    auto fragments = [](const char * const data, size_t const len) {
+        db::vector_mem_range_t result; // like overflow pages
+        enum { page = db::page_head::body_size };
+        for (size_t i = 0; i < len; i += page) {
+            result.push_back({ data + i, data + a_min(i + page, len) });
+        }
+        return result;
+    };
+    auto print = [size](const char * const name, clock::time_point const start) {
+        const double seconds = std::chrono::duration<double>(clock::now() - start).count();
+        std::cout << name << " MB/s = " << (seconds > 0 ? (double(size) / megabyte<1>::value / seconds) : 0) << std::endl;
+    };
+    std::string buf; // reused
+    std::string expect;
+    {
+        const auto start = clock::now();
+        db::conv::append_cp1251_to_utf8(buf, fragments(cp1251.data(), cp1251.size()));
+        print("cp1251_to_utf8 table", start);
+    }
+#if defined(SDL_OS_UNIX)
+    {
+        const auto start = clock::now();
+        expect = db::unix_::iconv_cp1251_to_utf8(cp1251);
+        print("cp1251_to_utf8 iconv", start);
+        if (buf != expect) {
+            std::cout << "cp1251_to_utf8 results differ" << std::endl;
+        }
+    }
+#endif
+    buf.clear();
+    {
+        const auto start = clock::now();
+        db::conv::append_nchar_to_utf8(buf, fragments(nchar_data, nchar_size));
+        print("nchar_to_utf8 table", start);
+    }
+    {
+        const auto start = clock::now();
+        expect = db::conv::wide_to_utf8(db::conv::nchar_to_wide(fragments(nchar_data, nchar_size)));
+        print("nchar_to_utf8 wide", start);
+        if (buf != expect) {
+            std::cout << "nchar_to_utf8 results differ" << std::endl;
+        }
+    }
+#if defined(SDL_OS_UNIX)
+    {
+        const auto start = clock::now();
+        expect = db::unix_::iconv_utf16_to_utf8(nchar_data, nchar_size);
+        print("nchar_to_utf8 iconv", start);
+        if (buf != expect) {
+            std::cout << "nchar_to_utf8 iconv results differ" << std::endl;
+        }
+    }
+#endif
+}
+
 int run_main(cmd_option const & opt)
 {
     std::unique_ptr<scoped_null_cout> scoped_silence;
@@ -2684,6 +2952,15 @@ int run_main(cmd_option const & opt)
             << "\npoi_file = " << opt.poi_file
             << "\ntest_performance = " << opt.test_performance
             << "\ntest_maketable = " << opt.test_maketable
+            << "\ntest_conv = " << opt.test_conv
+            << "\ntest_join = " << opt.test_join
+            << "\ntest_row_view = " << opt.test_row_view
+            << "\ntest_faults = " << opt.test_faults
+            << "\nexport_table = " << opt.export_table
+            << "\nexport_format = " << opt.export_format
+            << "\nexport_order = " << opt.export_order
+            << "\nmake_snapshot = " << opt.make_snapshot
+            << "\nsnapshot = " << opt.snapshot
             << "\ntrace_poi_csv = " << opt.trace_poi_csv
             << "\nrange_meters = " << opt.range_meters
             << "\ntest_for_range = " << opt.test_for_range
@@ -2715,11 +2992,21 @@ int run_main(cmd_option const & opt)
             << "\nmax_memory = " << opt.max_memory
             << "\npool_period = " << opt.pool_period
             << "\npool_defrag = " << opt.pool_defrag
+            << "\ninit_tables = " << opt.init_tables
+            << "\ninit_threads = " << opt.init_threads
+            << "\nmap_advice = " << opt.map_advice
+            << "\nmap_populate = " << opt.map_populate
+            << "\ndata_files = " << opt.data_files
+            << "\ngeo_cache = " << opt.geo_cache
             << std::endl;
     }
     if (opt.precision) {
         db::to_string::precision(opt.precision);
     }
+    if (opt.test_conv) {
+        test_conv(opt.test_conv);
+        return EXIT_SUCCESS;
+    }
     if (!opt.export_database.empty()) {
         if (export_database(opt)) {
             return EXIT_SUCCESS;
@@ -2731,26 +3018,47 @@ int run_main(cmd_option const & opt)
     cfg.pool_period = opt.pool_period;
     cfg.pool_defrag = opt.pool_defrag;
     cfg.use_page_bpool = opt.use_page_bpool;
+    cfg.init = static_cast<db::database_cfg::init_tables>(a_min(opt.init_tables, size_t(2)));
+    cfg.init_threads = opt.init_threads;
+    cfg.advice = static_cast<map_advice>(a_min(opt.map_advice, size_t(map_advice::willneed)));
+    cfg.map_populate = opt.map_populate;
+    cfg.data_files = db::make::util::split(opt.data_files, ',');
+    cfg.geo_cache = opt.geo_cache;
     db::database m_db(opt.mdf_file, cfg);
     db::database const & db = m_db;
     if (db.is_open()) {
         std::cout << "\ndatabase opened: " << db.filename()
             << "\ndbi_dbname = " << db.dbi_dbname()
             << "\nuse_page_bpool = " << db.use_page_bpool()
+            << "\nfile_count = " << db.file_count()
+            << std::endl;
+        auto const & stat = db.get_open_stat();
+        std::cout << "open time (ms): catalog = " << stat.catalog
+            << ", usertable = " << stat.usertable
+            << ", datatable = " << stat.datatable
+            << ", init_tables = " << stat.init_tables
+            << ", total = " << stat.total
             << std::endl;
     }
     else {
         std::cerr << "\ndatabase failed: " << db.filename() << std::endl;
         return EXIT_FAILURE;
     }
+    if (!opt.snapshot.empty()) {
+        attach_snapshot(m_db, opt);
+    }
     const size_t page_count = db.page_count();
     {
         enum { page_size = db::page_head::page_size };
+        size_t page_total = 0; // all opened data files
+        for (auto const fileId : db.file_ids()) {
+            page_total += db.file_page_count(fileId);
+        }
         const size_t page_allocated = db.page_allocated();
-        const size_t page_free = page_count - page_allocated;
-        SDL_ASSERT(page_allocated <= page_count);
+        const size_t page_free = page_total - page_allocated;
+        SDL_ASSERT(page_allocated <= page_total);
         std::cout
-            << "page_count = " << page_count << " (" << (page_count * page_size) << " byte)"
+            << "page_count = " << page_total << " (" << (page_total * page_size) << " byte)"
             << "\npage_allocated = " << page_allocated << " (" << (page_allocated * page_size) << " byte)"
             << "\npage_free = " << page_free << " (" << (page_free * page_size) << " byte)"
             << std::endl;
@@ -2770,6 +3078,13 @@ int run_main(cmd_option const & opt)
                 << " tornBits = " << p->data.tornBits
                 << std::endl;
             return true;
+        },
+        [](db::database::checksum_progress const & p) {
+            std::cout << "checksum " << (p.page_count ? (100 * p.page_scan / p.page_count) : 100) << "%"
+                << " pages = " << p.page_check
+                << " failed = " << p.page_fail
+                << " MB/s = " << p.MB_per_sec()
+                << std::endl;
         });
         std::cout << "checksum ended" << std::endl;
     }
@@ -2826,6 +3141,18 @@ int run_main(cmd_option const & opt)
     if (!opt.out_file.empty()) {
         maketables(db, opt);
     }
+    if (!opt.export_table.empty()) {
+        export_table(db, opt);
+    }
+    if (!opt.make_snapshot.empty()) {
+        make_snapshot(db, opt);
+    }
+    if (opt.test_faults) {
+        test_faults(db, opt);
+    }
+    if (opt.test_join || opt.test_row_view) {
+        test_table_benchmark(db, opt);
+    }
     if (!opt.write_file && opt.test_maketable) {
 #if SDL_DEBUG_maketable
         db::make::test_maketable_$$$(db);
@@ -2884,6 +3211,15 @@ int run_main(int argc, char* argv[])
     cmd.add(make_option(0, opt.poi_file, "poi_file"));
     cmd.add(make_option(0, opt.test_performance, "test_performance"));  
     cmd.add(make_option(0, opt.test_maketable, "test_maketable"));  
+    cmd.add(make_option(0, opt.test_conv, "test_conv"));
+    cmd.add(make_option(0, opt.test_join, "test_join"));
+    cmd.add(make_option(0, opt.test_row_view, "test_row_view"));
+    cmd.add(make_option(0, opt.test_faults, "test_faults"));
+    cmd.add(make_option(0, opt.export_table, "export_table"));
+    cmd.add(make_option(0, opt.export_format, "export_format"));
+    cmd.add(make_option(0, opt.export_order, "export_order"));
+    cmd.add(make_option(0, opt.make_snapshot, "make_snapshot"));
+    cmd.add(make_option(0, opt.snapshot, "snapshot"));
     cmd.add(make_option(0, opt.trace_poi_csv, "trace_poi_csv"));      
     cmd.add(make_option(0, opt.range_meters, "range_meters"));
     cmd.add(make_option(0, opt.test_for_range, "test_for_range"));   
@@ -2917,6 +3253,12 @@ int run_main(int argc, char* argv[])
     cmd.add(make_option(0, opt.max_memory, "max_memory"));
     cmd.add(make_option(0, opt.pool_period, "pool_period"));
     cmd.add(make_option(0, opt.pool_defrag, "pool_defrag"));
+    cmd.add(make_option(0, opt.init_tables, "init_tables"));
+    cmd.add(make_option(0, opt.init_threads, "init_threads"));
+    cmd.add(make_option(0, opt.map_advice, "map_advice"));
+    cmd.add(make_option(0, opt.map_populate, "map_populate"));
+    cmd.add(make_option(0, opt.data_files, "data_files"));
+    cmd.add(make_option(0, opt.geo_cache, "geo_cache"));
     try {
         if (argc == 1) {
             print_help(argc, argv);
@@ -2924,7 +3266,7 @@ int run_main(int argc, char* argv[])
             return EXIT_SUCCESS;
         }
         cmd.process(argc, argv);
-        if (opt.mdf_file.empty() && opt.export_database.empty()) {
+        if (opt.mdf_file.empty() && opt.export_database.empty() && !opt.test_conv) {
             throw std::string("Missing input file");
         }
     }
@@ -0,0 +1,147 @@
+// geo_cache.h
+//
+#pragma once
+#ifndef __SDL_SPATIAL_GEO_CACHE_H__
+#define __SDL_SPATIAL_GEO_CACHE_H__
+
+#include "dataserver/spatial/geography.h"
+#include <shared_mutex>
+#include <map>
+
+namespace sdl { namespace db {
+
+// decoded geographies by primary key (pk0) for repeated access, e.g. STContains on the same regions;
+// cached geo_mem owns its memory, so it does not depend on pages locked by buffer pool
+template<class KEY_TYPE>
+class geo_cache final : noncopyable {
+public:
+    using key_type = KEY_TYPE;
+    using value_type = std::shared_ptr<geo_mem const>;
+private:
+    using map_type = std::map<key_type, value_type>;
+#if defined(SDL_OS_WIN32)
+    using shared_mutex = std::shared_mutex; // since C++17
+#else
+    using shared_mutex = std::shared_timed_mutex; // since C++14
+#endif
+public:
+    size_t const max_size; // bytes, cache unlimited if max_size = 0
+    explicit geo_cache(size_t const s)
+        : max_size(s)
+        , half_max((s + 1) / 2)
+        , m_size(0)
+        , m_active(0)
+    {
+        memset_zero(m_mapsize);
+    }
+    size_t size() const { // total memory of geographies
+        return m_size;
+    }
+    bool empty() const {
+        return 0 == m_size;
+    }
+    bool unlimited() const {
+        return 0 == max_size;
+    }
+    void clear();
+    value_type find(key_type const &) const;
+    template<class fun_type> // fun_type returns geo_mem for key
+    value_type load(key_type const &, fun_type &&);
+private:
+    value_type find_nolock(key_type const &) const;
+    value_type insert_nolock(key_type const &, value_type const &);
+private:
+    size_t const half_max;
+    mutable shared_mutex m_mutex;
+    std::atomic<size_t> m_size;
+    size_t m_mapsize[2];
+    size_t m_active;
+    map_type m_map[2]; // active map is filled until half_max, then other map is cleared and used
+};
+
+template<class KEY_TYPE>
+void geo_cache<KEY_TYPE>::clear() {
+    if (!empty()) {
+        std::unique_lock<shared_mutex> lock(m_mutex);
+        for (auto & m : m_map) {
+            m.clear();
+        }
+        m_size = 0;
+        m_active = 0;
+        memset_zero(m_mapsize);
+    }
+}
+
+template<class KEY_TYPE>
+typename geo_cache<KEY_TYPE>::value_type
+geo_cache<KEY_TYPE>::find_nolock(key_type const & key) const
+{
+    for (const auto & m : m_map) {
+        const auto it = m.find(key);
+        if (it != m.end()) {
+            return it->second;
+        }
+    }
+    return{};
+}
+
+template<class KEY_TYPE>
+typename geo_cache<KEY_TYPE>::value_type
+geo_cache<KEY_TYPE>::find(key_type const & key) const
+{
+    if (!empty()) {
+        std::shared_lock<shared_mutex> lock(m_mutex);
+        return find_nolock(key);
+    }
+    return{};
+}
+
+template<class KEY_TYPE>
+typename geo_cache<KEY_TYPE>::value_type
+geo_cache<KEY_TYPE>::insert_nolock(key_type const & key, value_type const & p)
+{
+    const size_t mem = p->size();
+    if (!unlimited()) { // cache is limited
+        if (half_max <= m_mapsize[m_active] + mem) { // current map is full
+            m_active = 1 - m_active;
+            auto & m = m_map[m_active];
+            if (!m.empty()) {
+                m.clear();
+                m_size -= m_mapsize[m_active];
+                m_mapsize[m_active] = 0;
+            }
+        }
+    }
+    const auto it = m_map[m_active].emplace(key, p);
+    if (it.second) { // added new
+        m_mapsize[m_active] += mem;
+        m_size += mem;
+        return p;
+    }
+    return (*it.first).second; // return element which added first
+}
+
+template<class KEY_TYPE>
+template<class fun_type>
+typename geo_cache<KEY_TYPE>::value_type
+geo_cache<KEY_TYPE>::load(key_type const & key, fun_type && fun)
+{
+    value_type p = find(key);
+    if (!p) {
+        geo_mem geo = fun(key); // decode without lock
+        if (!geo.is_null()) {
+            reset_new(p, geo.copy());
+            std::unique_lock<shared_mutex> lock(m_mutex);
+            if (value_type found = find_nolock(key)) { // loaded by other thread
+                return found;
+            }
+            return insert_nolock(key, p);
+        }
+    }
+    return p;
+}
+
+} // db
+} // sdl
+
+#endif // __SDL_SPATIAL_GEO_CACHE_H__
@@ -0,0 +1,126 @@
+// geo_view.cpp
+//
+#include "dataserver/spatial/geo_view.h"
+
+namespace sdl { namespace db {
+
+geo_point_view::geo_point_view(data_type const & data, size_t offset, size_t const size)
+    : m_last(data.end())
+    , m_size(size)
+{
+    SDL_ASSERT(offset + size * sizeof(spatial_point) <= mem_size(data));
+    for (auto it = data.begin(); it != data.end(); ++it) {
+        if (offset < mem_size(*it)) {
+            m_first = it;
+            m_offset = offset;
+            return;
+        }
+        offset -= mem_size(*it);
+    }
+    SDL_ASSERT(!size);
+    m_size = 0;
+}
+
+void geo_point_view::read_split(spatial_point & dest,
+                                mem_range_t const * range,
+                                mem_range_t const * const last,
+                                size_t const offset)
+{
+    SDL_ASSERT(offset < mem_size(*range));
+    char * buf = reinterpret_cast<char *>(&dest);
+    const char * src = range->first + offset;
+    size_t count = sizeof(dest);
+    for (;;) {
+        const size_t n = a_min(count, static_cast<size_t>(range->second - src));
+        memcpy(buf, src, n);
+        count -= n;
+        if (!count) break;
+        buf += n;
+        if (++range == last) {
+            SDL_ASSERT(0);
+            memset(buf, 0, count);
+            break;
+        }
+        src = range->first;
+    }
+}
+
+spatial_point geo_point_view::operator[](size_t const i) const
+{
+    SDL_ASSERT(i < size());
+    size_t offset = m_offset + i * sizeof(spatial_point);
+    mem_range_t const * range = m_first;
+    while (offset >= mem_size(*range)) {
+        offset -= mem_size(*range);
+        ++range;
+        SDL_ASSERT(range < m_last);
+    }
+    return *const_iterator(range, m_last, offset, i);
+}
+
+spatial_rect geo_point_view::envelope() const
+{
+    auto p = begin();
+    if (p != end()) {
+        const spatial_point first = *p;
+        auto rect = spatial_rect::init(first, first);
+        for (++p; p != end(); ++p) {
+            const spatial_point pt = *p;
+            set_min(rect.min_lat, pt.latitude);
+            set_max(rect.max_lat, pt.latitude);
+            set_min(rect.min_lon, pt.longitude);
+            set_max(rect.max_lon, pt.longitude);
+        }
+        SDL_ASSERT(rect.is_valid());
+        return rect;
+    }
+    return {};
+}
+
+} // db
+} // sdl
+
+#if SDL_DEBUG
+namespace sdl {
+    namespace db {
+        namespace {
+            class unit_test {
+            public:
+                unit_test()
+                {
+                    spatial_point points[10];
+                    for (size_t i = 0; i < count_of(points); ++i) {
+                        points[i] = { double(i), double(i * 2) };
+                    }
+                    const char * const first = reinterpret_cast<const char *>(points);
+                    const size_t split[] = { 3, 16, 19, 52, 53, 100, sizeof(points) }; // fragments of 3, 13, 3, 33, 1, 47, 60 bytes
+                    vector_mem_range_t data;
+                    data.push_back({ first, first + split[0] });
+                    for (size_t i = 1; i < count_of(split); ++i) {
+                        data.push_back({ first + split[i - 1], first + split[i] });
+                    }
+                    SDL_ASSERT(mem_size(data) == sizeof(points));
+                    for (size_t offset = 0; offset < 3; ++offset) {
+                        const geo_point_view view(data, offset * sizeof(spatial_point), count_of(points) - offset);
+                        size_t i = offset;
+                        for (spatial_point const p : view) {
+                            SDL_ASSERT(p == points[i]);
+                            SDL_ASSERT(view[i - offset] == points[i]);
+                            ++i;
+                        }
+                        SDL_ASSERT(i == count_of(points));
+                        SDL_ASSERT(view.back() == points[count_of(points) - 1]);
+                    }
+                    const geo_point_view view(data, 0, count_of(points));
+                    const spatial_rect rc = view.envelope();
+                    SDL_ASSERT(rc.min_lat == 0);
+                    SDL_ASSERT(rc.max_lat == 9);
+                    SDL_ASSERT(rc.max_lon == 18);
+                    SDL_ASSERT(geo_point_view().empty());
+                }
+            };
+            static unit_test s_test;
+        }
+    } // db
+} // sdl
+#endif //#if SDL_DEBUG
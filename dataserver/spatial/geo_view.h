@@ -0,0 +1,109 @@
+// geo_view.h
+//
+#pragma once
+#ifndef __SDL_SPATIAL_GEO_VIEW_H__
+#define __SDL_SPATIAL_GEO_VIEW_H__
+
+#include "dataserver/spatial/spatial_type.h"
+#include "dataserver/system/mem_utils.h"
+
+namespace sdl { namespace db {
+
+// points of geography stored in memory fragments (e.g. varchar_overflow_page chain),
+// points are read from page memory without copy of whole object;
+// point which straddles fragment boundary is assembled from two fragments
+class geo_point_view {
+    using data_type = vector_mem_range_t;
+    mem_range_t const * m_first = nullptr;  // fragment of first point
+    mem_range_t const * m_last = nullptr;   // end of fragments
+    size_t m_offset = 0;                    // offset of first point in fragment
+    size_t m_size = 0;                      // number of points
+public:
+    class const_iterator {
+        friend geo_point_view;
+        mem_range_t const * m_range = nullptr;
+        mem_range_t const * m_last = nullptr;
+        size_t m_offset = 0;
+        size_t m_index = 0;
+        const_iterator(mem_range_t const * r, mem_range_t const * last, size_t offset, size_t index) noexcept
+            : m_range(r), m_last(last), m_offset(offset), m_index(index) {}
+        explicit const_iterator(size_t index) noexcept : m_index(index) {} // end
+        void next_range();
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = spatial_point;
+        using difference_type = std::ptrdiff_t;
+        using pointer = spatial_point const *;
+        using reference = spatial_point; // returned by value
+        const_iterator() = default;
+        spatial_point operator*() const {
+            SDL_ASSERT(m_range < m_last);
+            spatial_point p;
+            if (m_offset + sizeof(p) <= mem_size(*m_range)) { // fast path
+                memcpy(&p, m_range->first + m_offset, sizeof(p));
+            }
+            else {
+                geo_point_view::read_split(p, m_range, m_last, m_offset);
+            }
+            return p;
+        }
+        const_iterator & operator++() {
+            ++m_index;
+            m_offset += sizeof(spatial_point);
+            if (m_offset >= mem_size(*m_range)) {
+                next_range();
+            }
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator tmp(*this);
+            ++(*this);
+            return tmp;
+        }
+        bool operator==(const_iterator const & x) const { // iterators of the same view
+            return m_index == x.m_index;
+        }
+        bool operator!=(const_iterator const & x) const {
+            return m_index != x.m_index;
+        }
+    };
+    using iterator = const_iterator;
+    geo_point_view() = default;
+    geo_point_view(data_type const &, size_t offset, size_t size); // offset in bytes from begin of data, size in points
+    size_t size() const noexcept {
+        return m_size;
+    }
+    bool empty() const noexcept {
+        return 0 == m_size;
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator(m_first, m_last, m_offset, 0);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(m_size);
+    }
+    spatial_point operator[](size_t) const; // O(number of fragments)
+    spatial_point front() const {
+        SDL_ASSERT(!empty());
+        return *begin();
+    }
+    spatial_point back() const {
+        SDL_ASSERT(!empty());
+        return (*this)[m_size - 1];
+    }
+    spatial_rect envelope() const;
+private:
+    static void read_split(spatial_point &, mem_range_t const *, mem_range_t const *, size_t);
+};
+
+inline void geo_point_view::const_iterator::next_range() {
+    while ((m_offset >= mem_size(*m_range)) && (m_range + 1 < m_last)) {
+        m_offset -= mem_size(*m_range);
+        ++m_range;
+    }
+}
+
+} // db
+} // sdl
+
+#endif // __SDL_SPATIAL_GEO_VIEW_H__
@@ -1,11 +1,38 @@
 // geography.cpp
 //
 #include "dataserver/spatial/geography.h"
+#include "dataserver/spatial/geo_cache.h"
 #include "dataserver/spatial/math_util.h"
 #include "dataserver/system/page_info.h"
 
 namespace sdl { namespace db {
 
+namespace {
+    inline bool view_contains(geo_point_view const & ring, spatial_point const & p) { // = transform::STContains
+        bool point_on_vertix;
+        return math_util::point_in_polygon_t(ring.begin(), ring.end(), p, point_on_vertix);
+    }
+    inline bool view_find(geo_point_view const & points, spatial_point const & p) {
+        for (spatial_point const & it : points) {
+            if (it == p)
+                return true;
+        }
+        return false;
+    }
+    Meters view_length(geo_point_view const & points) { // = transform::STLength
+        SDL_ASSERT(!points.empty());
+        Meters length = 0;
+        auto it = points.begin();
+        spatial_point old = *it;
+        for (++it; it != points.end(); ++it) {
+            spatial_point const p = *it;
+            length += transform::STDistance(old, p);
+            old = p;
+        }
+        return length;
+    }
+}
+
 geo_mem::~geo_mem() {}
 
 geo_mem::geo_mem(data_type && m)
@@ -37,17 +64,62 @@ geo_mem::get_subobj(size_t const subobj) const
 size_t geo_mem::get_subobj_size(size_t const subobj) const
 {
     SDL_ASSERT(subobj < numobj());
-    if (geo_tail const * const tail = get_tail()) {
-        geo_pointarray const * const p = cast_pointarray();
-        spatial_point const * const p1 = tail->begin(*p, subobj);
-        spatial_point const * const p2 = tail->end(*p, subobj);
-        SDL_ASSERT(p1 < p2);
-        return (p2 - p1);
+    if (get_tail()) {
+        const auto range = subobj_range(subobj);
+        SDL_ASSERT(range.first < range.second);
+        return range.second - range.first;
     }
     SDL_ASSERT(0);
     return 0;
 }
 
+std::pair<size_t, size_t>
+geo_mem::subobj_range(size_t const subobj) const
+{
+    geo_tail const * const tail = get_tail();
+    SDL_ASSERT(tail && (subobj < tail->size()));
+    const size_t first = subobj ? (*tail)[subobj - 1] : 0;
+    const size_t last = (subobj + 1 < tail->size()) ? (*tail)[subobj] : pointarray_head()->size();
+    SDL_ASSERT(first <= last);
+    return { first, last };
+}
+
+geo_mem::point_view
+geo_mem::get_subobj_view(size_t const subobj) const
+{
+    SDL_ASSERT(subobj < numobj());
+    const auto range = subobj_range(subobj);
+    return point_view(data(),
+        pointarray_head_size + range.first * sizeof(spatial_point),
+        range.second - range.first);
+}
+
+geo_mem::point_view
+geo_mem::get_points_view() const
+{
+    return point_view(data(), pointarray_head_size, pointarray_head()->size());
+}
+
+geo_mem::point_view
+geo_mem::get_exterior_view() const
+{
+    if (get_tail()) {
+        return get_subobj_view(0);
+    }
+    switch (type()) {
+    case spatial_type::point:
+        return point_view(data(), sizeof(geo_head), geo_point::size());
+    case spatial_type::linesegment:
+        return point_view(data(), sizeof(geo_head), geo_linesegment::size());
+    case spatial_type::linestring:
+    case spatial_type::polygon:
+        return get_points_view();
+    default:
+        SDL_ASSERT(0); 
+        return {};
+    }
+}
+
 geo_mem::point_access
 geo_mem::get_exterior() const
 {
@@ -75,16 +147,15 @@ geo_mem::get_exterior() const
 size_t geo_mem::get_exterior_size() const
 {
     if (get_tail()) {
-        return cast_pointarray()->size();
+        return pointarray_head()->size();
     }
     else {
         switch (type()) {
         case spatial_type::point:
             return geo_point::size(); // = cast_point()->size();
         case spatial_type::linestring:
-            return cast_linestring()->size();
         case spatial_type::polygon:
-            return cast_polygon()->size();
+            return pointarray_head()->size();
         case spatial_type::linesegment:
             return geo_linesegment::size(); // = cast_linesegment()->size();
         default:
@@ -96,27 +167,87 @@ size_t geo_mem::get_exterior_size() const
 
 void geo_mem::init_geography()
 {
+    static_assert(pointarray_head_size == 10, "");
     this_data & d = *pdata;
-    SDL_ASSERT(!d.m_geography && !d.m_buf);
-    if (d.mem_size_data > sizeof(geo_data)) {
-        if (d.m_data.size() == 1) {
-            d.m_geography = reinterpret_cast<geo_data const *>(d.m_data[0].first);
+    SDL_ASSERT(!d.m_buf && d.m_head.empty());
+    if (d.mem_size_data <= sizeof(geo_data)) {
+        throw_error<sdl_exception_t<geo_mem>>("bad geography");
+    }
+    if (is_fragmented()) { // points stay in page memory, only header and tail are copied
+        geo_pointarray::data_type head;
+        if ((d.mem_size_data > sizeof(geo_linesegment)) && 
+            mem_utils::memcpy_at(&head, d.m_data, 0, pointarray_head_size) &&
+            (head.head.tag != spatial_tag::t_point) &&
+            (head.head.tag != spatial_tag::t_linesegment)) {
+            const size_t points_end = pointarray_head_size + head.num_point * sizeof(spatial_point);
+            const size_t tail_size = (points_end < d.mem_size_data) ? (d.mem_size_data - points_end) : 0;
+            d.m_head.resize(pointarray_head_size + tail_size);
+            memcpy(d.m_head.data(), &head, pointarray_head_size);
+            if (tail_size) {
+                mem_utils::memcpy_at(d.m_head.data() + pointarray_head_size, d.m_data, points_end, tail_size);
+            }
         }
-        else {
-            reset_new(d.m_buf, mem_utils::make_vector(d.m_data)); //FIXME: vector_view ? without memory copy
-            d.m_geography = reinterpret_cast<geo_data const *>(d.m_buf->data());
+        else { // small object
+            d.m_head = mem_utils::make_vector(d.m_data);
         }
     }
-    else {
-        throw_error<sdl_exception_t<geo_mem>>("bad geography");
+    d.m_tail = init_tail();
+    SDL_ASSERT(head()->data.SRID == 4326);
+}
+
+geo_data const * geo_mem::head() const
+{
+    this_data const & d = *pdata;
+    if (d.m_head.empty()) {
+        return reinterpret_cast<geo_data const *>(d.m_data[0].first);
     }
-    SDL_ASSERT(d.m_geography->data.SRID == 4326);
+    return reinterpret_cast<geo_data const *>(d.m_head.data());
+}
+
+geo_data const * geo_mem::geography() const
+{
+    this_data & d = *pdata;
+    if (!is_fragmented() || (d.m_head.size() == d.mem_size_data)) {
+        return head();
+    }
+    std::call_once(d.m_buf_once, [&d]() {
+        reset_new(d.m_buf, mem_utils::make_vector(d.m_data)); // note performance
+    });
+    return reinterpret_cast<geo_data const *>(d.m_buf->data());
+}
+
+geo_tail const * geo_mem::init_tail() const
+{
+    this_data const & d = *pdata;
+    if ((d.mem_size_data >= sizeof(geo_pointarray)) && (head()->data.tag == spatial_tag::t_multipolygon)) {
+        if (!is_fragmented() || (d.m_head.size() == d.mem_size_data)) {
+            return pointarray_head()->tail(d.mem_size_data);
+        }
+        if (d.m_head.size() >= pointarray_head_size + sizeof(geo_tail)) {
+            return reinterpret_cast<geo_tail const *>(d.m_head.data() + pointarray_head_size);
+        }
+        SDL_ASSERT(0); // to be tested
+    }
+    return nullptr;
 }
 
 bool geo_mem::is_same(geo_mem const & src) const
 {
-    SDL_ASSERT((pdata->m_geography != src.pdata->m_geography) || algo::is_same(pdata->m_data, src.pdata->m_data));
-    return (pdata->m_geography == src.pdata->m_geography) || algo::is_same(pdata->m_data, src.pdata->m_data);
+    SDL_ASSERT((head() != src.head()) || algo::is_same(pdata->m_data, src.pdata->m_data));
+    return (head() == src.head()) || algo::is_same(pdata->m_data, src.pdata->m_data);
+}
+
+geo_mem geo_mem::copy() const
+{
+    if (is_null()) {
+        return {};
+    }
+    shared_buf buf = std::make_shared<buf_type>(mem_utils::make_vector(data()));
+    data_type m;
+    m.push_back(make_mem_range(*buf));
+    geo_mem result(std::move(m));
+    result.pdata->m_buf = std::move(buf); // keep memory
+    return result;
 }
 
 spatial_type geo_mem::init_type()
@@ -127,7 +258,7 @@ spatial_type geo_mem::init_type()
     static_assert(sizeof(geo_multipolygon) == sizeof(geo_pointarray), "");
     static_assert(sizeof(geo_linestring) == sizeof(geo_pointarray), "");
 
-    geo_data const * const data = pdata->m_geography;
+    geo_data const * const data = head();
     size_t const data_size = pdata->mem_size_data;
 
     if (data_size == sizeof(geo_point)) { // 22 bytes
@@ -146,13 +277,11 @@ spatial_type geo_mem::init_type()
     }
     if (data_size >= sizeof(geo_pointarray)) { // 26 bytes
         if (data->data.tag == spatial_tag::t_linestring) {
-            SDL_ASSERT(!reinterpret_cast<const geo_linestring *>(data)->tail(data_size));
+            SDL_ASSERT(!pdata->m_tail);
             return spatial_type::linestring;
         }
         if (data->data.tag == spatial_tag::t_multipolygon) {
-            geo_base_polygon const * const pp = reinterpret_cast<const geo_base_polygon *>(data);
-            geo_tail const * const tail = pp->tail(data_size);
-            if (tail) {
+            if (geo_tail const * const tail = pdata->m_tail) {
                 if (tail->size() > 1) {                    
                     SDL_ASSERT(tail->data.reserved.num == 0);
                     SDL_ASSERT(tail->data.numobj.num > 1);
@@ -163,7 +292,6 @@ spatial_type geo_mem::init_type()
                     else {
                         SDL_ASSERT((tail->data.reserved.tag == 0) || (tail->data.reserved.tag == 2)); 
                         SDL_ASSERT(tail->data.numobj.tag == 2);
-                        SDL_ASSERT_DISABLED(pp->ring_num());
                         return spatial_type::multipolygon; // or polygon with interior rings
                         //FIXME: GEOMETRYCOLLECTION
                     }
@@ -177,7 +305,6 @@ spatial_type geo_mem::init_type()
                     }
                     else {
                         SDL_ASSERT(tail->data.numobj.tag == 2);
-                        SDL_ASSERT_DISABLED(pp->ring_num() == 1);
                         return spatial_type::polygon;
                     }
                 }
@@ -212,9 +339,10 @@ bool geo_mem::multipolygon_STContains(spatial_point const & p, const orientation
 {
     SDL_ASSERT(type() == spatial_type::multipolygon);
     if (auto const & orient = ring_orient()) {
+        const bool fragmented = is_fragmented();
         for (size_t i = 0, num = numobj(); i < num; ++i) {
             if ((*orient)[i] == flag) {
-                if (transform_t::STContains(get_subobj(i), p)) {
+                if (fragmented ? view_contains(get_subobj_view(i), p) : transform_t::STContains(get_subobj(i), p)) {
                     return true;
                 }
             }
@@ -228,6 +356,9 @@ spatial_rect geo_mem::envelope() const
     if (is_null()) {
         return {};
     }
+    if (is_fragmented() && (pdata->m_head.size() != size())) {
+        return get_points_view().envelope();
+    }
     switch (type()) {
     case spatial_type::point:
         return cast_point()->envelope();
@@ -271,6 +402,9 @@ bool geo_mem::STContains(spatial_point const & p) const
     case spatial_type::point:
         return cast_point()->is_equal(p);
     case spatial_type::polygon:
+        if (is_fragmented()) {
+            return view_contains(get_points_view(), p);
+        }
         return transform_t::STContains(*cast_polygon(), p);
     case spatial_type::multipolygon: 
         if (multipolygon_STContains(p, orientation::exterior)) {
@@ -278,10 +412,16 @@ bool geo_mem::STContains(spatial_point const & p) const
         }
         return false;
     case spatial_type::linestring:
+        if (is_fragmented()) {
+            return view_find(get_points_view(), p);
+        }
         return cast_linestring()->contains(p);
     case spatial_type::linesegment:
         return cast_linesegment()->contains(p);
     case spatial_type::multilinestring:
+        if (is_fragmented()) {
+            return view_find(get_points_view(), p);
+        }
         return cast_multilinestring()->contains(p);
     default:
         SDL_ASSERT(!"not implemented");
@@ -479,6 +619,24 @@ Meters geo_mem::STLength() const
     if (is_null()) {
         return 0; 
     }
+    if (is_fragmented()) {
+        switch (type()) {
+        case spatial_type::linestring:
+        case spatial_type::polygon:
+            return view_length(get_points_view());
+        case spatial_type::multilinestring:
+        case spatial_type::multipolygon:
+            {
+                Meters length = 0;
+                for (size_t i = 0, num = numobj(); i < num; ++i) {
+                    length += view_length(get_subobj_view(i));
+                }
+                return length;
+            }
+        default:
+            break;
+        }
+    }
     switch (type()) {
     case spatial_type::point: 
         return 0;
@@ -582,9 +740,8 @@ geo_tail const * geo_mem::get_tail() const
 {
     switch (type()) {
     case spatial_type::multipolygon:
-        return cast_multipolygon()->tail(this->size());
     case spatial_type::multilinestring:
-        return cast_multilinestring()->tail(this->size());
+        return pdata->m_tail;
     default:
         return nullptr;
     }
@@ -593,7 +750,7 @@ geo_tail const * geo_mem::get_tail() const
 geo_tail const * geo_mem::get_tail_multipolygon() const
 {
     if (type() == spatial_type::multipolygon) {
-        return cast_multipolygon()->tail(this->size());
+        return pdata->m_tail;
     }
     return nullptr;
 }
@@ -603,7 +760,7 @@ namespace {
     orientation get_orientation(T const & exterior, T const & subobj) {
         bool point_on_vertix = false;
         for (auto const & p : subobj) {
-            if (math_util::point_in_polygon(exterior.begin(), exterior.end(), p, point_on_vertix)) {
+            if (math_util::point_in_polygon_t(exterior.begin(), exterior.end(), p, point_on_vertix)) {
                 if (!point_on_vertix) {
                     return orientation::interior;
                 }
@@ -616,16 +773,17 @@ namespace {
     }
 }
 
+template<class get_ring>
 geo_mem::shared_vec_orientation
-geo_mem::init_ring_orient() const
+geo_mem::init_ring_orient_t(get_ring const & get_subobj) const
 {
     if (geo_tail const * const tail = get_tail_multipolygon()) {
         if (const size_t size = tail->size()) {
             auto result = std::make_shared<vec_orientation>(size, orientation::exterior);
             auto & dest = *result;
-            point_access exterior = get_exterior();
+            auto exterior = get_subobj(0);
             for (size_t i = 1; i < size; ++i) {
-                point_access next = get_subobj(i);
+                auto next = get_subobj(i);
                 SDL_ASSERT(is_exterior(dest[0]));
                 bool exterior_inside_interior = false;
                 for (size_t j = i - 1; is_interior(dest[j]); --j) {
@@ -652,6 +810,19 @@ geo_mem::init_ring_orient() const
     return {};
 }
 
+geo_mem::shared_vec_orientation
+geo_mem::init_ring_orient() const
+{
+    if (is_fragmented()) {
+        return init_ring_orient_t([this](size_t const i) {
+            return get_subobj_view(i);
+        });
+    }
+    return init_ring_orient_t([this](size_t const i) {
+        return get_subobj(i);
+    });
+}
+
 geo_mem::shared_vec_orientation
 geo_mem::ring_orient() const
 {
@@ -669,7 +840,13 @@ geo_mem::ring_winding() const
         const size_t size = tail->size();
         vec_winding result(size, winding::exterior);
         for (size_t i = 0; i < size; ++i) {
-            result[i] = math_util::ring_winding(get_subobj(i));
+            if (is_fragmented()) {
+                const point_view ring = get_subobj_view(i);
+                result[i] = math_util::ring_winding_t(ring.begin(), ring.end());
+            }
+            else {
+                result[i] = math_util::ring_winding(get_subobj(i));
+            }
         }
         return result;
     }
@@ -738,6 +915,79 @@ namespace sdl {
                         m22.clear();
                     }
                     SDL_ASSERT(geo_mem().is_null());
+                    test_fragmented();
+                }
+            private:
+                static void test_fragmented() { // geography stored in varchar_overflow_page chain
+                    std::vector<char> buf;
+                    auto append = [&buf](const void * p, size_t const n) {
+                        buf.insert(buf.end(), reinterpret_cast<const char *>(p), reinterpret_cast<const char *>(p) + n);
+                    };
+                    const spatial_point points[] = {
+                        { 0, 0 }, { 0, 10 }, { 10, 10 }, { 10, 0 }, { 0, 0 }, // exterior
+                        { 4, 4 }, { 4, 6 }, { 6, 6 }, { 6, 4 }, { 4, 4 }, // interior
+                    };
+                    const uint32 srid = 4326;
+                    const uint16 tag = spatial_tag::t_multipolygon;
+                    const uint32 num_point = count_of(points);
+                    const geo_tail::num_type tail[] = { { 2, 2 }, { 0, 2 }, { 5, 0 }, { 0, 0 } };
+                    append(&srid, sizeof(srid));
+                    append(&tag, sizeof(tag));
+                    append(&num_point, sizeof(num_point));
+                    append(points, sizeof(points));
+                    append(tail, sizeof(tail));
+                    SDL_ASSERT(buf.size() == 190);
+                    auto make_data = [&buf](std::initializer_list<size_t> split) {
+                        geo_mem::data_type data;
+                        size_t first = 0;
+                        for (size_t const last : split) {
+                            data.push_back({ buf.data() + first, buf.data() + last });
+                            first = last;
+                        }
+                        data.push_back({ buf.data() + first, buf.data() + buf.size() });
+                        return data;
+                    };
+                    const geo_mem g1(make_data({}));
+                    const geo_mem g2(make_data({ 7, 33, 100, 171, 185 })); // points and tail straddle fragments
+                    SDL_ASSERT(!g1.is_fragmented());
+                    SDL_ASSERT(g2.is_fragmented());
+                    for (geo_mem const * g : { &g1, &g2 }) {
+                        SDL_ASSERT(g->type() == spatial_type::multipolygon);
+                        SDL_ASSERT(g->numobj() == 2);
+                        SDL_ASSERT(g->pointcount() == count_of(points));
+                        SDL_ASSERT(g->get_subobj_size(1) == 5);
+                        SDL_ASSERT(g->get_subobj_view(1).front() == points[5]);
+                        SDL_ASSERT(g->get_exterior_view().back() == points[4]);
+                        SDL_ASSERT(g->STContains(spatial_point{ 2, 2 }));
+                        SDL_ASSERT(!g->STContains(spatial_point{ 5, 5 }));
+                        SDL_ASSERT(!g->STContains(spatial_point{ 20, 20 }));
+                        SDL_ASSERT(is_interior((*g->ring_orient())[1]));
+                        SDL_ASSERT(g->STGeometryType() == geometry_types::Polygon);
+                        SDL_ASSERT(g->ring_winding().size() == 2);
+                        SDL_ASSERT(fequal(g->envelope().max_lon, 10));
+                        SDL_ASSERT(fequal(g->STLength().value(), g1.STLength().value()));
+                    }
+                    SDL_ASSERT(g1.ring_winding()[1] == g2.ring_winding()[1]);
+                    SDL_ASSERT(g1.STAsText() == g2.STAsText()); // contiguous copy
+                    {
+                        geo_cache<int64> cache(0);
+                        size_t count = 0;
+                        auto load = [&count, &make_data](int64) {
+                            ++count;
+                            return geo_mem(make_data({ 50, 120 }));
+                        };
+                        auto const p1 = cache.load(1, load);
+                        auto const p2 = cache.load(1, load);
+                        SDL_ASSERT((p1 == p2) && (count == 1));
+                        SDL_ASSERT(!p1->is_fragmented() && (p1->size() == buf.size()));
+                        SDL_ASSERT(p1->STContains(spatial_point{ 2, 2 }));
+                        SDL_ASSERT(cache.find(1) && !cache.find(2));
+                        geo_cache<int64> small(buf.size() * 2);
+                        for (int64 i = 0; i < 5; ++i) {
+                            small.load(i, load);
+                            SDL_ASSERT(small.size() <= small.max_size);
+                        }
+                    }
                 }
             };
             static unit_test s_test;
@@ -6,6 +6,7 @@
 
 #include "dataserver/common/array.h"
 #include "dataserver/spatial/geo_data.h"
+#include "dataserver/spatial/geo_view.h"
 #include "dataserver/spatial/transform.h"
 
 namespace sdl { namespace db {
@@ -86,6 +87,7 @@ public:
 #endif
     };
 public:
+    using point_view = geo_point_view;
     using data_type = vector_mem_range_t;
     geo_mem() noexcept {}
     geo_mem(data_type && m); // allow implicit conversion
@@ -110,6 +112,10 @@ public:
     size_t size() const noexcept {
         return pdata->mem_size_data;
     }
+    bool is_fragmented() const noexcept { // stored in several pages (varchar_overflow_page)
+        return pdata && (pdata->m_data.size() > 1);
+    }
+    geo_mem copy() const; // result owns memory and does not reference pages
     geometry_types STGeometryType() const;
     std::string STAsText() const;
     std::string substr_STAsText(size_t pos, size_t count, bool make_valid) const;
@@ -128,16 +134,16 @@ public:
 private:
     bool multipolygon_STContains(spatial_point const &, orientation) const;
     template<class T> T const * cast_t() const && = delete;
-    template<class T> T const * cast_t() const & noexcept {        
+    template<class T> T const * cast_t() const & {        
         SDL_ASSERT(T::this_type == type());    
-        T const * const obj = reinterpret_cast<T const *>(pdata->m_geography);
+        T const * const obj = reinterpret_cast<T const *>(geography());
         SDL_ASSERT(size() >= obj->data_mem_size());
         return obj;
     }
-    geo_pointarray const * cast_pointarray() const noexcept { // for get_subobj
+    geo_pointarray const * cast_pointarray() const { // for get_subobj
         SDL_ASSERT((type() == spatial_type::multipolygon) || 
                    (type() == spatial_type::multilinestring));
-        geo_pointarray const * const obj = reinterpret_cast<geo_pointarray const *>(pdata->m_geography);
+        geo_pointarray const * const obj = reinterpret_cast<geo_pointarray const *>(geography());
         SDL_ASSERT(size() >= obj->data_mem_size());
         return obj;
     }
@@ -162,6 +168,10 @@ public:
     size_t get_subobj_size(size_t) const;
     size_t get_exterior_size() const;
 
+    // point_view reads points from page memory, fragmented geography is not copied
+    point_view get_subobj_view(size_t subobj) const;
+    point_view get_exterior_view() const;
+
     using vec_orientation = vector_buf<orientation, 16>;
     using vec_winding = vector_buf<winding, 16>;
     using shared_vec_orientation = std::shared_ptr<vec_orientation>;
@@ -169,17 +179,29 @@ public:
     vec_winding ring_winding() const;    
     bool multiple_exterior() const;
 private:
+    static constexpr size_t pointarray_head_size = sizeof(geo_pointarray) - sizeof(spatial_point); // 10 bytes
     spatial_type init_type();
     void init_geography();
+    geo_tail const * init_tail() const;
     geo_tail const * get_tail() const;
     geo_tail const * get_tail_multipolygon() const;
+    geo_data const * head() const; // geo_data and geo_pointarray header fields
+    geo_data const * geography() const; // fragmented geography is copied on first call
+    geo_pointarray const * pointarray_head() const {
+        SDL_ASSERT(size() >= sizeof(geo_pointarray));
+        return reinterpret_cast<geo_pointarray const *>(head());
+    }
+    std::pair<size_t, size_t> subobj_range(size_t subobj) const; // point indexes
+    point_view get_points_view() const; // all points of geo_pointarray
 private:
     struct this_data_base {
         SDL_NONCOPYABLE(this_data_base)
         spatial_type m_type = spatial_type::null;
-        geo_data const * m_geography = nullptr;
         const data_type m_data;
-        shared_buf m_buf;
+        std::vector<char> m_head; // fragmented: header and tail, points are not copied
+        geo_tail const * m_tail = nullptr;
+        std::once_flag m_buf_once;
+        shared_buf m_buf; // fragmented: contiguous copy for cast_t
         std::atomic_bool atomic_init_ring; 
         shared_vec_orientation m_ring; // init once
         this_data_base() = default;
@@ -204,6 +226,8 @@ private:
         return pdata->m_buf;
     }
     shared_vec_orientation init_ring_orient() const;
+    template<class get_ring>
+    shared_vec_orientation init_ring_orient_t(get_ring const &) const;
 };
 
 inline size_t geo_mem::numobj() const {
@@ -168,32 +168,8 @@ bool math_util::point_in_polygon(spatial_point const * const first,
                                  spatial_point const & test)
 {
     SDL_ASSERT(first <= last);
-    if (!(first < last)) {
-        return false;
-    }
-    bool interior = false; // true : point is inside polygon
-    auto p1 = first;
-    auto p2 = p1 + 1;
-    if (*p1 == test) 
-        return true;
-    while (p2 < last) {
-        SDL_ASSERT(p1 < p2);
-        if (*p2 == test)
-            return true;
-        auto const & v1 = *(p2 - 1);
-        auto const & v2 = *p2;
-        if (((v1.latitude > test.latitude) != (v2.latitude > test.latitude)) &&
-            ((test.longitude + limits::fepsilon) < ((test.latitude - v2.latitude) * 
-                (v1.longitude - v2.longitude) / (v1.latitude - v2.latitude) + v2.longitude))) {
-            interior = !interior;
-        }
-        if (*p1 == *p2) { // end of ring found
-            ++p2;
-            p1 = p2;
-        }
-        ++p2;
-    }
-    return interior;
+    bool point_on_vertix;
+    return point_in_polygon_t(first, last, test, point_on_vertix);
 }
 
 bool math_util::point_in_polygon(spatial_point const * const first,
@@ -202,33 +178,7 @@ bool math_util::point_in_polygon(spatial_point const * const first,
                                  bool & point_on_vertix)
 {
     SDL_ASSERT(first <= last);
-    point_on_vertix = false;
-    if (!(first < last)) {
-        return false;
-    }
-    bool interior = false; // true : point is inside polygon
-    auto p1 = first;
-    auto p2 = p1 + 1;
-    if (*p1 == test) 
-        return point_on_vertix = true;
-    while (p2 < last) {
-        SDL_ASSERT(p1 < p2);
-        if (*p2 == test)
-            return point_on_vertix = true;
-        auto const & v1 = *(p2 - 1);
-        auto const & v2 = *p2;
-        if (((v1.latitude > test.latitude) != (v2.latitude > test.latitude)) &&
-            ((test.longitude + limits::fepsilon) < ((test.latitude - v2.latitude) * 
-                (v1.longitude - v2.longitude) / (v1.latitude - v2.latitude) + v2.longitude))) {
-            interior = !interior;
-        }
-        if (*p1 == *p2) { // end of ring found
-            ++p2;
-            p1 = p2;
-        }
-        ++p2;
-    }
-    return interior;
+    return point_in_polygon_t(first, last, test, point_on_vertix);
 }
 
 winding math_util::ring_winding(spatial_point const * first, spatial_point const * last)
@@ -296,6 +246,12 @@ namespace sdl {
                             { 30, 20 },
                         };
                         SDL_ASSERT(is_clockwise(math_util::ring_winding(std::begin(interior), std::end(interior))));
+                        SDL_ASSERT(is_counterclockwise(math_util::ring_winding_t(std::begin(exterior), std::end(exterior))));
+                        SDL_ASSERT(is_clockwise(math_util::ring_winding_t(std::begin(interior), std::end(interior))));
+                        bool on_vertix = false;
+                        SDL_ASSERT(math_util::point_in_polygon(std::begin(exterior), std::end(exterior), { 30, 25 }));
+                        SDL_ASSERT(!math_util::point_in_polygon(std::begin(exterior), std::end(exterior), { 5, 5 }));
+                        SDL_ASSERT(math_util::point_in_polygon(std::begin(exterior), std::end(exterior), { 40, 20 }, on_vertix) && on_vertix);
                     }
                 }
             };
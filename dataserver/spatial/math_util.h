@@ -59,6 +59,13 @@ struct math_util : is_static {
         return ring_winding(ring.begin(), ring.end());
     }
 
+    // forward iterator versions, iterator may return spatial_point by value (e.g. geo_point_view)
+    template<class iterator>
+    static bool point_in_polygon_t(iterator first, iterator last, spatial_point const & test, bool & point_on_vertix);
+
+    template<class iterator>
+    static winding ring_winding_t(iterator first, iterator last);
+
     // returns Z coordinate of vector multiplication
     static constexpr double rotate(point_2D const & p1, point_2D const & p2) {
         return p1.X * p2.Y - p2.X * p1.Y;
@@ -114,6 +121,64 @@ void math_util::get_bbox(rect_type & rc, iterator first, iterator end) {
     SDL_ASSERT(!(rc.rb < rc.lt));
 }
 
+template<class iterator>
+bool math_util::point_in_polygon_t(iterator first, iterator const last,
+                                   spatial_point const & test,
+                                   bool & point_on_vertix)
+{
+    point_on_vertix = false;
+    if (first == last) {
+        return false;
+    }
+    bool interior = false; // true : point is inside polygon
+    spatial_point ring = *first; // first point of ring
+    if (ring == test)
+        return point_on_vertix = true;
+    spatial_point v1 = ring;
+    for (++first; first != last; ++first) {
+        spatial_point const v2 = *first;
+        if (v2 == test)
+            return point_on_vertix = true;
+        if (((v1.latitude > test.latitude) != (v2.latitude > test.latitude)) &&
+            ((test.longitude + limits::fepsilon) < ((test.latitude - v2.latitude) * 
+                (v1.longitude - v2.longitude) / (v1.latitude - v2.latitude) + v2.longitude))) {
+            interior = !interior;
+        }
+        if (ring == v2) { // end of ring found
+            if (++first == last)
+                break;
+            v1 = ring = *first;
+            continue;
+        }
+        v1 = v2;
+    }
+    return interior;
+}
+
+template<class iterator>
+winding math_util::ring_winding_t(iterator first, iterator const last)
+{
+    SDL_ASSERT(first != last);
+    double sum = 0;
+    spatial_point p0 = *first; // = last point of ring
+    double y0 = p0.latitude;
+    bool sides = false;
+    for (++first; first != last; ++first) {
+        spatial_point const p1 = *first;
+        sum += p0.longitude * (p1.latitude - y0);
+        y0 = p0.latitude;
+        p0 = p1;
+        sides = true;
+    }
+    if (sides) {
+        SDL_ASSERT(!fzero(sum));
+        return (sum < 0) ?
+            winding::clockwise :        // interior
+            winding::counterclockwise;  // exterior
+    }
+    return winding::exterior;
+}
+
 inline math_util::contains_t
 math_util::contains(vector_point_2D const & cont, rect_2D const & rc) {
     return math_util::contains(cont.data(), cont.data() + cont.size(), rc);
@@ -0,0 +1,580 @@
+// column_snapshot.cpp
+//
+#include "dataserver/system/column_snapshot.h"
+#include "dataserver/system/database.h"
+#include "dataserver/system/datapage.h"
+#include "dataserver/common/hash_combine.h"
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace sdl { namespace db {
+
+// file layout (little-endian), sections are aligned by 8 bytes:
+// file_head, column_head[column_count],
+// for each column: name, null bitmap (uint64 words),
+//   fixed: row_count * fixed_size bytes (zeros if NULL),
+//   dict: uint32 codes[row_count] (0 if NULL), uint64 offsets[dict_size + 1] and bytes of values;
+// row_locator[row_count] in scan order of data pages.
+struct column_snapshot::column_head { // 48 bytes
+    uint8 type;         // scalartype::type
+    uint8 kind;         // column_kind
+    uint16 name_size;
+    uint32 fixed_size;
+    uint64 name_offset;
+    uint64 null_offset;
+    uint64 data_offset;
+    uint64 dict_offset;
+    uint64 dict_size;
+};
+
+namespace {
+
+const char snapshot_magic[8] = { 'S', 'D', 'L', 'S', 'N', 'P', '0', '1' };
+
+struct file_head { // 40 bytes
+    char magic[8];
+    int32 table_id;
+    uint32 column_count;
+    uint64 row_count;
+    uint64 signature;
+    uint64 locator_offset;
+};
+
+static_assert(sizeof(column_snapshot::row_locator) == 8, "");
+static_assert(sizeof(file_head) == 40, "");
+
+inline size_t align_8(size_t const size) {
+    return (size + 7) & ~size_t(7);
+}
+
+inline void hash_page(uint64 & h, page_head const * const page) {
+    pageFileID const & id = page->data.pageId;
+    pageLSN const & lsn = page->data.lsn;
+    hash_detail::hash_combine_impl(h, (uint64(id.fileId) << 32) | id.pageId);
+    hash_detail::hash_combine_impl(h, (uint64(lsn.lsn2) << 32) | lsn.lsn1);
+    hash_detail::hash_combine_impl(h, (uint64(lsn.lsn3) << 16) | page->data.slotCnt);
+}
+
+} // namespace
+
+class column_snapshot_builder::data_type : noncopyable {
+    using column_kind = column_snapshot::column_kind;
+    using column_head = column_snapshot::column_head;
+    using row_locator = column_snapshot::row_locator;
+    struct column_data {
+        column_head head;
+        std::string name;
+        std::vector<uint64> nulls;
+        std::string data; // fixed values
+        std::vector<uint32> codes;
+        std::unordered_map<std::string, uint32> dict;
+    };
+    std::vector<column_data> m_cols;
+    std::vector<row_locator> m_rows;
+    std::string m_value; // reused
+public:
+    void add_column(std::string const & name, scalartype::type const type, column_kind const kind, size_t const fixed_size) {
+        SDL_ASSERT(m_rows.empty());
+        SDL_ASSERT((kind == column_kind::fixed) == (fixed_size > 0));
+        column_data c;
+        memset_zero(c.head);
+        c.head.type = static_cast<uint8>(type);
+        c.head.kind = static_cast<uint8>(kind);
+        c.head.fixed_size = static_cast<uint32>(fixed_size);
+        c.name = name.substr(0, 0xFFFF);
+        m_cols.push_back(std::move(c));
+    }
+    size_t size() const {
+        return m_cols.size();
+    }
+    column_kind kind(size_t const i) const {
+        return static_cast<column_kind>(m_cols[i].head.kind);
+    }
+    void push_null(size_t const i) {
+        column_data & c = m_cols[i];
+        set_null(c, true);
+        switch (kind(i)) {
+        case column_kind::fixed: c.data.append(c.head.fixed_size, '\0'); break;
+        case column_kind::dict: c.codes.push_back(0); break;
+        default: break;
+        }
+    }
+    void push_value(size_t const i, vector_mem_range_t const & value) {
+        column_data & c = m_cols[i];
+        set_null(c, false);
+        if (kind(i) == column_kind::fixed) {
+            const size_t old_size = c.data.size();
+            for (auto const & m : value) {
+                c.data.append(m.first, m.second);
+            }
+            SDL_ASSERT(c.data.size() == old_size + c.head.fixed_size);
+            c.data.resize(old_size + c.head.fixed_size);
+        }
+        else if (kind(i) == column_kind::dict) {
+            m_value.clear();
+            for (auto const & m : value) {
+                m_value.append(m.first, m.second);
+            }
+            const auto it = c.dict.emplace(m_value, static_cast<uint32>(c.dict.size())).first;
+            c.codes.push_back(it->second);
+        }
+    }
+    void push_row(pageFileID const & page, size_t const slot) { // after values of all columns
+        m_rows.push_back({ page, static_cast<uint16>(slot) });
+    }
+    void write(std::ostream &, schobj_id, uint64 signature);
+private:
+    void set_null(column_data & c, bool const is_null) {
+        const size_t row = m_rows.size();
+        if (row / 64 >= c.nulls.size()) {
+            c.nulls.push_back(0);
+        }
+        if (is_null) {
+            c.nulls[row / 64] |= uint64(1) << (row & 63);
+        }
+    }
+    static void write_data(std::ostream & out, size_t & pos, const void * const data, size_t const size) {
+        out.write(static_cast<const char *>(data), size);
+        pos += size;
+        const size_t pad = align_8(pos) - pos;
+        if (pad) {
+            static const char zero[8]{};
+            out.write(zero, pad);
+            pos += pad;
+        }
+    }
+};
+
+void column_snapshot_builder::data_type::write(std::ostream & out, schobj_id const table_id, uint64 const signature)
+{
+    const size_t rows = m_rows.size();
+    const size_t null_size = ((rows + 63) / 64) * sizeof(uint64);
+    for (auto & c : m_cols) {
+        c.nulls.resize((rows + 63) / 64);
+    }
+    // layout
+    size_t pos = sizeof(file_head) + m_cols.size() * sizeof(column_head);
+    std::vector<std::vector<std::string const *>> values(m_cols.size()); // dictionary by code
+    std::vector<std::vector<uint64>> offsets(m_cols.size());
+    for (size_t i = 0; i < m_cols.size(); ++i) {
+        column_data & c = m_cols[i];
+        c.head.name_size = static_cast<uint16>(c.name.size());
+        c.head.name_offset = pos;
+        pos += align_8(c.name.size());
+        c.head.null_offset = pos;
+        pos += null_size;
+        if (kind(i) == column_kind::fixed) {
+            SDL_ASSERT(c.data.size() == rows * c.head.fixed_size);
+            c.head.data_offset = pos;
+            pos += align_8(c.data.size());
+        }
+        else if (kind(i) == column_kind::dict) {
+            SDL_ASSERT(c.codes.size() == rows);
+            c.head.data_offset = pos;
+            pos += align_8(rows * sizeof(uint32));
+            values[i].resize(c.dict.size());
+            for (auto const & v : c.dict) {
+                values[i][v.second] = &(v.first);
+            }
+            offsets[i].reserve(values[i].size() + 1);
+            uint64 offset = 0;
+            offsets[i].push_back(offset);
+            for (auto const * v : values[i]) {
+                offset += v->size();
+                offsets[i].push_back(offset);
+            }
+            c.head.dict_offset = pos;
+            c.head.dict_size = values[i].size();
+            pos += offsets[i].size() * sizeof(uint64) + align_8(static_cast<size_t>(offset));
+        }
+    }
+    file_head head;
+    memset_zero(head);
+    memcpy(head.magic, snapshot_magic, sizeof(head.magic));
+    head.table_id = table_id._32;
+    head.column_count = static_cast<uint32>(m_cols.size());
+    head.row_count = rows;
+    head.signature = signature;
+    head.locator_offset = pos;
+    // data
+    pos = 0;
+    write_data(out, pos, &head, sizeof(head));
+    for (auto const & c : m_cols) {
+        write_data(out, pos, &(c.head), sizeof(c.head));
+    }
+    for (size_t i = 0; i < m_cols.size(); ++i) {
+        column_data const & c = m_cols[i];
+        SDL_ASSERT(pos == c.head.name_offset);
+        write_data(out, pos, c.name.data(), c.name.size());
+        write_data(out, pos, c.nulls.data(), null_size);
+        if (kind(i) == column_kind::fixed) {
+            write_data(out, pos, c.data.data(), c.data.size());
+        }
+        else if (kind(i) == column_kind::dict) {
+            write_data(out, pos, c.codes.data(), c.codes.size() * sizeof(uint32));
+            SDL_ASSERT(pos == c.head.dict_offset);
+            out.write(reinterpret_cast<const char *>(offsets[i].data()), offsets[i].size() * sizeof(uint64));
+            pos += offsets[i].size() * sizeof(uint64);
+            for (auto const * v : values[i]) {
+                out.write(v->data(), v->size());
+                pos += v->size();
+            }
+            write_data(out, pos, nullptr, 0);
+        }
+    }
+    SDL_ASSERT(pos == head.locator_offset);
+    write_data(out, pos, m_rows.data(), m_rows.size() * sizeof(row_locator));
+}
+
+column_snapshot_builder::column_snapshot_builder()
+    : m_data(new data_type)
+{
+}
+
+column_snapshot_builder::~column_snapshot_builder()
+{
+}
+
+void column_snapshot_builder::add_column(std::string const & name, scalartype::type const type, column_kind const kind, size_t const fixed_size) {
+    m_data->add_column(name, type, kind, fixed_size);
+}
+
+size_t column_snapshot_builder::size() const {
+    return m_data->size();
+}
+
+column_snapshot::column_kind column_snapshot_builder::kind(size_t const i) const {
+    return m_data->kind(i);
+}
+
+void column_snapshot_builder::push_null(size_t const i) {
+    m_data->push_null(i);
+}
+
+void column_snapshot_builder::push_value(size_t const i, vector_mem_range_t const & value) {
+    m_data->push_value(i, value);
+}
+
+void column_snapshot_builder::push_row(pageFileID const & page, size_t const slot) {
+    m_data->push_row(page, slot);
+}
+
+void column_snapshot_builder::write(std::ostream & out, schobj_id const table_id, uint64 const signature) {
+    m_data->write(out, table_id, signature);
+}
+
+//------------------------------------------------------------------
+
+std::string column_snapshot::column::name() const {
+    return std::string(base + head->name_offset, head->name_size);
+}
+
+scalartype::type column_snapshot::column::type() const {
+    return static_cast<scalartype::type>(head->type);
+}
+
+column_snapshot::column_kind column_snapshot::column::kind() const {
+    return static_cast<column_kind>(head->kind);
+}
+
+size_t column_snapshot::column::fixed_size() const {
+    return head->fixed_size;
+}
+
+uint64 const * column_snapshot::column::null_words() const {
+    return reinterpret_cast<uint64 const *>(base + head->null_offset);
+}
+
+const char * column_snapshot::column::fixed_data() const {
+    SDL_ASSERT(kind() == column_kind::fixed);
+    return base + head->data_offset;
+}
+
+uint32 const * column_snapshot::column::codes() const {
+    SDL_ASSERT(kind() == column_kind::dict);
+    return reinterpret_cast<uint32 const *>(base + head->data_offset);
+}
+
+size_t column_snapshot::column::dict_size() const {
+    return static_cast<size_t>(head->dict_size);
+}
+
+mem_range_t column_snapshot::column::dict_value(size_t const code) const {
+    SDL_ASSERT(code < dict_size());
+    uint64 const * const offsets = reinterpret_cast<uint64 const *>(base + head->dict_offset);
+    const char * const data = reinterpret_cast<const char *>(offsets + dict_size() + 1);
+    return { data + offsets[code], data + offsets[code + 1] };
+}
+
+//------------------------------------------------------------------
+
+column_snapshot::column_snapshot(std::string const & filename)
+{
+    const void * const data = m_fmap.CreateMapView(filename.c_str());
+    if (!data) {
+        throw_error<column_snapshot_error>("cannot map file");
+    }
+    init(static_cast<const char *>(data), static_cast<size_t>(m_fmap.GetFileSize()));
+}
+
+column_snapshot::column_snapshot(const char * const data, size_t const size)
+{
+    init(data, size);
+}
+
+column_snapshot::~column_snapshot()
+{
+}
+
+void column_snapshot::init(const char * const data, size_t const size)
+{
+    SDL_ASSERT(data);
+    m_data = data;
+    m_data_size = size;
+    auto check = [size](uint64 const offset, uint64 const length) {
+        if ((offset > size) || (length > size - offset)) {
+            throw_error<column_snapshot_error>("bad snapshot file");
+        }
+    };
+    check(0, sizeof(file_head));
+    file_head const * const head = reinterpret_cast<file_head const *>(data);
+    if (memcmp(head->magic, snapshot_magic, sizeof(snapshot_magic))) {
+        throw_error<column_snapshot_error>("bad snapshot file");
+    }
+    m_size = static_cast<size_t>(head->row_count);
+    check(sizeof(file_head), uint64(head->column_count) * sizeof(column_head));
+    const uint64 null_size = ((head->row_count + 63) / 64) * sizeof(uint64);
+    column_head const * const cols = reinterpret_cast<column_head const *>(head + 1);
+    for (size_t i = 0; i < head->column_count; ++i) {
+        column_head const & c = cols[i];
+        check(c.name_offset, c.name_size);
+        check(c.null_offset, null_size);
+        switch (static_cast<column_kind>(c.kind)) {
+        case column_kind::none:
+            break;
+        case column_kind::fixed:
+            check(c.data_offset, head->row_count * c.fixed_size);
+            break;
+        case column_kind::dict: {
+                check(c.data_offset, head->row_count * sizeof(uint32));
+                check(c.dict_offset, (c.dict_size + 1) * sizeof(uint64));
+                uint64 const * const offsets = reinterpret_cast<uint64 const *>(data + c.dict_offset);
+                check(c.dict_offset + (c.dict_size + 1) * sizeof(uint64), offsets[c.dict_size]);
+                uint32 const * const codes = reinterpret_cast<uint32 const *>(data + c.data_offset);
+                for (size_t row = 0; row < m_size; ++row) {
+                    if ((codes[row] >= c.dict_size) && (codes[row] || c.dict_size)) {
+                        throw_error<column_snapshot_error>("bad snapshot file");
+                    }
+                }
+            }
+            break;
+        default:
+            throw_error<column_snapshot_error>("bad snapshot file");
+        }
+    }
+    check(head->locator_offset, head->row_count * sizeof(row_locator));
+    m_locator = reinterpret_cast<row_locator const *>(data + head->locator_offset);
+}
+
+schobj_id column_snapshot::table_id() const
+{
+    return _schobj_id(reinterpret_cast<file_head const *>(m_data)->table_id);
+}
+
+uint64 column_snapshot::signature() const
+{
+    return reinterpret_cast<file_head const *>(m_data)->signature;
+}
+
+size_t column_snapshot::column_count() const
+{
+    return reinterpret_cast<file_head const *>(m_data)->column_count;
+}
+
+column_snapshot::column
+column_snapshot::operator[](size_t const i) const
+{
+    SDL_ASSERT(i < column_count());
+    column_head const * const cols = reinterpret_cast<column_head const *>(
+        reinterpret_cast<file_head const *>(m_data) + 1);
+    return column(cols + i, m_data);
+}
+
+int column_snapshot::find(const char * const name) const
+{
+    const size_t len = strlen(name);
+    for (size_t i = 0; i < column_count(); ++i) {
+        column_head const * const c = (*this)[i].head;
+        if ((c->name_size == len) && !memcmp(m_data + c->name_offset, name, len)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+column_snapshot::selection
+column_snapshot::select_all() const
+{
+    selection result(word_count(), ~uint64(0));
+    if (!result.empty()) {
+        result.back() = last_word_mask();
+    }
+    return result;
+}
+
+size_t column_snapshot::count(selection const & sel)
+{
+    size_t result = 0;
+    for (uint64 const w : sel) {
+        result += algo::bit_count(w);
+    }
+    return result;
+}
+
+void column_snapshot::filter_null(size_t const col, selection & sel, bool const is_null) const
+{
+    SDL_ASSERT(sel.size() == word_count());
+    uint64 const * const nulls = (*this)[col].null_words();
+    for (size_t w = 0; w < sel.size(); ++w) {
+        sel[w] &= is_null ? nulls[w] : ~nulls[w];
+    }
+}
+
+uint64 column_snapshot::signature(datatable const & table)
+{
+    uint64 h = table.get_id()._32;
+    for (page_head const * const p : datatable::datapage_access(&table,
+        dataType::type::IN_ROW_DATA, pageType::type::data)) {
+        hash_page(h, p);
+    }
+    return h;
+}
+
+void column_snapshot::make_file(datatable const & table, std::string const & filename)
+{
+    usertable const & ut = table.ut();
+    column_snapshot_builder builder;
+    for (size_t i = 0; i < ut.size(); ++i) {
+        usertable::column const & c = ut[i];
+        if (c.is_fixed()) {
+            builder.add_column(c.name, c.type, column_kind::fixed, c.fixed_size());
+        }
+        else if (c.is_geography() || c.length.is_var()) {
+            builder.add_column(c.name, c.type, column_kind::none, 0);
+        }
+        else {
+            builder.add_column(c.name, c.type, column_kind::dict, 0);
+        }
+    }
+    uint64 h = table.get_id()._32;
+    for (page_head const * const p : datatable::datapage_access(&table,
+        dataType::type::IN_ROW_DATA, pageType::type::data)) {
+        hash_page(h, p);
+        const datapage data(p);
+        for (size_t slot = 0; slot < data.size(); ++slot) {
+            row_head const * const row = data[slot];
+            if (row->use_record()) {
+                auto const record = table.make_record(row);
+                for (size_t i = 0; i < builder.size(); ++i) {
+                    if (record.is_null(i)) {
+                        builder.push_null(i);
+                    }
+                    else if (builder.kind(i) == column_kind::none) {
+                        builder.push_value(i, {});
+                    }
+                    else {
+                        builder.push_value(i, record.data_col(i));
+                    }
+                }
+                builder.push_row(p->data.pageId, slot);
+            }
+        }
+    }
+    SDL_ASSERT(h == signature(table));
+    std::ofstream out(filename, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+    if (!out.is_open()) {
+        throw_error<column_snapshot_error>("cannot open file");
+    }
+    builder.write(out, table.get_id(), h);
+    out.flush();
+    if (!out) {
+        throw_error<column_snapshot_error>("cannot write file");
+    }
+}
+
+} // db
+} // sdl
+
+#if SDL_DEBUG
+namespace sdl { namespace db { namespace {
+    class unit_test {
+    public:
+        unit_test() {
+            using column_kind = column_snapshot::column_kind;
+            enum { row_count = 200 };
+            column_snapshot_builder builder;
+            builder.add_column("Id", scalartype::t_int, column_kind::fixed, sizeof(int32));
+            builder.add_column("Name", scalartype::t_varchar, column_kind::dict, 0);
+            const char * const names[] = { "one", "two", "three" };
+            for (int32 i = 0; i < row_count; ++i) {
+                const char * const p = reinterpret_cast<const char *>(&i);
+                builder.push_value(0, { mem_range_t(p, p + sizeof(i)) });
+                if (i % 10) {
+                    const char * const s = names[i % 3];
+                    builder.push_value(1, { mem_range_t(s, s + strlen(s)) });
+                }
+                else {
+                    builder.push_null(1);
+                }
+                pageFileID page{};
+                page.pageId = i / 10;
+                builder.push_row(page, i % 10);
+            }
+            std::ostringstream ss;
+            builder.write(ss, _schobj_id(123), 456);
+            const std::string buf = ss.str();
+            const column_snapshot test(buf.data(), buf.size());
+            SDL_ASSERT(test.size() == row_count);
+            SDL_ASSERT(test.column_count() == 2);
+            SDL_ASSERT(test.table_id()._32 == 123);
+            SDL_ASSERT(test.signature() == 456);
+            SDL_ASSERT(test.find("Name") == 1);
+            SDL_ASSERT(test.find("Nam") == -1);
+            SDL_ASSERT(test.locator(25).page.pageId == 2);
+            SDL_ASSERT(test.locator(25).slot == 5);
+            SDL_ASSERT(test[1].dict_size() == 3);
+            SDL_ASSERT(test[1].is_null(10));
+            {
+                auto sel = test.select_all();
+                SDL_ASSERT(column_snapshot::count(sel) == row_count);
+                test.filter<int32>(0, sel, [](int32 v) { return (v >= 50) && (v < 150); });
+                SDL_ASSERT(column_snapshot::count(sel) == 100);
+                test.filter_dict(1, sel, [](mem_range_t const & m) {
+                    return (mem_size(m) == 3) && !memcmp(m.first, "two", 3);
+                });
+                size_t count = 0;
+                column_snapshot::for_selected(sel, 0, test.size(), [&count](size_t const row) {
+                    SDL_ASSERT((row % 3 == 1) && (row % 10) && (row >= 50) && (row < 150));
+                    ++count;
+                    return true;
+                });
+                SDL_ASSERT(count == column_snapshot::count(sel));
+                count = 0;
+                column_snapshot::for_selected(sel, 51, 53, [&count](size_t const row) {
+                    SDL_ASSERT(row == 53 - 1);
+                    ++count;
+                    return true;
+                });
+                SDL_ASSERT(count == 1);
+            }
+            {
+                auto sel = test.select_all();
+                test.filter_null(1, sel, true);
+                SDL_ASSERT(column_snapshot::count(sel) == row_count / 10);
+            }
+        }
+    };
+    static unit_test s_test;
+}}} // sdl
+#endif //#if SDL_DEBUG
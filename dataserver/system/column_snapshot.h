@@ -0,0 +1,222 @@
+// column_snapshot.h
+//
+#pragma once
+#ifndef __SDL_SYSTEM_COLUMN_SNAPSHOT_H__
+#define __SDL_SYSTEM_COLUMN_SNAPSHOT_H__
+
+#include "dataserver/system/datatable.h"
+#include "dataserver/filesys/file_map.h"
+#include "dataserver/common/algorithm.h"
+
+namespace sdl { namespace db {
+
+// Columnar side-file of a table for analytical scans: typed arrays of fixed columns,
+// dictionary-encoded variable columns, null bitmaps and locators of rows in scan order.
+// Snapshot is built once with make_file and memory-mapped; it is valid while signature
+// of data pages is not changed. Predicates are evaluated over column arrays into selection
+// (bit per row) and only selected rows are decoded from the database.
+class column_snapshot : noncopyable {
+    using column_snapshot_error = sdl_exception_t<column_snapshot>;
+public:
+#pragma pack(push, 1)
+    struct row_locator { // 8 bytes
+        pageFileID page;
+        uint16 slot;
+    };
+#pragma pack(pop)
+    enum class column_kind : uint8 {
+        none = 0,   // only null bitmap (e.g. geography or max length)
+        fixed,      // fixed_size bytes per row
+        dict        // uint32 code per row, values in dictionary
+    };
+    struct column_head; // file layout, see column_snapshot.cpp
+    using selection = std::vector<uint64>; // bit per row
+    class column {
+        friend column_snapshot;
+        column_head const * head = nullptr;
+        const char * base = nullptr;
+        column(column_head const * h, const char * b) : head(h), base(b) {}
+    public:
+        std::string name() const;
+        scalartype::type type() const;
+        column_kind kind() const;
+        size_t fixed_size() const; // 0 if not fixed
+        uint64 const * null_words() const;
+        bool is_null(size_t const row) const {
+            return (null_words()[row >> 6] >> (row & 63)) & 1;
+        }
+        const char * fixed_data() const; // kind() == fixed
+        uint32 const * codes() const; // kind() == dict
+        size_t dict_size() const;
+        mem_range_t dict_value(size_t code) const;
+    };
+public:
+    explicit column_snapshot(std::string const & filename); // throws if file is not a valid snapshot
+    column_snapshot(const char * data, size_t size); // memory is not owned
+    ~column_snapshot();
+
+    static void make_file(datatable const &, std::string const & filename); // throws on error
+    static uint64 signature(datatable const &); // hash of data page ids, LSN and slot counts
+
+    schobj_id table_id() const;
+    uint64 signature() const;
+    bool is_valid(datatable const & table) const {
+        return (table.get_id() == table_id()) && (signature(table) == signature());
+    }
+    size_t size() const { // number of rows
+        return m_size;
+    }
+    size_t column_count() const;
+    column operator[](size_t) const;
+    int find(const char * name) const; // returns -1 if not found
+    row_locator const & locator(size_t const row) const {
+        SDL_ASSERT(row < m_size);
+        return m_locator[row];
+    }
+    size_t memory_size() const {
+        return m_data_size;
+    }
+public: // selection
+    selection select_all() const;
+    selection select_none() const {
+        return selection(word_count(), 0);
+    }
+    static size_t count(selection const &);
+    template<class fun_type> // fun(size_t row) returns bool or break_or_continue
+    static break_or_continue for_selected(selection const &, size_t first_row, size_t last_row, fun_type &&);
+
+    // AND of selection with pred(value) for fixed column, null values are stored as zero (like record value)
+    template<class T, class pred_type>
+    void filter(size_t col, selection &, pred_type &&) const;
+    // AND of selection with pred(mem_range_t) for non-null values of dict column, pred is called once per dictionary value
+    template<class pred_type>
+    void filter_dict(size_t col, selection &, pred_type &&) const;
+    void filter_null(size_t col, selection &, bool is_null) const;
+private:
+    void init(const char * data, size_t size);
+    size_t word_count() const {
+        return (m_size + 63) / 64;
+    }
+    uint64 last_word_mask() const {
+        return (m_size & 63) ? ((uint64(1) << (m_size & 63)) - 1) : ~uint64(0);
+    }
+private:
+    FileMapping m_fmap;
+    const char * m_data = nullptr;
+    size_t m_data_size = 0;
+    size_t m_size = 0;
+    row_locator const * m_locator = nullptr;
+};
+
+using shared_column_snapshot = std::shared_ptr<column_snapshot const>;
+
+// collects values of rows in scan order and writes them in snapshot layout (see column_snapshot::make_file)
+class column_snapshot_builder : noncopyable {
+    class data_type;
+    std::unique_ptr<data_type> m_data;
+public:
+    using column_kind = column_snapshot::column_kind;
+    column_snapshot_builder();
+    ~column_snapshot_builder();
+    void add_column(std::string const & name, scalartype::type, column_kind, size_t fixed_size); // fixed_size is 0 if not fixed
+    size_t size() const; // number of columns
+    column_kind kind(size_t) const;
+    void push_null(size_t);
+    void push_value(size_t, vector_mem_range_t const &);
+    void push_row(pageFileID const &, size_t slot); // after values of all columns
+    void write(std::ostream &, schobj_id, uint64 signature);
+};
+
+template<class fun_type>
+break_or_continue column_snapshot::for_selected(selection const & sel, size_t const first_row, size_t const last_row, fun_type && fun)
+{
+    SDL_ASSERT(first_row <= last_row);
+    size_t w = first_row / 64;
+    const size_t w_last = (last_row + 63) / 64;
+    for (; w < w_last; ++w) {
+        uint64 bits = sel[w];
+        if (w == first_row / 64) {
+            bits &= ~uint64(0) << (first_row & 63);
+        }
+        if ((w + 1 == w_last) && (last_row & 63)) {
+            bits &= (uint64(1) << (last_row & 63)) - 1;
+        }
+        while (bits) {
+            const size_t row = w * 64 + algo::bit_scan_forward(bits);
+            if (is_break(make_break_or_continue(fun(row)))) {
+                return bc::break_;
+            }
+            bits &= bits - 1;
+        }
+    }
+    return bc::continue_;
+}
+
+template<class T, class pred_type>
+void column_snapshot::filter(size_t const col, selection & sel, pred_type && pred) const
+{
+    static_assert(std::is_trivially_copyable<T>::value, "column_snapshot::filter");
+    column const c = (*this)[col];
+    if ((c.kind() != column_kind::fixed) || (c.fixed_size() != sizeof(T))) {
+        throw_error<column_snapshot_error>("filter: bad column type");
+    }
+    SDL_ASSERT(sel.size() == word_count());
+    const char * const data = c.fixed_data();
+    const size_t words = sel.size();
+    for (size_t w = 0; w < words; ++w) {
+        if (!sel[w]) {
+            continue;
+        }
+        const size_t first = w * 64;
+        const size_t n = a_min(m_size - first, size_t(64));
+        uint64 mask = 0;
+        if (std::is_arithmetic<T>::value && (n == 64)) { // branch-free loop for vectorizer
+            T values[64];
+            memcpy(values, data + first * sizeof(T), sizeof(values));
+            for (size_t j = 0; j < 64; ++j) {
+                mask |= uint64(pred(values[j]) ? 1 : 0) << j;
+            }
+        }
+        else {
+            for (size_t j = 0; j < n; ++j) {
+                T value;
+                memcpy(&value, data + (first + j) * sizeof(T), sizeof(T));
+                mask |= uint64(pred(value) ? 1 : 0) << j;
+            }
+        }
+        sel[w] &= mask;
+    }
+}
+
+template<class pred_type>
+void column_snapshot::filter_dict(size_t const col, selection & sel, pred_type && pred) const
+{
+    column const c = (*this)[col];
+    if (c.kind() != column_kind::dict) {
+        throw_error<column_snapshot_error>("filter_dict: bad column type");
+    }
+    SDL_ASSERT(sel.size() == word_count());
+    std::vector<uint8> match(a_max(c.dict_size(), size_t(1))); // code of null value is 0
+    for (size_t i = 0; i < c.dict_size(); ++i) {
+        match[i] = pred(c.dict_value(i)) ? 1 : 0;
+    }
+    uint32 const * const codes = c.codes();
+    uint64 const * const nulls = c.null_words();
+    for (size_t w = 0; w < sel.size(); ++w) {
+        if (!sel[w]) {
+            continue;
+        }
+        const size_t first = w * 64;
+        const size_t n = a_min(m_size - first, size_t(64));
+        uint64 mask = 0;
+        for (size_t j = 0; j < n; ++j) {
+            mask |= uint64(match[codes[first + j]]) << j;
+        }
+        sel[w] &= mask & ~nulls[w];
+    }
+}
+
+} // db
+} // sdl
+
+#endif // __SDL_SYSTEM_COLUMN_SNAPSHOT_H__
@@ -18,18 +18,125 @@ database::~database()
 
 void database::init_database()
 {
+    using clock = std::chrono::steady_clock;
+    auto const elapsed = [](clock::time_point const & start) {
+        return static_cast<size_t>(std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - start).count());
+    };
+    open_stat & stat = m_data->stat;
+    auto const start = clock::now();
+    auto phase = start;
+
+    init_catalog();
+    stat.catalog = elapsed(phase);
+    phase = clock::now();
+
     _usertables.init(get_usertables());
     _internals.init(get_internals());
+    {
+        sys_catalog & c = *m_data->catalog;
+        for (auto const & ut : _usertables) {
+            c.usertables.insert(ut, get_primary_key(ut->get_id()));
+        }
+        for (auto const & ut : _internals) {
+            c.internals.insert(ut, get_primary_key(ut->get_id()));
+        }
+    }
+    stat.usertable = elapsed(phase);
+    phase = clock::now();
+
     _datatables.init(get_datatables());
+    stat.datatable = elapsed(phase);
+    phase = clock::now();
 
-    for (auto const & ut : _usertables) {
-        init_datatable(ut);
+    init_datatables(*get_usertables());
+    init_datatables(*get_internals());
+    stat.init_tables = elapsed(phase);
+    stat.total = elapsed(start);
+
+    m_data->publish();
+    m_data->initialized = true;
+    SDL_TRACE(__FUNCTION__, ": [", dbi_dbname(), "] ", stat.total, " ms");
+}
+
+void database::init_catalog()
+{
+    SDL_ASSERT(!m_data->catalog);
+    std::unique_ptr<sys_catalog> result(new sys_catalog);
+    sys_catalog & c = *result;
+    for_row(_syscolpars, [&c](syscolpars::const_pointer p) {
+        c.colpars.push_back(p->data.id, p);
+    });
+    for_row(_sysscalartypes, [&c](sysscalartypes::const_pointer p) {
+        c.scalartypes.push_back(p->data.id, p);
+    });
+    for_row(_sysidxstats, [&c](sysidxstats::const_pointer p) {
+        c.idxstats.push_back(p->data.id, p);
+        c.idxstats_name[p->name()].push_back(p);
+    });
+    for_row(_sysiscols, [&c](sysiscols::const_pointer p) {
+        c.iscols.push_back(p->data.idmajor, p);
+    });
+    for_row(_sysallocunits, [&c](sysallocunits::const_pointer p) {
+        c.allocunits.push_back(p->data.ownerid._64, p);
+    });
+    c.colpars.sort();
+    c.scalartypes.sort();
+    c.idxstats.sort();
+    c.iscols.sort();
+    c.allocunits.sort();
+    m_data->catalog = std::move(result);
+}
+
+database::sys_catalog const &
+database::catalog() const
+{
+    if (!m_data->catalog) {
+        throw_error<database_error>("catalog is not loaded");
     }
-    for (auto const & ut : _internals) {
-        init_datatable(ut);
+    return *m_data->catalog;
+}
+
+database::open_stat const &
+database::get_open_stat() const
+{
+    return m_data->stat;
+}
+
+void database::init_datatables(vector_shared_usertable const & tables)
+{
+    SDL_ASSERT(!m_data->initialized);
+    database_cfg::init_tables mode = cfg().init;
+    if (use_page_bpool()) {
+        mode = database_cfg::init_tables::serial; // pages loaded by init thread are fixed in pool
+    }
+    if (mode == database_cfg::init_tables::lazy) {
+        return; // state of table is made on first access
+    }
+    size_t thread_count = 1;
+    if (mode == database_cfg::init_tables::parallel) {
+        thread_count = cfg().init_threads ? cfg().init_threads : std::thread::hardware_concurrency();
+        thread_count = a_max(a_min(thread_count, tables.size()), size_t(1));
+    }
+    if (thread_count == 1) {
+        for (auto const & ut : tables) {
+            init_datatable(ut);
+        }
+        return;
+    }
+    std::atomic<size_t> next(0);
+    auto const worker = [this, &tables, &next]() {
+        for (size_t i; (i = next++) < tables.size(); ) {
+            init_datatable(tables[i]);
+        }
+    };
+    std::vector<std::future<void>> workers;
+    workers.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers.push_back(std::async(std::launch::async, worker));
+    }
+    for (auto & w : workers) {
+        w.get(); // rethrows exception of worker
     }
-    m_data->initialized = true;
-    SDL_TRACE(__FUNCTION__, ": [", dbi_dbname(), "]");
 }
 
 void database::init_datatable(shared_usertable const & schema)
@@ -86,48 +193,186 @@ size_t database::page_count() const
 
 size_t database::page_allocated() const
 {
-    size_t allocated = 0;
-    size_t count = page_count();
-    pageFileID id = pageFileID::init(0);
-    while (count--) {
-        SDL_ASSERT(id.pageId < (uint32)page_count());
-        if (auto h = load_page_head(pfs_page::pfs_for_page(id))) {
-            if (pfs_page(h)[id].b.allocated) {
-                ++allocated;
+    size_t result = 0;
+    for (uint16 const fileId : file_ids()) {
+        const size_t count = file_page_count(fileId);
+        result += load_file_pfs_bitmap(fileId, 0, count).count(0, count);
+    }
+    return result;
+}
+
+size_t database::file_count() const
+{
+    return m_data->file_count();
+}
+
+std::vector<uint16> database::file_ids() const
+{
+    std::vector<uint16> result = m_data->file_ids();
+    result.insert(result.begin(), pageFileID::primary_file);
+    return result;
+}
+
+size_t database::file_page_count(uint16 const fileId) const
+{
+    if (fileId == pageFileID::primary_file) {
+        return page_count();
+    }
+    if (auto const f = m_data->find_file(fileId)) {
+        return f->pmap.page_count();
+    }
+    return 0;
+}
+
+pfs_bitmap const &
+database::load_pfs_bitmap(size_t const first, size_t const last) const
+{
+    SDL_ASSERT(m_data->pfs_alloc.page_count() == page_count());
+    return load_pfs_bitmap(m_data->pfs_alloc, pageFileID::primary_file, first, last);
+}
+
+pfs_bitmap const &
+database::load_file_pfs_bitmap(uint16 const fileId, size_t const first, size_t const last) const
+{
+    if (fileId == pageFileID::primary_file) {
+        return load_pfs_bitmap(first, last);
+    }
+    if (auto const f = m_data->find_file(fileId)) {
+        return load_pfs_bitmap(f->pfs_alloc, fileId, first, last);
+    }
+    throw_error<database_error>("data file not found");
+    return m_data->pfs_alloc;
+}
+
+pfs_bitmap const &
+database::load_pfs_bitmap(pfs_bitmap & bitmap, uint16 const fileId, size_t const first, size_t const last) const
+{
+    if (first < last) {
+        const size_t end = pfs_bitmap::interval(last - 1) + 1;
+        for (size_t i = pfs_bitmap::interval(first); i < end; ++i) {
+            if (!bitmap.is_loaded(i)) {
+                const pageFileID id = pageFileID::init(static_cast<uint32>(a_max(i * pfs_bitmap::pfs_size, size_t(1))), fileId);
+                if (page_head const * const h = load_page_head(id)) {
+                    bitmap.load(i, *pfs_page(h).row);
+                }
+                else {
+                    throw_error<database_error>("cannot load pfs page");
+                }
             }
         }
-        ++(id.pageId);
     }
-    return allocated;
+    return bitmap;
+}
+
+double database::checksum_progress::MB_per_sec() const
+{
+    if (milliseconds) {
+        return double(page_check) * page_head::page_size * 1000 / (double(milliseconds) * megabyte<1>::value);
+    }
+    return 0;
 }
 
 break_or_continue
-database::scan_checksum(checksum_fun fun) const
-{
-    pageFileID id = pageFileID::init(0);
-    size_t count = page_count();
-    while (count--) {
-        if (is_allocated(id)) {
-            if (page_head const * const p = load_page_head(id)) {
-                if (p->data.tornBits) {
-                    if (page_head::checksum(p) != p->data.tornBits) {
-                        if (!fun(p)) {
-                            return break_or_continue::break_;
-                        }
-                    }
-                }
-                else {
-                    SDL_TRACE_WARNING("empty tornBits ", to_string::type(id));
+database::scan_checksum(checksum_fun fun, progress_fun progress, size_t thread_count) const
+{
+    enum { pfs_size = pfs_page_row::pfs_size };
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    struct chunk_type {
+        uint16 fileId;
+        size_t first;
+        size_t last;
+    };
+    std::vector<chunk_type> chunks; // one PFS page per chunk
+    size_t total = 0;
+    for (uint16 const fileId : file_ids()) {
+        const size_t count = file_page_count(fileId);
+        for (size_t first = 0; first < count; first += pfs_size) {
+            chunks.push_back({ fileId, first, a_min(first + pfs_size, count) });
+        }
+        total += count;
+    }
+    const size_t chunk_count = chunks.size();
+    if (!thread_count) {
+        thread_count = std::thread::hardware_concurrency();
+    }
+    thread_count = a_max(a_min(thread_count, chunk_count), size_t(1));
+    std::atomic<size_t> next_chunk{ 0 };
+    std::atomic<size_t> page_scan{ 0 };
+    std::atomic<size_t> page_check{ 0 };
+    std::atomic<size_t> page_fail{ 0 };
+    std::atomic<bool> cancel{ false };
+    std::mutex fun_mutex;
+    auto check_page = [this, &fun, &fun_mutex, &page_check, &page_fail, &cancel](pageFileID const & id) {
+        page_head const * const p = load_page_head(id);
+        if (!p) {
+            throw_error<database_error>("cannot load page");
+            return false;
+        }
+        if (p->data.tornBits) {
+            if (page_head::checksum(p) != p->data.tornBits) {
+                ++page_fail;
+                std::lock_guard<std::mutex> lock(fun_mutex);
+                if (cancel || !fun(p)) {
+                    cancel = true;
+                    return false;
                 }
             }
-            else {
-                throw_error<database_error>("cannot load page");
-                return break_or_continue::break_;
+        }
+        else {
+            SDL_TRACE_WARNING("empty tornBits ", to_string::type(id));
+        }
+        ++page_check;
+        return !cancel;
+    };
+    auto worker = [this, &chunks, chunk_count, &next_chunk, &page_scan, &cancel, &check_page]() {
+        database::scoped_thread_lock lock(*this); // pages locked by worker thread
+        try {
+            size_t chunk;
+            while (!cancel && ((chunk = next_chunk++) < chunk_count)) {
+                chunk_type const & c = chunks[chunk];
+                for_allocated_pages(c.fileId, c.first, c.last, check_page);
+                page_scan += c.last - c.first;
+                unlock_thread(std::this_thread::get_id(), bpool::removef::false_); // release pool blocks of chunk
             }
         }
-        ++(id.pageId);
+        catch (...) {
+            cancel = true;
+            throw;
+        }
+    };
+    auto make_progress = [&]() {
+        checksum_progress state;
+        state.page_count = total;
+        state.page_scan = page_scan;
+        state.page_check = page_check;
+        state.page_fail = page_fail;
+        state.milliseconds = static_cast<size_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            clock::now() - start).count());
+        return state;
+    };
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        tasks.push_back(std::async(std::launch::async, worker));
+    }
+    for (auto & t : tasks) {
+        if (progress) {
+            while (t.wait_for(std::chrono::seconds(1)) != std::future_status::ready) {
+                progress(make_progress());
+            }
+        }
+        t.get(); // rethrow worker exception
+    }
+    if (progress) {
+        progress(make_progress());
     }
-    return break_or_continue::continue_;
+    return cancel ? break_or_continue::break_ : break_or_continue::continue_;
+}
+
+break_or_continue
+database::scan_checksum(checksum_fun fun) const {
+    return scan_checksum(std::move(fun), progress_fun());
 }
 
 break_or_continue 
@@ -261,14 +506,139 @@ size_t database::pool_max_thread_size() {
     return bpool::thread_id_t::max_size();
 }
 
+namespace {
+    thread_local database::scoped_page_count * t_page_count = nullptr;
+}
+
+database::scoped_page_count::scoped_page_count(scoped_page_count * const link)
+    : m_prev(t_page_count), m_link(link)
+{
+    t_page_count = this;
+}
+
+database::scoped_page_count::~scoped_page_count()
+{
+    SDL_ASSERT(t_page_count == this);
+    t_page_count = m_prev;
+    if (m_prev) { // nested counter
+        m_prev->m_count.fetch_add(count(), std::memory_order_relaxed);
+    }
+    if (m_link) { // worker thread counter
+        m_link->m_count.fetch_add(count(), std::memory_order_relaxed);
+    }
+}
+
+database::scoped_page_count *
+database::scoped_page_count::current() {
+    return t_page_count;
+}
+
+inline void database::scoped_page_count::add_page() {
+    if (scoped_page_count * const p = t_page_count) {
+        p->m_count.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+size_t database::pool_block_read() const {
+    if (auto p = m_data->cpool()) {
+        return p->block_read();
+    }
+    return 0;
+}
+
 page_head const *
 database::load_page_head(pageIndex const i) const {
+    scoped_page_count::add_page();
     if (auto p = m_data->pool()) {
         return p->lock_page(i);
     }
     return m_data->pmap().lock_page(i);
 }
 
+page_head const *
+database::load_file_page(pageFileID const & id) const {
+    SDL_ASSERT(id && (id.fileId != pageFileID::primary_file));
+    scoped_page_count::add_page();
+    if (auto const f = m_data->find_file(id.fileId)) {
+        return f->pmap.lock_page(id.pageId);
+    }
+    SDL_TRACE("data file not found: ", id.fileId);
+    throw_error<database_error>("data file not found");
+    return nullptr;
+}
+
+namespace {
+
+// pages are sorted and belong to one file
+template<class pmap_type>
+void prefetch_runs(pmap_type const & pmap, pageFileID const * const pages, size_t const size)
+{
+    for (size_t i = 0; i < size; ) {
+        size_t next = i + 1;
+        while ((next < size) && (pages[next].pageId == pages[next - 1].pageId + 1)) {
+            ++next;
+        }
+        pmap.prefetch(pages[i].pageId, next - i);
+        i = next;
+    }
+}
+
+// pages are sorted, unique and not null; fun(fileId, pages, size) is called for pages of each file,
+// files are visited from last to first so that read-ahead of secondary files is queued
+// before pages of primary file are loaded by page_bpool in calling thread
+template<class fun_type>
+void for_file_pages(pageFileID const * const pages, size_t const size, fun_type && fun)
+{
+    for (size_t last = size; last; ) {
+        const uint16 fileId = pages[last - 1].fileId;
+        size_t first = last - 1;
+        while (first && (pages[first - 1].fileId == fileId)) {
+            --first;
+        }
+        fun(fileId, pages + first, last - first);
+        last = first;
+    }
+}
+
+} // namespace
+
+void database::prefetch_pages(std::vector<pageFileID> & pages) const
+{
+    std::sort(pages.begin(), pages.end());
+    pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+    if (!pages.empty() && !pages[0]) {
+        pages.erase(pages.begin()); // null page
+    }
+    // madvise(MADV_WILLNEED) of secondary file only queues read-ahead and returns, so it is called inline
+    for_file_pages(pages.data(), pages.size(), [this](uint16 const fileId, pageFileID const * const range, size_t const size) {
+        if (fileId == pageFileID::primary_file) {
+            if (auto p = m_data->pool()) {
+                for (size_t i = 0; i < size; ++i) {
+                    p->lock_page(range[i].pageId); // unlocked with other pages of this thread
+                }
+            }
+            else {
+                prefetch_runs(m_data->pmap(), range, size);
+            }
+        }
+        else if (auto const f = m_data->find_file(fileId)) {
+            prefetch_runs(f->pmap, range, size);
+        }
+    });
+}
+
+void database::prefetch_file_pages(pageFileID const & first, size_t const count) const
+{
+    if (first.fileId == pageFileID::primary_file) {
+        if (!m_data->use_page_bpool()) { // page_bpool reads whole block with first page of it
+            m_data->pmap().prefetch(first.pageId, count);
+        }
+    }
+    else if (auto const f = m_data->find_file(first.fileId)) {
+        f->pmap.prefetch(first.pageId, count);
+    }
+}
+
 database::page_row
 database::load_page_row(recordID const & row) const
 {
@@ -511,26 +881,10 @@ recordID database::load_prev_record(recordID const & r) const
     return{};
 }
 
-template<class fun_type>
-unique_datatable database::find_table_if(fun_type && fun) const
-{
-    for (auto const & p : _usertables) {
-        const usertable & d = *p.get();
-        if (fun(d)) {
-            return std::make_unique<datatable>(this, p);
-        }
-    }
-    return {};
-}
-
-template<class fun_type>
-unique_datatable database::find_internal_if(fun_type && fun) const
+unique_datatable database::make_datatable(shared_usertable const & schema) const
 {
-    for (auto const & p : _internals) {
-        const usertable & d = *p.get();
-        if (fun(d)) {
-            return std::make_unique<datatable>(this, p);
-        }
+    if (schema) {
+        return std::make_unique<datatable>(this, schema);
     }
     return {};
 }
@@ -538,39 +892,35 @@ unique_datatable database::find_internal_if(fun_type && fun) const
 unique_datatable database::find_table(const std::string & name) const
 {
     SDL_ASSERT(!name.empty());
-    return find_table_if([&name](const usertable & d) {
-        return d.name() == name;
-    });
+    return make_datatable(catalog().usertables.find(name));
 }
 
 unique_datatable database::find_table(schobj_id const id) const
 {
-    return find_table_if([id](const usertable & d) {
-        return d.get_id() == id;
-    });
+    if (auto const p = catalog().usertables.find(id)) {
+        return make_datatable(p->schema);
+    }
+    return {};
 }
 
 unique_datatable database::find_internal(const std::string & name) const
 {
     SDL_ASSERT(!name.empty());
-    return find_internal_if([&name](const usertable & d) {
-        return d.name() == name;
-    });
+    return make_datatable(catalog().internals.find(name));
 }
 
 unique_datatable database::find_internal(schobj_id const id) const
 {
-    return find_internal_if([id](const usertable & d) {
-        return d.get_id() == id;
-    });
+    if (auto const p = catalog().internals.find(id)) {
+        return make_datatable(p->schema);
+    }
+    return {};
 }
 
 shared_usertable database::find_table_schema(schobj_id const id) const
 {
-    for (auto const & p : _usertables) {
-        if (p->get_id() == id) {
-            return p;
-        }
+    if (auto const p = catalog().usertables.find(id)) {
+        return p->schema;
     }
     throw_error<database_error>("cannot find table schema");
     return {};
@@ -578,10 +928,8 @@ shared_usertable database::find_table_schema(schobj_id const id) const
 
 shared_usertable database::find_internal_schema(schobj_id const id) const
 {
-    for (auto const & p : _internals) {
-        if (p->get_id() == id) {
-            return p;
-        }
+    if (auto const p = catalog().internals.find(id)) {
+        return p->schema;
     }
     throw_error<database_error>("cannot find internal schema");
     return {};
@@ -614,15 +962,12 @@ void database::get_tables(vector_shared_usertable & m_ut, fun_type const & is_ta
         if (is_table(schobj_row)) {
             const schobj_id table_id = schobj_row->data.id;
             usertable::columns cols;
-            for_row(_syscolpars, [&cols, table_id, this](syscolpars::const_pointer colpar_row) {
-                if (colpar_row->data.id == table_id) {
-                    const scalartype utype = colpar_row->data.utype;
-                    if (auto scalar_row = find_if(_sysscalartypes, [utype](sysscalartypes::const_pointer p) {
-                        return (p->data.id == utype);
-                    })) {
-                        usertable::emplace_back(cols, colpar_row, scalar_row);
-                    }
+            sys_catalog const & c = catalog();
+            c.colpars.for_key(table_id, [&cols, &c](syscolpars_row const * const colpar_row) {
+                if (auto scalar_row = c.find_scalartype(colpar_row->data.utype)) {
+                    usertable::emplace_back(cols, colpar_row, scalar_row);
                 }
+                return true;
             });
             if (!cols.empty()) {
                 primary_key const * const PK = get_primary_key(table_id).get();             
@@ -708,25 +1053,23 @@ database::find_sysalloc(schobj_id const id, dataType::type const data_type) cons
     }
     shared_sysallocunits shared_result(new vector_sysallocunits_row);
     auto & result = *shared_result;
-    for_row(_sysidxstats, [this, id, data_type, &result](sysidxstats::const_pointer idx) {
-        if ((idx->data.id == id) && !idx->data.rowset.is_null()) {
-            for_row(_sysallocunits, 
-                [idx, data_type, &result](sysallocunits::const_pointer row) {
-                    if (row->data.pgfirstiam) {
-                        if ((row->data.ownerid == idx->data.rowset) && (row->data.type == data_type)) {
-                            if (!algo::is_find(result, row)) {
-                                result.push_back(row);
-                            }
-                            else {
-                                SDL_ASSERT(!"push unique"); // to be tested
-                            }
+    sys_catalog const & c = catalog();
+    c.idxstats.for_key(id, [&c, data_type, &result](sysidxstats_row const * const idx) {
+        if (!idx->data.rowset.is_null()) {
+            c.allocunits.for_key(idx->data.rowset._64,
+                [data_type, &result](sysallocunits_row const * const row) {
+                    if (row->data.pgfirstiam && (row->data.type == data_type)) {
+                        if (!algo::is_find(result, row)) {
+                            result.push_back(row);
+                        }
+                        else {
+                            SDL_ASSERT(!"push unique"); // to be tested
                         }
                     }
-                    else {
-                        //SDL_TRACE("\nfind_sysalloc id=", idx->data.id._32, " name=", col_name_t(idx));
-                    }
+                    return true;
             });
         }
+        return true;
     });
     m_data->set_sysalloc(id, data_type, shared_result);
     return shared_result;
@@ -813,49 +1156,205 @@ database::find_datapage(schobj_id const id,
             }
         }
     }
-    // Heap tables won't have root pages
-    vector_page_head heap_pages;
+    // Heap tables won't have root pages; only IAM pages are read here, data pages are loaded by scan
+    reset_shared<class_heap_access>(result, this, find_extents(id, data_type), page_type);
+    m_data->set_datapage(id, data_type, page_type, result);
+    return result;
+}
+
+std::vector<pageFileID>
+database::find_datapage_ids(schobj_id const id,
+                            dataType::type const data_type,
+                            pageType::type const page_type) const
+{
+    std::vector<pageFileID> result;
+    if ((data_type == dataType::type::IN_ROW_DATA) && (page_type == pageType::type::data)) {
+        if (auto const index = get_cluster_index(id)) {
+            if (index->is_root_index()) {
+                return index_tree(this, index).leaf_pages();
+            }
+            SDL_ASSERT(index->is_root_data());
+            if (page_head const * p = load_pg_index(id, page_type).pgfirst()) {
+                for (; p; p = load_next_head(p)) {
+                    result.push_back(p->data.pageId);
+                }
+            }
+            return result;
+        }
+    }
+    for (heap_extent const & e : find_extents(id, data_type)) {
+        for (size_t i = 0; i < 8; ++i) {
+            if (e.mask & (1 << i)) {
+                pageFileID page = e.start;
+                page.pageId += static_cast<uint32>(i);
+                if (is_allocated(page)) {
+                    result.push_back(page);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+database::vector_heap_extent
+database::find_extents(schobj_id const id, dataType::type const data_type) const
+{
+    vector_heap_extent heap_extents;
     vector_sysallocunits_row const & sysalloc = *find_sysalloc(id, data_type);
     for (auto alloc : sysalloc) {
         A_STATIC_CHECK_TYPE(sysallocunits_row const *, alloc);
         SDL_ASSERT(alloc->data.type == data_type);
         for (auto const & page : iam_access(this, alloc)) {
             A_STATIC_CHECK_TYPE(shared_iam_page const &, page);
-            page->allocated_pages(this, [this, page_type, &heap_pages](pageFileID const & id) {
-                SDL_ASSERT(id);
-                if (auto p = this->load_page_head(id)) {
-                    if (p->data.type == page_type) {
-                        heap_pages.push_back(p);
+            if (iam_page_row const * const row = page->first()) {
+                for (pageFileID const & single : *row) { // mixed extent pages
+                    if (single) {
+                        pageFileID start = single;
+                        start.pageId &= ~uint32(7);
+                        heap_extents.push_back({ start, uint8(1 << (single.pageId & 7)) });
                     }
                 }
-                else {
-                    SDL_ASSERT(0);
-                }
-            });
+                page->allocated_extents([&heap_extents](pageFileID const & start) {
+                    heap_extents.push_back({ start, uint8(0xFF) });
+                });
+            }
         }
     }
-    if (1) {
-        std::sort(heap_pages.begin(), heap_pages.end(), 
-            [](page_head const * x, page_head const * y){
-            return (x->data.pageId < y->data.pageId);
-        });
+    std::sort(heap_extents.begin(), heap_extents.end(), 
+        [](heap_extent const & x, heap_extent const & y){
+        return x.start.compare(y.start) < 0;
+    });
+    if (!heap_extents.empty()) { // merge pages of the same extent
+        auto last = heap_extents.begin();
+        for (auto it = last + 1; it != heap_extents.end(); ++it) {
+            if (it->start.compare(last->start) == 0) {
+                last->mask |= it->mask;
+            }
+            else {
+                *(++last) = *it;
+            }
+        }
+        heap_extents.erase(last + 1, heap_extents.end());
     }
-    reset_shared<class_heap_access>(result, this, std::move(heap_pages));
-    m_data->set_datapage(id, data_type, page_type, result);
+    return heap_extents;
+}
+
+template<class fun_type>
+bool database::for_object_range(schobj_id const id, fun_type && fun) const
+{
+    if (use_page_bpool() && (file_count() == 1)) {
+        return false;
+    }
+    bool result = true;
+    for_dataType([this, id, &fun, &result](dataType::type const t) {
+        vector_heap_extent const extents = find_extents(id, t);
+        for (size_t i = 0, end = extents.size(); i < end; ) {
+            pageFileID const & start = extents[i].start;
+            size_t next = i + 1;
+            while ((next < end) && (extents[next].start.fileId == start.fileId) &&
+                (extents[next].start.pageId == extents[next - 1].start.pageId + 8)) {
+                ++next;
+            }
+            PageMapping const * const pmap = m_data->find_pmap(start.fileId);
+            if (!(pmap && fun(*pmap, pageIndex(start.pageId), (next - i) * 8))) {
+                result = false;
+            }
+            i = next;
+        }
+    });
     return result;
 }
 
+bool database::advise_object(schobj_id const id, map_advice const advice) const
+{
+    return for_object_range(id, [advice](PageMapping const & pmap, pageIndex const first, size_t const count) {
+        return pmap.advise(first, count, advice);
+    });
+}
+
+bool database::lock_object(schobj_id const id, bool const value) const
+{
+    return for_object_range(id, [value](PageMapping const & pmap, pageIndex const first, size_t const count) {
+        return pmap.lock(first, count, value);
+    });
+}
+
+page_faults database::get_page_faults()
+{
+    return PageMapping::get_page_faults();
+}
+
+page_head const *
+database::heap_access::find_page(size_t extent, size_t pos) const
+{
+    for (const size_t end = extents.size(); extent < end; ++extent, pos = 0) {
+        heap_extent const & e = extents[extent];
+        const uint32 bits = uint32(e.mask) >> pos;
+        if (!bits) {
+            continue;
+        }
+        // page_bpool reads whole extent (block) with first page of it, mapped file is advised when scan enters extent
+        if (!pos) {
+            const size_t first = algo::bit_scan_forward(e.mask);
+            size_t last = 8;
+            while (!(e.mask & (1 << (last - 1)))) {
+                --last;
+            }
+            pageFileID id = e.start;
+            id.pageId += static_cast<uint32>(first);
+            db->prefetch_file_pages(id, last - first);
+        }
+        for (size_t i = pos + algo::bit_scan_forward(bits); i < 8; ++i) {
+            if (e.mask & (1 << i)) {
+                pageFileID id = e.start;
+                id.pageId += static_cast<uint32>(i);
+                if (db->is_allocated(id)) {
+                    if (page_head const * const p = db->load_page_head(id)) {
+                        if (p->data.type == page_type) {
+                            return p;
+                        }
+                    }
+                    else {
+                        SDL_ASSERT(0);
+                    }
+                }
+            }
+        }
+    }
+    return nullptr;
+}
+
+page_head const *
+database::heap_access::next_page(page_head const * const p) const
+{
+    SDL_ASSERT(p);
+    pageFileID start = p->data.pageId;
+    start.pageId &= ~uint32(7);
+    auto const it = std::lower_bound(extents.begin(), extents.end(), start,
+        [](heap_extent const & x, pageFileID const & y){
+        return x.start.compare(y) < 0;
+    });
+    if ((it != extents.end()) && (it->start.compare(start) == 0)) {
+        return find_page(it - extents.begin(), (p->data.pageId.pageId & 7) + 1);
+    }
+    return find_page(it - extents.begin(), 0); // page is not in allocation unit
+}
+
 bool database::is_allocated(pageFileID const & id) const
 {
     if (!id.is_null()) {
-        if (id.pageId < (uint32)page_count()) { // check range
-            if (auto h = load_page_head(pfs_page::pfs_for_page(id))) {
-                return pfs_page(h)[id].b.allocated;
+        const size_t pageId = id.pageId;
+        if (id.fileId == pageFileID::primary_file) {
+            if (pageId < page_count()) { // check range
+                return load_pfs_bitmap(pageId, pageId + 1).is_allocated(pageId);
             }
         }
-        else {
-            SDL_ASSERT(0);
+        else if (auto const f = m_data->find_file(id.fileId)) {
+            if (pageId < f->pmap.page_count()) {
+                return load_pfs_bitmap(f->pfs_alloc, id.fileId, pageId, pageId + 1).is_allocated(pageId);
+            }
         }
+        SDL_ASSERT(0);
     }
     return false;
 }
@@ -883,19 +1382,14 @@ database::make_primary_key(schobj_id const table_id) const
 {
     shared_primary_key result;
     if (auto const pg = load_pg_index(table_id, pageType::type::data)) {
+        sys_catalog const & c = catalog();
         sysidxstats_row const * idx = 
-            find_if(_sysidxstats, [table_id](sysidxstats::const_pointer p) {
-                if ((p->data.id == table_id) && p->data.indid.is_clustered()) {
-                    return p->data.status.IsPrimaryKey();
-                }
-                return false;
+            c.idxstats.find_if(table_id, [](sysidxstats_row const * const p) {
+                return p->data.indid.is_clustered() && p->data.status.IsPrimaryKey();
             });
         if (!idx) {
-            idx = find_if(_sysidxstats, [table_id](sysidxstats::const_pointer p) {
-                if ((p->data.id == table_id) && p->data.indid.is_clustered()) {
-                    return p->data.status.IsUnique();
-                }
-                return false;
+            idx = c.idxstats.find_if(table_id, [](sysidxstats_row const * const p) {
+                return p->data.indid.is_clustered() && p->data.status.IsUnique();
             });
         }
         if (idx) {
@@ -904,10 +1398,11 @@ database::make_primary_key(schobj_id const table_id) const
             SDL_ASSERT(idx->data.indid.is_clustered());            
             
             std::vector<sysiscols_row const *> idx_stat;
-            for_row(_sysiscols, [table_id, idx, &idx_stat](sysiscols::const_pointer stat) {
-                if ((stat->data.idmajor == table_id) && (stat->data.idminor == idx->data.indid)) {
+            c.iscols.for_key(table_id, [idx, &idx_stat](sysiscols_row const * const stat) {
+                if (stat->data.idminor == idx->data.indid) {
                     idx_stat.push_back(stat);
                 }
+                return true;
             });
             if (!idx_stat.empty()) {
                 SDL_ASSERT(idx_stat.size() < 256); // we use sysiscols_row.tinyprop1 (1 byte) to sort columns
@@ -926,15 +1421,9 @@ database::make_primary_key(schobj_id const table_id) const
                 idx_ord.reserve(idx_stat.size());
                 for (sysiscols_row const * stat : idx_stat) {
                     SDL_ASSERT(stat->data.status.is_index());
-                    if (syscolpars_row const * const col = find_if(_syscolpars, 
-                        [table_id, stat](syscolpars::const_pointer p) {
-                            return (p->data.id == table_id) && (p->data.colid == stat->data.intprop);
-                        }))
+                    if (syscolpars_row const * const col = c.find_colpar(table_id, stat->data.intprop))
                     {
-                        const scalartype utype = col->data.utype;
-                        if (auto scal = find_if(_sysscalartypes, [utype](sysscalartypes::const_pointer p) {
-                            return (p->data.id == utype);
-                        })) 
+                        if (auto scal = c.find_scalartype(col->data.utype))
                         {
                             if (usertable::column::is_fixed(col, scal)) {
                                 idx_col.push_back(col);
@@ -973,6 +1462,12 @@ database::make_primary_key(schobj_id const table_id) const
 shared_primary_key
 database::get_primary_key(schobj_id const table_id) const
 {
+    if (auto const p = catalog().usertables.find(table_id)) {
+        return p->primary;
+    }
+    if (auto const p = catalog().internals.find(table_id)) {
+        return p->primary;
+    }
     {
         auto const found = m_data->get_primary_key(table_id);
         if (found.second) {
@@ -1046,6 +1541,149 @@ database::get_cluster_index(schobj_id const id) const
     return{};
 }
 
+shared_secondary_indexes
+database::get_secondary_index(schobj_id const table_id) const
+{
+    {
+        auto const found = m_data->get_secondary_index(table_id);
+        if (found.second) {
+            return found.first;
+        }
+    }
+    auto const result = make_secondary_index(table_id);
+    m_data->set_secondary_index(table_id, result);
+    return result;
+}
+
+shared_index_prefix
+database::load_index_prefix(page_head const * const head, make_index_prefix const & make) const
+{
+    SDL_ASSERT(head && head->is_index() && make);
+    if (!shared_data::admit_index_prefix(head)) {
+        return nullptr;
+    }
+    auto const found = m_data->get_index_prefix(head->data.pageId);
+    if (found.first || !found.second) {
+        return found.first;
+    }
+    auto const result = make();
+    m_data->set_index_prefix(head->data.pageId, result);
+    return result;
+}
+
+shared_secondary_index
+database::find_secondary_index(schobj_id const table_id, const char * const col_name) const
+{
+    SDL_ASSERT(is_str_valid(col_name));
+    shared_secondary_index result;
+    for (auto const & p : *get_secondary_index(table_id)) {
+        if ((*p)[0].name == col_name) {
+            if (!result || (p->is_unique() && !result->is_unique())) { // prefer unique index
+                result = p;
+            }
+        }
+    }
+    return result;
+}
+
+shared_secondary_indexes
+database::make_secondary_index(schobj_id const table_id) const
+{
+    auto const result = std::make_shared<vector_secondary_index>();
+    shared_usertable const schema = find_table_schema(table_id);
+    if (!schema) {
+        return result;
+    }
+    shared_cluster_index const cluster = get_cluster_index(schema);
+    sys_catalog const & c = catalog();
+    if (!cluster && c.idxstats.find_if(table_id, [](sysidxstats_row const * const p) {
+            return p->data.indid.is_clustered();
+        })) {
+        return result; // FIXME: bookmark of non-unique cluster index has uniquifier
+    }
+    for (sysidxstats_row const * const idx : index_for_table(table_id)) {
+        if ((idx->data.type != idxtype::nonclustered) || idx->data.rowset.is_null()) {
+            continue;
+        }
+        if (idx->data.status.IsDisabled() || idx->data.status.IsHypothetical() || idx->data.status.HasFilter()) {
+            continue; // filtered index does not contain all rows
+        }
+        sysallocunits_row const * const alloc = c.allocunits.find_if(idx->data.rowset._64, [](sysallocunits_row const * const p) {
+            return p->data.type == dataType::type::IN_ROW_DATA;
+        });
+        if (!(alloc && alloc->data.pgroot && is_allocated(alloc->data.pgroot))) {
+            continue; // index is empty
+        }
+        page_head const * const root = load_page_head(alloc->data.pgroot);
+        if (!(root && root->is_index() && slot_array::size(root))) {
+            continue;
+        }
+        std::vector<sysiscols_row const *> idx_stat;
+        c.iscols.for_key(table_id, [idx, &idx_stat](sysiscols_row const * const stat) {
+            if (stat->data.idminor == idx->data.indid) {
+                idx_stat.push_back(stat);
+            }
+            return true;
+        });
+        std::sort(idx_stat.begin(), idx_stat.end(), 
+            [](sysiscols_row const * x, sysiscols_row const * y) {
+                return x->data.tinyprop1 < y->data.tinyprop1;
+        });
+        secondary_index::column_index key, included;
+        secondary_index::column_order order;
+        bool fixed = true;
+        for (sysiscols_row const * const stat : idx_stat) {
+            const size_t i = schema->find_if([stat](usertable::column_ref c) {
+                return c.colpar->data.colid == stat->data.intprop;
+            });
+            if (i == schema->size()) {
+                SDL_ASSERT(!"make_secondary_index");
+                fixed = false;
+                break;
+            }
+            if (stat->data.status.is_index()) {
+                if (!schema->is_fixed(i)) { //FIXME: support only fixed columns as key
+                    fixed = false;
+                    break;
+                }
+                key.push_back(i);
+                order.push_back(stat->data.status.index_order());
+            }
+            else {
+                included.push_back(i);
+            }
+        }
+        if (fixed && !key.empty()) {
+            result->push_back(std::make_shared<secondary_index>(root, idx, schema,
+                std::move(key), std::move(order), included, cluster));
+        }
+    }
+    return result;
+}
+
+bool database::attach_snapshot(shared_column_snapshot const & snapshot)
+{
+    SDL_ASSERT(snapshot);
+    if (auto const table = find_table(snapshot->table_id())) {
+        if (snapshot->is_valid(*table)) {
+            m_data->set_snapshot(snapshot->table_id(), snapshot);
+            return true;
+        }
+    }
+    return false;
+}
+
+void database::detach_snapshot(schobj_id const id)
+{
+    m_data->set_snapshot(id, {});
+}
+
+shared_column_snapshot
+database::get_column_snapshot(schobj_id const id) const
+{
+    return m_data->get_snapshot(id);
+}
+
 page_head const *
 database::get_cluster_root(schobj_id const id) const
 {
@@ -1150,8 +1788,8 @@ database::index_for_table(schobj_id const id) const
 {
     using T = vector_sysidxstats_row;
     T result;
-    for_row(_sysidxstats, [id, &result](sysidxstats::const_pointer idx) {
-        if ((idx->data.id == id) && idx->data.indid.is_index()) {
+    catalog().idxstats.for_key(id, [&result](sysidxstats_row const * const idx) {
+        if (idx->data.indid.is_index()) {
             switch (idx->data.type) {
             case idxtype::clustered:
             case idxtype::nonclustered:
@@ -1162,6 +1800,7 @@ database::index_for_table(schobj_id const id) const
                 break; // _WA_Sys_00000002_182C9B23 (used for statistics)
             }
         }
+        return true;
     });
     std::sort(result.begin(), result.end(),
         [](T::value_type const & x, T::value_type const & y){
@@ -1173,16 +1812,18 @@ database::index_for_table(schobj_id const id) const
 sysidxstats_row const * database::find_spatial_type(const std::string & index_name, idxtype::type const type) const
 {
     SDL_ASSERT(!index_name.empty());
-    sysidxstats_row const * const idx = 
-    find_if(_sysidxstats, [&index_name, type](sysidxstats::const_pointer idx) {
-        if ((idx->data.type == type) && (idx->name() == index_name)) {
-            SDL_ASSERT_1((idx->data.indid._32 == 1) == (type == idxtype::clustered));
-            SDL_ASSERT_1((idx->data.indid._32 == 384000) == (type == idxtype::spatial));
-            return true;
+    auto const & names = catalog().idxstats_name;
+    auto const found = names.find(index_name);
+    if (found != names.end()) {
+        for (sysidxstats_row const * const idx : found->second) {
+            if (idx->data.type == type) {
+                SDL_ASSERT_1((idx->data.indid._32 == 1) == (type == idxtype::clustered));
+                SDL_ASSERT_1((idx->data.indid._32 == 384000) == (type == idxtype::spatial));
+                return idx;
+            }
         }
-        return false;
-    });
-    return idx;
+    }
+    return nullptr;
 }
 
 sysallocunits_row const *
@@ -1208,11 +1849,8 @@ database::find_spatial_alloc(const std::string & index_name) const
 sysidxstats_row const * database::find_spatial_idx(schobj_id const table_id) const
 {
     sysidxstats_row const * const idx = 
-    find_if(_sysidxstats, [table_id](sysidxstats::const_pointer idx) {
-        if ((idx->data.type == idxtype::spatial) && (idx->data.id == table_id)) {
-            return true;
-        }
-        return false;
+    catalog().idxstats.find_if(table_id, [](sysidxstats_row const * const idx) {
+        return idx->data.type == idxtype::spatial;
     });
     if (idx) {
         SDL_ASSERT(idx->data.id == table_id);
@@ -1307,6 +1945,9 @@ pageFileID fwd::prevPageID(database const * d, pageFileID const & it) {
 bool fwd::is_allocated(database const * d, pageFileID const & it) {
     return d->is_allocated(it);
 }
+shared_index_prefix fwd::load_index_prefix(database const * d, page_head const * p, make_index_prefix const & make) {
+    return d->load_index_prefix(p, make);
+}
 //----------------------------------------------------------
 
 } // db
@@ -1332,15 +1973,39 @@ linked list of pages using the PrevPage, ThisPage, and NextPage page locators, w
 ------------------------------------------------------
 #endif
 
-#if 0 //SDL_DEBUG
+#if SDL_DEBUG
 namespace sdl {
     namespace db {
         namespace {
             class unit_test {
+                struct test_pmap { // records prefetch of PageMapping
+                    using run_type = std::pair<uint32, size_t>;
+                    mutable std::vector<run_type> runs;
+                    void prefetch(pageIndex const i, size_t const count) const {
+                        runs.emplace_back(i.value(), count);
+                    }
+                };
             public:
                 unit_test()
                 {
                     SDL_TRACE_FILE;
+                    using run_type = test_pmap::run_type;
+                    test_pmap pmap[4]; // pmap[3] is secondary file with id 3
+                    std::vector<pageFileID> pages {
+                        pageFileID::init(5), pageFileID::init(6), 
+                        pageFileID::init(10, 3), pageFileID::init(11, 3), pageFileID::init(13, 3) };
+                    std::vector<uint16> order;
+                    for_file_pages(pages.data(), pages.size(), [&pmap, &order](uint16 const fileId, pageFileID const * const range, size_t const size) {
+                        for (size_t i = 0; i < size; ++i) {
+                            SDL_ASSERT(range[i].fileId == fileId);
+                        }
+                        order.push_back(fileId);
+                        prefetch_runs(pmap[fileId], range, size);
+                    });
+                    SDL_ASSERT((order == std::vector<uint16>{ 3, pageFileID::primary_file }));
+                    SDL_ASSERT((pmap[3].runs == std::vector<run_type>{ { 10, 2 }, { 13, 1 } }));
+                    SDL_ASSERT((pmap[1].runs == std::vector<run_type>{ { 5, 2 } }));
+                    SDL_ASSERT(pmap[0].runs.empty() && pmap[2].runs.empty());
                 }
             };
             static unit_test s_test;
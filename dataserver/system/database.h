@@ -7,6 +7,8 @@
 #include "dataserver/system/datatable.h"
 #include "dataserver/system/overflow.h"
 #include "dataserver/system/database_cfg.h"
+#include "dataserver/system/pfs_bitmap.h"
+#include "dataserver/system/column_snapshot.h"
 #include "dataserver/bpool/flag_type.h"
 
 namespace sdl { namespace db {
@@ -236,27 +238,50 @@ private:
             return nullptr == p;
         }
     };
+public:
+    struct heap_extent { // extent of heap allocation unit
+        pageFileID start;   // first page of extent
+        uint8 mask;         // bit i is set if page (start + i) belongs to allocation unit
+    };
+    using vector_heap_extent = std::vector<heap_extent>;
+private:
+    // Pages of heap are visited in page order of IAM extents and loaded only when scan reaches them.
     class heap_access: noncopyable {
-        vector_page_head const data;
+        database const * const db;
+        vector_heap_extent const extents; // sorted by start
+        pageType::type const page_type;
     public:
-        using iterator = vector_page_head::const_iterator;
-        heap_access(database const *, vector_page_head && v): data(std::move(v)) {}
+        using iterator = forward_iterator<heap_access const, page_head const *>;
+        heap_access(database const * p, vector_heap_extent && v, pageType::type t)
+            : db(p), extents(std::move(v)), page_type(t) {
+            SDL_ASSERT(db);
+        }
         iterator begin() const {
-            return data.begin();
+            page_head const * p = find_page(0, 0);
+            return iterator(this, std::move(p));
         }
         iterator end() const {
-            return data.end();
+            return iterator(this);
         }
         template<class page_pos>
         page_head const * load_next_head(page_pos const & p) const {
-            A_STATIC_CHECK_TYPE(size_t, p.second);
-            size_t const i = p.second + 1;
-            SDL_ASSERT(i <= data.size());
-            if (i < data.size()) {
-                return data[i];
-            }
-            return nullptr; 
+            A_STATIC_CHECK_TYPE(page_head const *, p.first);
+            return next_page(p.first);
+        }
+    private:
+        friend iterator;
+        static page_head const * dereference(page_head const * p) {
+            return p;
+        }
+        void load_next(page_head const * & p) const {
+            SDL_ASSERT(p);
+            p = next_page(p);
         }
+        static bool is_end(page_head const * const p) {
+            return nullptr == p;
+        }
+        page_head const * next_page(page_head const *) const;
+        page_head const * find_page(size_t extent, size_t pos) const; // first page from pos in extent
     };
 private:
     template<class T> // T = clustered_access | heap_access
@@ -303,8 +328,7 @@ private:
         }
         return nullptr;
     }   
-    template<class fun_type> unique_datatable find_table_if(fun_type &&) const;
-    template<class fun_type> unique_datatable find_internal_if(fun_type &&) const;
+    unique_datatable make_datatable(shared_usertable const &) const;
 private:
     class pgroot_pgfirst {
         page_head const * m_pgroot = nullptr;  // root page of the index tree
@@ -329,12 +353,33 @@ public:
     database_cfg const & cfg() const;
     bool is_open() const;
 
-    size_t page_count() const;
-    size_t page_allocated() const;
+    size_t page_count() const; // primary file
+    size_t page_allocated() const; // all opened data files
+    size_t file_count() const; // data files including primary file (see database_cfg::data_files)
+    std::vector<uint16> file_ids() const; // opened data files, primary file first
+    size_t file_page_count(uint16 fileId) const; // 0 if data file is not opened
 
     std::string dbi_dbname() const;
     bool use_page_bpool() const;
+    size_t pool_block_read() const; // blocks read from file by page_bpool, 0 if pool is not used
 public:
+    // counts pages loaded by calling thread while in scope;
+    // counter of worker thread can be linked to counter of calling thread
+    class scoped_page_count : noncopyable {
+        scoped_page_count * const m_prev;
+        scoped_page_count * const m_link;
+        std::atomic<size_t> m_count{ 0 };
+    public:
+        explicit scoped_page_count(scoped_page_count * link = nullptr);
+        ~scoped_page_count();
+        size_t count() const {
+            return m_count.load(std::memory_order_relaxed);
+        }
+        static scoped_page_count * current(); // nullptr if not counted
+    private:
+        friend database;
+        static void add_page();
+    };
     class scoped_thread_lock : noncopyable { // should be not used in main thread
         const database & m_db;
         const bpool::removef remove_id;
@@ -374,6 +419,11 @@ public:
     page_head const * load_page_head(pageIndex) const;
     page_head const * load_page_head(pageFileID const &) const;
 
+    // read-ahead of pages which will be loaded soon: ids are sorted and made unique, contiguous runs of pages
+    // are advised to file mapping (asynchronous read); with page_bpool pages are loaded now in file order;
+    // pages of secondary files are advised by one task per file if ids refer to several files
+    void prefetch_pages(std::vector<pageFileID> &) const;
+
     page_head const * load_next_head(page_head const *) const;
     page_head const * load_prev_head(page_head const *) const;
 
@@ -432,10 +482,32 @@ public:
     shared_primary_key get_primary_key(schobj_id) const;
     shared_cluster_index get_cluster_index(shared_usertable const &) const;
     shared_cluster_index get_cluster_index(schobj_id) const; 
+
+    // non-clustered indexes of table with fixed-length key columns
+    shared_secondary_indexes get_secondary_index(schobj_id) const;
+    shared_secondary_index find_secondary_index(schobj_id, const char * col_name) const; // col_name is first key column
+
+    // key prefixes of index page, made once and cached for limited number of pages; nullptr if cache is full
+    shared_index_prefix load_index_prefix(page_head const *, make_index_prefix const &) const;
+    
+    // columnar snapshot of table used by make_query scans, see column_snapshot.h
+    bool attach_snapshot(shared_column_snapshot const &); // false if snapshot does not match data pages of table
+    void detach_snapshot(schobj_id);
+    shared_column_snapshot get_column_snapshot(schobj_id) const;
     page_head const * get_cluster_root(schobj_id) const; 
     
     shared_sysallocunits find_sysalloc(schobj_id, dataType::type) const;
     shared_page_head_access find_datapage(schobj_id, dataType::type, pageType::type) const;
+    // pages of find_datapage in the same order, only index and IAM pages are loaded;
+    // heap pages are allocated pages of extents, so page type is checked by caller when page is loaded
+    std::vector<pageFileID> find_datapage_ids(schobj_id, dataType::type, pageType::type) const;
+    vector_heap_extent find_extents(schobj_id, dataType::type) const; // extents of IAM pages in page order
+
+    // access pattern of file mapping for extents of object (all data types);
+    // false if page_bpool is used and object has extents in primary file
+    bool advise_object(schobj_id, map_advice) const;
+    bool lock_object(schobj_id, bool) const; // keep pages of object in memory; false if failed
+    static page_faults get_page_faults();
     vector_mem_range_t var_data(row_head const *, size_t, scalartype::type) const;
     template<scalartype::type col_type>
     vector_mem_range_t var_data_t(row_head const *, size_t) const;
@@ -482,9 +554,39 @@ public:
         return {};
     }
 public:
-    using checksum_fun = std::function<bool(page_head const *)>; // called if checksum not valid
+    // calls fun(pageFileID) for allocated pages in range [first, last) of page index;
+    // unallocated pages are skipped by bit scan of pfs_bitmap, fun returns bool or break_or_continue
+    template<class fun_type> break_or_continue for_allocated_pages(size_t first, size_t last, fun_type &&) const;
+    template<class fun_type> break_or_continue for_allocated_pages(fun_type && fun) const {
+        return for_allocated_pages(0, page_count(), std::forward<fun_type>(fun));
+    }
+    // same for pages of data file fileId (primary or secondary)
+    template<class fun_type> break_or_continue for_allocated_pages(uint16 fileId, size_t first, size_t last, fun_type &&) const;
+public:
+    struct checksum_progress {
+        size_t page_count = 0;      // pages in data files
+        size_t page_scan = 0;       // pages scanned (allocated or not)
+        size_t page_check = 0;      // allocated pages verified
+        size_t page_fail = 0;       // pages with invalid checksum
+        size_t milliseconds = 0;    // elapsed time
+        double MB_per_sec() const;  // throughput of verified pages
+    };
+    using checksum_fun = std::function<bool(page_head const *)>; // called if checksum not valid, serialized between threads
+    using progress_fun = std::function<void(checksum_progress const &)>; // called in calling thread
+    // pages of all opened data files are verified in worker threads, each thread takes next PFS interval (contiguous pages of one file);
+    // thread_count = 0 means hardware concurrency
+    break_or_continue scan_checksum(checksum_fun, progress_fun, size_t thread_count = 0) const;
     break_or_continue scan_checksum(checksum_fun) const;
     break_or_continue scan_checksum() const;
+public:
+    struct open_stat { // milliseconds of database open phases
+        size_t catalog = 0;         // system tables decoded into catalog
+        size_t usertable = 0;       // schema of user and internal tables
+        size_t datatable = 0;       // datatable objects
+        size_t init_tables = 0;     // state of tables, see database_cfg::init_tables
+        size_t total = 0;
+    };
+    open_stat const & get_open_stat() const;
 private:
     template<class fun_type> void for_USER_TABLE(fun_type const &) const;
     template<class fun_type> void for_INTERNAL_TABLE(fun_type const &) const;
@@ -495,6 +597,11 @@ private:
     shared_datatables get_datatables() const;
 
     page_head const * load_page_head(sysPage) const;
+    page_head const * load_file_page(pageFileID const &) const; // page of secondary data file
+    void prefetch_file_pages(pageFileID const & first, size_t count) const; // read-ahead of mapped file, no-op for page_bpool
+    pfs_bitmap const & load_pfs_bitmap(size_t first, size_t last) const; // loads PFS intervals of pages [first, last)
+    pfs_bitmap const & load_pfs_bitmap(pfs_bitmap &, uint16 fileId, size_t first, size_t last) const;
+    pfs_bitmap const & load_file_pfs_bitmap(uint16 fileId, size_t first, size_t last) const;
     std::vector<page_head const *> load_page_list(page_head const *) const;
 
     sysidxstats_row const * find_spatial_type(const std::string & index_name, idxtype::type) const;
@@ -502,10 +609,17 @@ private:
     sysallocunits_row const * find_spatial_alloc(const std::string & index_name) const;
 
     shared_primary_key make_primary_key(schobj_id) const;
+    shared_secondary_indexes make_secondary_index(schobj_id) const;
 private:
     void init_database();
+    void init_catalog();
     void init_datatable(shared_usertable const &);
+    void init_datatables(vector_shared_usertable const &);
+    template<class fun_type> // fun(PageMapping const &, pageIndex, size_t count) for contiguous extents
+    bool for_object_range(schobj_id, fun_type &&) const;
     using database_error = sdl_exception_t<database>;
+    class sys_catalog;
+    sys_catalog const & catalog() const;
     class shared_data;
     const std::unique_ptr<shared_data> m_data;
 };
@@ -19,8 +19,30 @@ template<class T> inline const char * page_name() {
     return page_name_t(identity<T>());
 }
 
+template<class fun_type>
+break_or_continue database::for_allocated_pages(size_t const first, size_t const last, fun_type && fun) const
+{
+    return for_allocated_pages(pageFileID::primary_file, first, last, std::forward<fun_type>(fun));
+}
+
+template<class fun_type>
+break_or_continue database::for_allocated_pages(uint16 const fileId, size_t first, size_t const last, fun_type && fun) const
+{
+    SDL_ASSERT(first <= last);
+    SDL_ASSERT(last <= file_page_count(fileId));
+    pfs_bitmap const & bitmap = load_file_pfs_bitmap(fileId, first, last);
+    for (first = bitmap.find_next(first, last); first < last; first = bitmap.find_next(first + 1, last)) {
+        if (is_break(make_break_or_continue(fun(pageFileID::init(static_cast<uint32>(first), fileId))))) {
+            return break_or_continue::break_;
+        }
+    }
+    return break_or_continue::continue_;
+}
+
+// pages of secondary data files are mapped : always locked and fixed
+
 inline bool database::unlock_page(pageFileID const & id) const {
-    if (id) {
+    if (id.fileId == pageFileID::primary_file) {
         return this->unlock_page(id.pageId);
     }
     return false;
@@ -28,38 +50,44 @@ inline bool database::unlock_page(pageFileID const & id) const {
 
 inline bool database::unlock_page(page_head const * const p) const {
     if (p) {
-        return this->unlock_page(p->data.pageId.pageId);
+        return this->unlock_page(p->data.pageId);
     }
     return false;
 }
 
 inline page_head const *
 database::lock_page_fixed(pageFileID const & id) const {
-    if (id) {
+    if (id.fileId == pageFileID::primary_file) {
         return this->lock_page_fixed(id.pageId);
     }
+    if (id) {
+        return this->load_file_page(id);
+    }
     return nullptr;
 }
 
 inline bool database::page_is_locked(pageFileID const & id) const {
-    if (id) {
+    if (id.fileId == pageFileID::primary_file) {
         return this->page_is_locked(id.pageId);
     }
-    return false;
+    return !id.is_null();
 }
 
 inline bool database::page_is_fixed(pageFileID const & id) const {
-    if (id) {
+    if (id.fileId == pageFileID::primary_file) {
         return this->page_is_fixed(id.pageId);
     }
-    return false;
+    return !id.is_null();
 }
 
 inline page_head const *
 database::load_page_head(pageFileID const & id) const {
-    if (id) {
+    if (id.fileId == pageFileID::primary_file) {
         return this->load_page_head(id.pageId);
     }
+    if (id) {
+        return this->load_file_page(id);
+    }
     return nullptr;
 }
 
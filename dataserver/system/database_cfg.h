@@ -5,6 +5,7 @@
 #define __SDL_SYSTEM_DATABASE_CFG_H__
 
 #include "dataserver/common/common.h"
+#include "dataserver/filesys/file_map.h"
 
 namespace sdl { namespace db {
 
@@ -16,6 +17,13 @@ struct database_cfg {
     size_t pool_period = default_period; // used to decommit free blocks
     size_t pool_defrag = default_defrag; // used to defragment pool memory (= 0 to disable)
     bool use_page_bpool = false;
+    enum class init_tables { serial, parallel, lazy };  // state of tables (allocation units, index roots, keys) at open
+    init_tables init = init_tables::serial;             // parallel and lazy are used without page_bpool only
+    size_t init_threads = 0;                            // init_tables::parallel : 0 = hardware concurrency
+    map_advice advice = map_advice::normal; // access pattern of whole file mapping (without page_bpool)
+    size_t map_populate = 0;                // file is read when mapped if its size is not greater (megabytes), 0 = never
+    std::vector<std::string> data_files;    // secondary data files (.ndf), file id is read from file header page
+    size_t geo_cache = 0;                   // geographies decoded by spatial seeks of make_query, kept by pk0 (megabytes), 0 = off
     database_cfg() = default;
     explicit database_cfg(bool b) noexcept : use_page_bpool(b) {}
     database_cfg(const size_t s1, const size_t s2) noexcept 
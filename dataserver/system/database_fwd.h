@@ -5,6 +5,7 @@
 #define __SDL_SYSTEM_DATABASE_FWD_H__
 
 #include "dataserver/system/page_type.h"
+#include "dataserver/system/index_prefix.h"
 
 namespace sdl { namespace db {
 
@@ -20,6 +21,7 @@ struct fwd : is_static {
     static pageFileID nextPageID(database const *, pageFileID const &);
     static pageFileID prevPageID(database const *, pageFileID const &);
     static bool is_allocated(database const *, pageFileID const &);
+    static shared_index_prefix load_index_prefix(database const *, page_head const *, make_index_prefix const &);
 };
 
 } // db
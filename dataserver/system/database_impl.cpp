@@ -2,6 +2,7 @@
 //
 #include "dataserver/system/database.h"
 #include "dataserver/system/database_impl.h"
+#include <future>
 
 namespace sdl { namespace db {
 
@@ -12,7 +13,32 @@ database_PageMapping::database_PageMapping(const std::string & fname, database_c
         reset_new(m_pool, fname, cfg);
     }
     else {
-        reset_new(m_pmap, fname);
+        reset_new(m_pmap, fname, cfg);
+    }
+    if (!cfg.data_files.empty()) {
+        open_files(cfg);
+    }
+}
+
+void database_PageMapping::open_files(database_cfg const & cfg)
+{
+    // files are mapped concurrently (and read if populated), each file can be on its own disk
+    std::vector<std::future<std::unique_ptr<data_file>>> opened;
+    for (std::string const & fname : cfg.data_files) {
+        opened.push_back(std::async(std::launch::async, [&fname, &cfg]() {
+            return std::make_unique<data_file>(fname, cfg);
+        }));
+    }
+    for (auto & f : opened) {
+        std::unique_ptr<data_file> file = f.get();
+        const uint16 fileId = file->file_id();
+        throw_error_if<database_PageMapping_error>(!fileId || (fileId == pageFileID::primary_file), "bad file id");
+        if (m_files.size() <= fileId) {
+            m_files.resize(fileId + 1);
+        }
+        throw_error_if<database_PageMapping_error>(m_files[fileId] != nullptr, "duplicate file id");
+        m_files[fileId] = std::move(file);
+        ++m_file_count;
     }
 }
 
@@ -35,5 +61,16 @@ std::thread::id database_PageMapping::init_thread_id() const
     return m_pool ? m_pool->init_thread_id : m_pmap->init_thread_id;
 }
 
+PageMapping const * database_PageMapping::find_pmap(uint16 const fileId) const
+{
+    if (fileId == pageFileID::primary_file) {
+        return m_pmap.get();
+    }
+    if (data_file const * const f = find_file(fileId)) {
+        return &(f->pmap);
+    }
+    return nullptr;
+}
+
 } // db
 } // sdl
\ No newline at end of file
@@ -4,16 +4,29 @@
 #ifndef __SDL_SYSTEM_DATABASE_IMPL_H__
 #define __SDL_SYSTEM_DATABASE_IMPL_H__
 
-#include "dataserver/common/map_enum.h"
-#include "dataserver/common/compact_map.h"
+#include "dataserver/common/snapshot_map.h"
+#include "dataserver/common/sharded_map.h"
 #include "dataserver/system/page_map.h"
 #include "dataserver/bpool/page_bpool.h"
+#include "dataserver/system/pfs_bitmap.h"
+#include <unordered_map>
 
 namespace sdl { namespace db {
 
 class database_PageMapping : noncopyable {
     using page_bpool = bpool::page_bpool;
 public:
+    // secondary data file is mapped also with page_bpool and has its own allocation bitmap
+    class data_file : noncopyable {
+    public:
+        PageMapping const pmap;
+        pfs_bitmap pfs_alloc; // loaded lazily
+        data_file(const std::string & fname, database_cfg const & cfg)
+            : pmap(fname, cfg), pfs_alloc(pmap.page_count()) {}
+        uint16 file_id() const { // from header page of file
+            return pmap.lock_page(0)->data.pageId.fileId;
+        }
+    };
     database_PageMapping(const std::string & fname, database_cfg const &);
     ~database_PageMapping();
     database_cfg const & cfg() const {
@@ -33,31 +46,160 @@ public:
         return * m_pmap.get();
     }
     bool is_open() const;
-    size_t page_count() const;
+    size_t page_count() const; // primary file
     std::thread::id init_thread_id() const;
+    size_t file_count() const { // including primary file
+        return m_file_count;
+    }
+    data_file * find_file(uint16 const fileId) const { // secondary file or nullptr
+        return (fileId < m_files.size()) ? m_files[fileId].get() : nullptr;
+    }
+    PageMapping const * find_pmap(uint16 fileId) const; // nullptr for primary file with page_bpool
+    std::vector<uint16> file_ids() const { // secondary files in order of file id
+        std::vector<uint16> result;
+        for (size_t i = 0; i < m_files.size(); ++i) {
+            if (m_files[i]) {
+                result.push_back(static_cast<uint16>(i));
+            }
+        }
+        return result;
+    }
 private:
+    void open_files(database_cfg const &);
+    using database_PageMapping_error = sdl_exception_t<database_PageMapping>;
     database_cfg const m_cfg;
     std::unique_ptr<bpool::page_bpool> m_pool;
     std::unique_ptr<PageMapping const> m_pmap;
+    std::vector<std::unique_ptr<data_file>> m_files; // indexed by file id
+    size_t m_file_count = 1;
+};
+
+// System tables decoded in one pass at open, rows are grouped by object (or owner) id in page order;
+// tables are hashed by name and id when schema is loaded. Catalog is made in init_database() and
+// is not changed after that, so it is read without lock.
+class database::sys_catalog final : noncopyable {
+public:
+    template<class key_type, class row_type>
+    class group_index : noncopyable {
+        using value_type = std::pair<key_type, row_type const *>;
+        std::vector<value_type> m_data;
+    public:
+        void push_back(key_type const & key, row_type const * const row) {
+            m_data.emplace_back(key, row);
+        }
+        void sort() { // keeps page order of rows with equal key
+            std::stable_sort(m_data.begin(), m_data.end(), [](value_type const & x, value_type const & y) {
+                return x.first < y.first;
+            });
+            m_data.shrink_to_fit();
+        }
+        size_t size() const {
+            return m_data.size();
+        }
+        template<class fun_type> // fun(row_type const *) returns bool or break_or_continue
+        break_or_continue for_key(key_type const & key, fun_type && fun) const {
+            auto it = std::lower_bound(m_data.begin(), m_data.end(), key, [](value_type const & x, key_type const & k) {
+                return x.first < k;
+            });
+            for (; (it != m_data.end()) && !(key < it->first); ++it) {
+                if (is_break(make_break_or_continue(fun(it->second)))) {
+                    return bc::break_;
+                }
+            }
+            return bc::continue_;
+        }
+        template<class fun_type> // fun(row_type const *) returns bool
+        row_type const * find_if(key_type const & key, fun_type && fun) const {
+            row_type const * result = nullptr;
+            for_key(key, [&fun, &result](row_type const * const row) {
+                if (fun(row)) {
+                    result = row;
+                    return false;
+                }
+                return true;
+            });
+            return result;
+        }
+    };
+    group_index<schobj_id, syscolpars_row> colpars;             // by table id
+    group_index<scalartype, sysscalartypes_row> scalartypes;    // by type id
+    group_index<schobj_id, sysidxstats_row> idxstats;           // by table id
+    group_index<schobj_id, sysiscols_row> iscols;               // by table id (idmajor)
+    group_index<uint64, sysallocunits_row> allocunits;          // by owner id (rowset of sysidxstats)
+    std::unordered_map<std::string, vector_sysidxstats_row> idxstats_name; // in page order
+
+    class table_index : noncopyable {
+    public:
+        struct entry_type {
+            shared_usertable schema;
+            shared_primary_key primary;
+        };
+        void insert(shared_usertable const & schema, shared_primary_key const & primary) {
+            m_name.emplace(schema->name(), schema); // first of equal names as in sorted vector_shared_usertable
+            m_id.emplace(schema->get_id()._32, entry_type{ schema, primary });
+        }
+        shared_usertable find(std::string const & name) const {
+            auto const it = m_name.find(name);
+            return (it != m_name.end()) ? it->second : shared_usertable();
+        }
+        entry_type const * find(schobj_id const id) const {
+            auto const it = m_id.find(id._32);
+            return (it != m_id.end()) ? &(it->second) : nullptr;
+        }
+    private:
+        std::unordered_map<std::string, shared_usertable> m_name;
+        std::unordered_map<schobj_id::type, entry_type> m_id;
+    };
+    table_index usertables;
+    table_index internals;
+
+    sysscalartypes_row const * find_scalartype(scalartype const utype) const {
+        return scalartypes.find_if(utype, [](sysscalartypes_row const *) {
+            return true;
+        });
+    }
+    syscolpars_row const * find_colpar(schobj_id const table_id, column_id const colid) const {
+        return colpars.find_if(table_id, [colid](syscolpars_row const * const p) {
+            return p->data.colid == colid;
+        });
+    }
 };
 
 class database::shared_data final : public database_PageMapping {
-    using map_sysalloc = compact_map<schobj_id, shared_sysallocunits>;
-    using map_datapage = compact_map<schobj_id, shared_page_head_access>;
-    using map_index = compact_map<schobj_id, pgroot_pgfirst>;
-    using map_primary = compact_map<schobj_id, shared_primary_key>;
-    using map_cluster = compact_map<schobj_id, shared_cluster_index>;
-    using map_spatial_tree = compact_map<schobj_id, spatial_tree_idx>;
+    struct hash_schobj_id {
+        size_t operator()(schobj_id const & id) const {
+            return static_cast<size_t>(id._32);
+        }
+    };
+    template<class key_type, class value_type>
+    using map_type = snapshot_map<key_type, value_type, hash_schobj_id>;
+    using map_sysalloc = map_type<schobj_id, shared_sysallocunits>;
+    using map_datapage = map_type<schobj_id, shared_page_head_access>;
+    using map_index = map_type<schobj_id, pgroot_pgfirst>;
+    using map_primary = map_type<schobj_id, shared_primary_key>;
+    using map_cluster = map_type<schobj_id, shared_cluster_index>;
+    using map_spatial_tree = map_type<schobj_id, spatial_tree_idx>;
+    using map_snapshot = map_type<schobj_id, shared_column_snapshot>;
+    using map_secondary = map_type<schobj_id, shared_secondary_indexes>;
+    struct hash_page_id {
+        size_t operator()(pageFileID const & id) const {
+            return id.pageId ^ (size_t(id.fileId) << 16);
+        }
+    };
+    using map_index_prefix = sharded_map<pageFileID, shared_index_prefix, hash_page_id>; // filled on query path
     struct data_type {
         shared_usertables usertable;
         shared_usertables internal;
         shared_datatables datatable;
-        map_enum_1<map_sysalloc, dataType> sysalloc;
-        map_enum_2<map_datapage, dataType, pageType> datapage; // not preloaded in init_database()
-        map_enum_1<map_index, pageType> index;
+        map_sysalloc sysalloc[dataType::size];
+        map_datapage datapage[dataType::size][pageType::size]; // not preloaded in init_database()
+        map_index index[pageType::size];
         map_primary primary;
         map_cluster cluster;
         map_spatial_tree spatial_tree;
+        map_snapshot snapshot;
+        map_secondary secondary;
+        map_index_prefix index_prefix;
         data_type()
             : usertable(std::make_shared<vector_shared_usertable>())
             , internal(std::make_shared<vector_shared_usertable>())
@@ -67,10 +209,15 @@ class database::shared_data final : public database_PageMapping {
 public:
     bool initialized = false;
     const std::string filename;
+    std::unique_ptr<sys_catalog> catalog; // made in init_database
+    open_stat stat;
+    pfs_bitmap pfs_alloc; // allocation bitmap, loaded lazily
     shared_data(const std::string & fname, database_cfg const & cfg)
         : database_PageMapping(fname, cfg)
         , filename(fname)
+        , pfs_alloc(page_count())
     {}
+    // tables are set in init_database() and not changed after that
     shared_usertables & usertable() { // get/set shared_ptr only
         return m_data.usertable;
     } 
@@ -80,99 +227,106 @@ public:
     shared_datatables & datatable() {
         return m_data.datatable;
     }
-    bool empty_usertable() {
-        lock_guard lock(m_mutex);
+    bool empty_usertable() const {
         return m_data.usertable->empty();
     }
-    bool empty_internal() {
-        lock_guard lock(m_mutex);
+    bool empty_internal() const {
         return m_data.internal->empty();
     }
-    bool empty_datatable() {
-        lock_guard lock(m_mutex);
+    bool empty_datatable() const {
         return m_data.datatable->empty();
     }
-    std::pair<shared_sysallocunits, bool> 
-    find_sysalloc(schobj_id const id, dataType::type const data_type) {
-        lock_guard lock(m_mutex);
-        if (auto found = m_data.sysalloc.find(id, data_type)) {
-            return { *found, true };
+    // maps of table state are read without lock after publish(); state of tables loaded later (init_tables::lazy) is in shards
+    void publish() {
+        for (auto & m : m_data.sysalloc) {
+            m.publish();
+        }
+        for (auto & a : m_data.datapage) {
+            for (auto & m : a) {
+                m.publish();
+            }
         }
-        return{};
+        for (auto & m : m_data.index) {
+            m.publish();
+        }
+        m_data.primary.publish();
+        m_data.cluster.publish();
+        m_data.spatial_tree.publish();
+        m_data.snapshot.publish();
+        m_data.secondary.publish();
+    }
+    std::pair<shared_sysallocunits, bool> 
+    find_sysalloc(schobj_id const id, dataType::type const data_type) const {
+        return m_data.sysalloc[static_cast<int>(data_type)].find(id);
     }
     void set_sysalloc(schobj_id const id, dataType::type const data_type,
                       shared_sysallocunits const & value) {
-        lock_guard lock(m_mutex);
-        m_data.sysalloc(id, data_type) = value;
+        m_data.sysalloc[static_cast<int>(data_type)].set(id, value);
     }
     std::pair<shared_page_head_access, bool>
-    find_datapage(schobj_id const id, dataType::type const data_type, pageType::type const page_type) {
-        lock_guard lock(m_mutex);
-        if (auto found = m_data.datapage.find(id, data_type, page_type)) {
-            return { *found, true };
-        }
-        return{};
+    find_datapage(schobj_id const id, dataType::type const data_type, pageType::type const page_type) const {
+        return m_data.datapage[static_cast<int>(data_type)][static_cast<int>(page_type)].find(id);
     }
     void set_datapage(schobj_id const id, 
                       dataType::type const data_type,
                       pageType::type const page_type,
                       shared_page_head_access const & value) {
-        lock_guard lock(m_mutex);
-        m_data.datapage(id, data_type, page_type) = value;
+        m_data.datapage[static_cast<int>(data_type)][static_cast<int>(page_type)].set(id, value);
     }
-    std::pair<pgroot_pgfirst, bool> load_pg_index(schobj_id const id, pageType::type const page_type) {
-        lock_guard lock(m_mutex);
-        if (auto found = m_data.index.find(id, page_type)) {
-            return { *found, true };
-        }
-        return{};
+    std::pair<pgroot_pgfirst, bool> load_pg_index(schobj_id const id, pageType::type const page_type) const {
+        return m_data.index[static_cast<int>(page_type)].find(id);
     }
     void set_pg_index(schobj_id const id, pageType::type const page_type, pgroot_pgfirst const & value) {
-        lock_guard lock(m_mutex);
-        m_data.index(id, page_type) = value;
+        m_data.index[static_cast<int>(page_type)].set(id, value);
     }
-    std::pair<shared_primary_key, bool> get_primary_key(schobj_id const table_id) {
-        lock_guard lock(m_mutex);
-        auto const found = m_data.primary.find(table_id);
-        if (found != m_data.primary.end()) {
-            return { found->second, true };
-        }
-        return{};
+    std::pair<shared_primary_key, bool> get_primary_key(schobj_id const table_id) const {
+        return m_data.primary.find(table_id);
     }
     void set_primary_key(schobj_id const table_id, shared_primary_key const & value) {
-        lock_guard lock(m_mutex);
-        m_data.primary[table_id] = value;
+        m_data.primary.set(table_id, value);
     }
-    std::pair<shared_cluster_index, bool> get_cluster_index(schobj_id const id) {
-        lock_guard lock(m_mutex);
-        auto const found = m_data.cluster.find(id);
-        if (found != m_data.cluster.end()) {
-            return { found->second, true };
-        }
-        return{};
+    std::pair<shared_cluster_index, bool> get_cluster_index(schobj_id const id) const {
+        return m_data.cluster.find(id);
     }
     void set_cluster_index(schobj_id const id, shared_cluster_index const & value) {
-        lock_guard lock(m_mutex);
-        m_data.cluster[id] = value;
+        m_data.cluster.set(id, value);
     }
-    std::pair<spatial_tree_idx, bool> find_spatial_tree(schobj_id const table_id) {
-        lock_guard lock(m_mutex);
-        auto const found = m_data.spatial_tree.find(table_id);
-        if (found != m_data.spatial_tree.end()) {
-            return { found->second, true };
-        }
-        return{};
+    std::pair<spatial_tree_idx, bool> find_spatial_tree(schobj_id const table_id) const {
+        return m_data.spatial_tree.find(table_id);
     }
     void set_spatial_tree(schobj_id const table_id, spatial_tree_idx const & value) {
-        lock_guard lock(m_mutex);
-        m_data.spatial_tree[table_id] = value;
+        m_data.spatial_tree.set(table_id, value);
+    }
+    shared_column_snapshot get_snapshot(schobj_id const table_id) const {
+        return m_data.snapshot.find(table_id).first;
+    }
+    void set_snapshot(schobj_id const table_id, shared_column_snapshot const & value) {
+        m_data.snapshot.set(table_id, value); // nullptr if detached
+    }
+    std::pair<shared_secondary_indexes, bool> get_secondary_index(schobj_id const table_id) const {
+        return m_data.secondary.find(table_id);
+    }
+    void set_secondary_index(schobj_id const table_id, shared_secondary_indexes const & value) {
+        m_data.secondary.set(table_id, value);
+    }
+    enum { index_prefix_limit = 4096 }; // pages
+    // cache root and upper index levels only: pages at level 1 (and leaf pages of secondary index)
+    // are too many to stay cached and would fill the limit with whatever is read first
+    static bool admit_index_prefix(page_head const * const head) {
+        return (head->data.level >= 2) || (head->data.prevPage.is_null() && head->data.nextPage.is_null());
+    }
+    std::pair<shared_index_prefix, bool> get_index_prefix(pageFileID const & id) const { // second is false if cache is full
+        auto const found = m_data.index_prefix.find(id);
+        if (found.second) {
+            return found;
+        }
+        return { nullptr, m_data.index_prefix.size() < index_prefix_limit };
+    }
+    void set_index_prefix(pageFileID const & id, shared_index_prefix const & value) {
+        m_data.index_prefix.set(id, value, index_prefix_limit);
     }
 private:
-    data_type const & const_data() const { return m_data; }
-    data_type & data() { return m_data; }
-    using lock_guard = std::lock_guard<std::mutex>;
-    std::mutex m_mutex;
-    data_type m_data; //FIXME: preload all and use read-only ?
+    data_type m_data;
 };
 
 } // db
@@ -3,6 +3,7 @@
 #include "dataserver/system/datatable.h"
 #include "dataserver/system/database.h"
 #include "dataserver/system/page_info.h"
+#include "dataserver/system/to_buffer.h"
 #include "dataserver/system/index_tree_t.h"
 #include "dataserver/utils/conv.h"
 
@@ -169,14 +170,16 @@ mem_range_t datatable::record_type::fixed_memory(column const & col, size_t cons
 #if !defined(case_scalartype_cast)
 #define case_scalartype_cast(SCALAR) \
     case SCALAR: \
-        if (auto pv = scalartype_cast<SCALAR>(m, col)) \
-            return to_string::type(*pv); \
+        if (auto pv = scalartype_cast<SCALAR>(m, col)) { \
+            to_buffer::append(dest, *pv); \
+            return; \
+        } \
         break;
 #else
 #error case_scalartype_cast
 #endif
 
-std::string datatable::record_type::type_fixed_col(mem_range_t && m, column const & col)
+void datatable::record_type::append_fixed_col(std::string & dest, mem_range_t && m, column const & col)
 {
     SDL_ASSERT(mem_size(m) == col.fixed_size());
     switch (col.type) {
@@ -193,27 +196,32 @@ std::string datatable::record_type::type_fixed_col(mem_range_t && m, column cons
     case scalartype::t_numeric:
         SDL_ASSERT(col.type == scalartype::t_numeric);
         SDL_ASSERT(col.fixed_size() == mem_size(m));
-        return to_string::type_raw(m, to_string::type_format::less);
+        dest += to_string::type_raw(m, to_string::type_format::less);
+        return;
     case scalartype::t_decimal:
         SDL_ASSERT(col.type == scalartype::t_numeric);
         SDL_ASSERT(col.fixed_size() == mem_size(m));
-        return to_string::type_raw(m, to_string::type_format::less);
+        dest += to_string::type_raw(m, to_string::type_format::less);
+        return;
     case scalartype::t_nchar:
-        return to_string::type(make_nchar_checked(m));
+        to_buffer::append(dest, make_nchar_checked(m));
+        return;
     case scalartype::t_char:
-        return std::string(m.first, m.second); // can be Windows-1251
+        to_buffer::append(dest, m); // can be Windows-1251
+        return;
     case scalartype::t_geography: 
-        return geo_mem(std::move(m)).STAsText();
+        dest += geo_mem(std::move(m)).STAsText();
+        return;
     default:
         break;
     }
-    SDL_ASSERT_DEBUG_2(!"type_fixed_col");
-    return to_string::dump_mem(m); // FIXME: not implemented
+    SDL_ASSERT_DEBUG_2(!"append_fixed_col");
+    dest += to_string::dump_mem(m); // FIXME: not implemented
 }
 
 #undef case_scalartype_cast
 
-std::string datatable::record_type::type_var_col(column const & col, size_t const col_index) const
+void datatable::record_type::append_var_col(std::string & dest, column const & col, size_t const col_index) const
 {
     auto m = data_var_col(col, col_index);
     A_STATIC_CHECK_TYPE(vector_mem_range_t, m);
@@ -221,21 +229,29 @@ std::string datatable::record_type::type_var_col(column const & col, size_t cons
         switch (col.type) {
         case scalartype::t_text:
         case scalartype::t_varchar:
-            return to_string::make_text(m);
+            for (auto const & r : m) {
+                to_buffer::append(dest, r);
+            }
+            break;
         case scalartype::t_ntext:
         case scalartype::t_nvarchar:
-            return to_string::make_ntext(m);
+            for (auto const & r : m) { // as to_string::make_ntext
+                to_buffer::append(dest, make_nchar_checked(r));
+            }
+            break;
         case scalartype::t_geography:
-            return geo_mem(std::move(m)).STAsText();
+            dest += geo_mem(std::move(m)).STAsText();
+            break;
         case scalartype::t_geometry:
         case scalartype::t_varbinary:
-            return to_string::dump_mem(m);
+            dest += to_string::dump_mem(m);
+            break;
         default:
-            SDL_ASSERT_DEBUG_2(!"type_var_col");
-            return to_string::dump_mem(m);
+            SDL_ASSERT_DEBUG_2(!"append_var_col");
+            dest += to_string::dump_mem(m);
+            break;
         }
     }
-    return {};
 }
 
 vector_mem_range_t
@@ -322,34 +338,52 @@ geo_mem datatable::record_type::geography(col_size_t const i) const
     return{};
 }
 
-std::string datatable::record_type::type_col(col_size_t const i) const
+void datatable::record_type::append_col(std::string & dest, col_size_t const i) const
 {
     SDL_ASSERT(i < this->size());
     if (is_null(i)) {
-        return {};
+        return;
     }
     column const & col = usercol(i);
     if (col.is_fixed()) {
-        return type_fixed_col(fixed_memory(col, i), col);
+        append_fixed_col(dest, fixed_memory(col, i), col);
+    }
+    else {
+        append_var_col(dest, col, i);
     }
-    return type_var_col(col, i);
 }
 
-std::string datatable::record_type::type_col_utf8(col_size_t const i) const
+void datatable::record_type::append_col_utf8(std::string & dest, col_size_t const i) const
 {
     SDL_ASSERT(i < this->size());
     if (is_null(i)) {
-        return {};
+        return;
     }
     column const & col = usercol(i);
     if (scalartype::is_text(col.type)) {
-        return conv::cp1251_to_utf8(type_col(i));
+        conv::append_cp1251_to_utf8(dest, data_col(i)); // fragmented input, without intermediate string
     }
-    if (scalartype::is_ntext(col.type)) {
-        return conv::nchar_to_utf8(data_col(i));
+    else if (scalartype::is_ntext(col.type)) {
+        conv::append_nchar_to_utf8(dest, data_col(i));
     }
-    std::string s = type_col(i);
-    SDL_ASSERT(conv::is_utf8(s));
+    else {
+        SDL_DEBUG_CPP(const size_t old = dest.size());
+        append_col(dest, i);
+        SDL_ASSERT(conv::is_utf8(dest.substr(old)));
+    }
+}
+
+std::string datatable::record_type::type_col(col_size_t const i) const
+{
+    std::string s;
+    append_col(s, i);
+    return s;
+}
+
+std::string datatable::record_type::type_col_utf8(col_size_t const i) const
+{
+    std::string s;
+    append_col_utf8(s, i);
     return s;
 }
 
@@ -371,7 +405,19 @@ std::wstring datatable::record_type::type_col_wide(col_size_t const i) const
     return conv::utf8_to_wide(s);
 }
 
-#if 0 // reserved
+lob_reader datatable::record_type::lob_col(col_size_t const i) const
+{
+    SDL_ASSERT(i < this->size());
+    if (is_null(i)) {
+        return{};
+    }
+    column const & col = usercol(i);
+    if (col.is_fixed()) {
+        return lob_reader(vector_mem_range_t{ fixed_memory(col, i) });
+    }
+    return lob_reader(table->db, record, table->ut().var_offset(i), col.type);
+}
+
 size_t datatable::record_type::text_len(col_size_t const i) const
 {
     SDL_ASSERT(i < this->size());
@@ -379,35 +425,26 @@ size_t datatable::record_type::text_len(col_size_t const i) const
         return 0;
     }
     column const & col = usercol(i);
-    if (col.is_fixed()) {
-        switch (col.type) {
-        case scalartype::t_char:
-            return to_string::length_text(fixed_memory(col, i));
-        case scalartype::t_nchar:
-            return to_string::length_ntext(fixed_memory(col, i));
-        default:
-            SDL_ASSERT(0);
-            break;
+    SDL_ASSERT(scalartype::is_text(col.type) || scalartype::is_ntext(col.type));
+    if (col.is_fixed()) { // without trailing spaces
+        mem_range_t const m = fixed_memory(col, i);
+        if (scalartype::is_ntext(col.type)) {
+            nchar_t const * const p = reinterpret_cast<nchar_t const *>(m.first);
+            size_t len = mem_size(m) / sizeof(nchar_t);
+            while (len && (p[len - 1]._16 == ' ')) {
+                --len;
+            }
+            return len;
         }
-    }
-    else {
-        const auto m = data_var_col(col, i);
-        switch (col.type) {
-        case scalartype::t_text:
-        case scalartype::t_varchar:
-            return to_string::length_text(m);
-        case scalartype::t_ntext:
-        case scalartype::t_nvarchar:
-            return to_string::length_ntext(m);
-        default:
-            SDL_ASSERT(0);
-            break;
+        size_t len = mem_size(m);
+        while (len && (m.first[len - 1] == ' ')) {
+            --len;
         }
+        return len;
     }
-    SDL_ASSERT(0);
-    return type_col(i).size();
+    const size_t len = lob_col(i).length(); // LOB pages are not loaded
+    return scalartype::is_ntext(col.type) ? (len / sizeof(nchar_t)) : len;
 }
-#endif
 
 std::string datatable::record_type::operator[](const std::string & col_name) const
 {
@@ -564,11 +601,21 @@ datatable::scan_table_with_record_key(key_mem const & key) const
 
 template<class ret_type, class fun_type>
 ret_type datatable::find_row_head_impl(key_mem const & key, fun_type const & fun) const
+{
+    SDL_ASSERT(is_index_tree());
+    if (m_index_tree) {
+        return find_row_head_impl<ret_type>(key, m_index_tree->find_page(key), fun);
+    }
+    return ret_type();
+}
+
+template<class ret_type, class fun_type>
+ret_type datatable::find_row_head_impl(key_mem const & key, pageFileID const & id, fun_type const & fun) const
 {
     SDL_ASSERT(mem_size(key) == cluster_key_length());
     SDL_ASSERT(is_index_tree());
     if (m_index_tree) {
-        if (auto const id = m_index_tree->find_page(key)) {
+        if (id) {
             if (page_head const * const h = db->load_page_head(id)) {
                 SDL_ASSERT(h->is_data());
                 const datapage data(h);
@@ -627,11 +674,32 @@ datatable::find_record_iterator(key_mem const & key) const
     return scan_table_with_record_key(key);
 }
 
+pageFileID datatable::find_row_page(key_mem const & key) const
+{
+    SDL_ASSERT(mem_size(key) == cluster_key_length());
+    if (m_index_tree) {
+        return m_index_tree->find_page(key);
+    }
+    return {};
+}
+
+void datatable::prefetch_pages(std::vector<pageFileID> & pages) const
+{
+    db->prefetch_pages(pages);
+}
+
 row_head const *
 datatable::find_row_head(key_mem const & key) const
+{
+    return find_row_head(key, pageFileID());
+}
+
+row_head const *
+datatable::find_row_head(key_mem const & key, pageFileID const & page) const
 {
     if (m_index_tree) {
-        return find_row_head_impl<row_head const *>(key, [](row_head const * head, recordID const &) {
+        return find_row_head_impl<row_head const *>(key, page ? page : m_index_tree->find_page(key),
+            [](row_head const * head, recordID const &) {
             return head;
         });
     }
@@ -646,9 +714,16 @@ datatable::find_row_head(key_mem const & key) const
 
 datatable::record_type
 datatable::find_record(key_mem const & key) const
+{
+    return find_record(key, pageFileID());
+}
+
+datatable::record_type
+datatable::find_record(key_mem const & key, pageFileID const & page) const
 {
     if (m_index_tree) {
-        return find_row_head_impl<record_type>(key, [this](row_head const * head, recordID const & id) {
+        return find_row_head_impl<record_type>(key, page ? page : m_index_tree->find_page(key),
+            [this](row_head const * head, recordID const & id) {
             return record_type(this, head
     #if SDL_DEBUG_RECORD_ID
                 , id
@@ -713,29 +788,37 @@ tree_STIntersects::select(identity<pk0_type>, bool_constant<true>) const {
     static_assert(std::numeric_limits<pk0_type>::is_integer, "see interval_distance");
     using tree_type = spatial_tree_t<pk0_type>;
     using spatial_page_row = typename tree_type::spatial_page_row;
-    ret_type result;
+    std::vector<pk0_type> keys; // rows are fetched after their pages are prefetched
+    std::vector<bool> cover;
     sparse_set_t<pk0_type> m_pk0; // check processed records
-    tree_.cast<pk0_type>()->for_rect(rect_, [this, &m_pk0, &result](spatial_page_row const * const row){
+    tree_.cast<pk0_type>()->for_rect(rect_, [&m_pk0, &keys, &cover](spatial_page_row const * const row){
         A_STATIC_CHECK_TYPE(pk0_type, row->data.pk0);
         if (m_pk0.insert(row->data.pk0)) {
-            if (row->cell_cover()) {
-                if (row_head const * const p = this->table_->find_row_head_t(row->data.pk0)) {
-                    result.push_back(p);
-                    return bc::continue_;
-                }
-            }
-            else if (const auto & record = this->table_->find_record_t(row->data.pk0)) {
-                if (record.geography(this->geo_index_).STIntersects(this->rect_)) {
-                    result.push_back(record.head());
-                }
-                return bc::continue_;
-            }
-            SDL_ASSERT(0);
-            return bc::break_;
+            keys.push_back(row->data.pk0);
+            cover.push_back(row->cell_cover());
+            return bc::continue_;
         }
         SDL_ASSERT(0);
         return bc::break_;
     });
+    auto const pages = this->table_->prefetch_rows_t(keys); // page of each key
+    ret_type result;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (cover[i]) {
+            if (row_head const * const p = this->table_->find_row_head_t(keys[i], pages[i])) {
+                result.push_back(p);
+                continue;
+            }
+        }
+        else if (const auto & record = this->table_->find_record_t(keys[i], pages[i])) {
+            if (record.geography(this->geo_index_).STIntersects(this->rect_)) {
+                result.push_back(record.head());
+            }
+            continue;
+        }
+        SDL_ASSERT(0);
+        break;
+    }
     return result;
 }
 
@@ -780,29 +863,37 @@ tree_STDistance::select(identity<pk0_type>, bool_constant<true>) const {
     static_assert(std::numeric_limits<pk0_type>::is_integer, "see interval_distance");
     using tree_type = spatial_tree_t<pk0_type>;
     using spatial_page_row = typename tree_type::spatial_page_row;
-    ret_type result;
+    std::vector<pk0_type> keys; // rows are fetched after their pages are prefetched
+    std::vector<bool> cover;
     sparse_set_t<pk0_type> m_pk0; // check processed records
-    tree_.cast<pk0_type>()->for_range(where_, distance_, [this, &m_pk0, &result](spatial_page_row const * const row){
+    tree_.cast<pk0_type>()->for_range(where_, distance_, [&m_pk0, &keys, &cover](spatial_page_row const * const row){
         A_STATIC_CHECK_TYPE(pk0_type, row->data.pk0);
         if (m_pk0.insert(row->data.pk0)) {
-            if (row->cell_cover()) { // STDistance = 0
-                if (row_head const * const p = this->table_->find_row_head_t(row->data.pk0)) {
-                    result.push_back(p);
-                    return bc::continue_;
-                }
-            }
-            else if (const auto & record = this->table_->find_record_t(row->data.pk0)) {
-                if (record.geography(this->geo_index_).STDistance(this->where_).value() <= this->distance_.value()) {
-                    result.push_back(record.head());
-                }
-                return bc::continue_;
-            }
-            SDL_ASSERT(0);
-            return bc::break_;
+            keys.push_back(row->data.pk0);
+            cover.push_back(row->cell_cover());
+            return bc::continue_;
         }
         SDL_ASSERT(0);
         return bc::break_;
     });
+    auto const pages = this->table_->prefetch_rows_t(keys); // page of each key
+    ret_type result;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (cover[i]) { // STDistance = 0
+            if (row_head const * const p = this->table_->find_row_head_t(keys[i], pages[i])) {
+                result.push_back(p);
+                continue;
+            }
+        }
+        else if (const auto & record = this->table_->find_record_t(keys[i], pages[i])) {
+            if (record.geography(this->geo_index_).STDistance(this->where_).value() <= this->distance_.value()) {
+                result.push_back(record.head());
+            }
+            continue;
+        }
+        SDL_ASSERT(0);
+        break;
+    }
     return result;
 }
 
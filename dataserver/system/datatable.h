@@ -6,6 +6,7 @@
 
 #include "dataserver/sysobj/iam_page.h"
 #include "dataserver/system/index_tree.h"
+#include "dataserver/system/overflow.h"
 #include "dataserver/spatial/spatial_tree.h"
 #include "dataserver/spatial/geography.h"
 #include <shared_mutex>
@@ -164,6 +165,8 @@ public:
         column const & usercol(col_size_t) const;
         std::string type_col(col_size_t) const;
         std::string type_col_utf8(col_size_t) const;
+        void append_col(std::string &, col_size_t) const; // appends type_col to reusable buffer
+        void append_col_utf8(std::string &, col_size_t) const; // appends type_col_utf8 to reusable buffer
         std::wstring type_col_wide(col_size_t) const;
         bool is_geography(col_size_t) const;
         spatial_type geo_type(col_size_t) const;
@@ -175,10 +178,10 @@ public:
         std::string STAsText(col_size_t) const;
         bool STContains(col_size_t, spatial_point const &) const;   // can use geography().STContains()
         Meters STDistance(col_size_t, spatial_point const &) const; // can use geography().STDistance()
-        std::string operator[](const std::string & col_name) const; // returns type_col
-        std::string operator[](const char * col_name) const; // returns type_col
-    private:
-        size_t text_len(col_size_t) const; // to be tested
+        std::string operator[](const std::string & col_name) const; // returns type_col, finds column by name
+        std::string operator[](const char * col_name) const; // returns type_col, finds column by name
+        lob_reader lob_col(col_size_t) const; // reads variable column by chunks, LOB pages are loaded on demand
+        size_t text_len(col_size_t) const; // # of characters, trailing spaces of char and nchar are not counted
     public:
         size_t fixed_size() const;
         size_t var_size() const;
@@ -190,8 +193,8 @@ public:
         forwarded_stub const * forwarded() const; // returns nullptr if not forwarded
     private:
         mem_range_t fixed_memory(column const & col, size_t) const;
-        static std::string type_fixed_col(mem_range_t && m, column const & col);
-        std::string type_var_col(column const & col, size_t) const;
+        static void append_fixed_col(std::string &, mem_range_t && m, column const & col);
+        void append_var_col(std::string &, column const & col, size_t) const;
         vector_mem_range_t data_var_col(column const & col, size_t) const;
     };
 //------------------------------------------------------------------
@@ -288,8 +291,11 @@ public:
         return !!m_index_tree;
     }
     row_head const * find_row_head(key_mem const &) const;
+    row_head const * find_row_head(key_mem const &, pageFileID const & page) const; // page of key if known (see find_row_page)
+    pageFileID find_row_page(key_mem const &) const; // data page of cluster key, null if !is_index_tree()
 
     record_type find_record(key_mem const & key) const;
+    record_type find_record(key_mem const & key, pageFileID const & page) const;
     record_type find_record(vector_mem_range_t const & key) const; 
 
     record_iterator find_record_iterator(key_mem const & key) const;
@@ -323,11 +329,37 @@ public:
         return find_record(make_key_mem(key...));
     }
     template<class T> 
+    record_type find_record_t(T const & key, pageFileID const & page) const {
+        const char * const p = reinterpret_cast<const char *>(&key);
+        return find_record(key_mem(p, p + sizeof(T)), page);
+    }
+    template<class T> 
     row_head const * find_row_head_t(T const & key) const {
         const char * const p = reinterpret_cast<const char *>(&key);
         return find_row_head(key_mem(p, p + sizeof(T)));
     }
     template<class T> 
+    row_head const * find_row_head_t(T const & key, pageFileID const & page) const {
+        const char * const p = reinterpret_cast<const char *>(&key);
+        return find_row_head(key_mem(p, p + sizeof(T)), page);
+    }
+    // data pages of rows with cluster keys are prefetched (see database::prefetch_pages);
+    // returns page of each key (null if !is_index_tree) to be passed to find_row_head_t or find_record_t
+    template<class T>
+    std::vector<pageFileID> prefetch_rows_t(std::vector<T> const & keys) const {
+        std::vector<pageFileID> pages(keys.size());
+        if (is_index_tree()) {
+            for (size_t i = 0; i < keys.size(); ++i) {
+                const char * const p = reinterpret_cast<const char *>(&keys[i]);
+                pages[i] = find_row_page(key_mem(p, p + sizeof(T)));
+            }
+            std::vector<pageFileID> prefetch(pages); // sorted and made unique by prefetch_pages
+            prefetch_pages(prefetch);
+        }
+        return pages;
+    }
+    void prefetch_pages(std::vector<pageFileID> &) const;
+    template<class T> 
     record_iterator find_record_iterator_t(T const & key) const {
         const char * const p = reinterpret_cast<const char *>(&key);
         return find_record_iterator(key_mem(p, p + sizeof(T)));
@@ -349,6 +381,8 @@ public:
 private:
     template<class ret_type, class fun_type>
     ret_type find_row_head_impl(key_mem const &, fun_type const &) const;
+    template<class ret_type, class fun_type>
+    ret_type find_row_head_impl(key_mem const &, pageFileID const &, fun_type const &) const;
     spatial_tree_idx find_spatial_tree() const;
     record_iterator scan_table_with_record_key(key_mem const &) const;
     template<scalartype::type type> static scalartype_t<type> const *
@@ -0,0 +1,57 @@
+// index_prefix.cpp
+//
+#include "dataserver/system/index_prefix.h"
+
+#if SDL_DEBUG
+namespace sdl {
+    namespace db {
+        namespace {
+            class unit_test {
+                static void test(index_prefix::vector_type const & v) {
+                    SDL_ASSERT(std::is_sorted(v.begin(), v.end()));
+                    const index_prefix exact(index_prefix::vector_type(v), true);
+                    const index_prefix inexact(index_prefix::vector_type(v), false);
+                    std::vector<index_prefix::value_type> values(v);
+                    values.push_back(0);
+                    values.push_back(uint64(-1));
+                    for (auto const x : v) {
+                        if (x) values.push_back(x - 1);
+                        values.push_back(x + 1);
+                    }
+                    for (size_t first = 0; first <= v.size(); first += 1 + v.size() / 4) {
+                        for (auto const x : values) {
+                            const size_t lower = std::lower_bound(v.begin() + first, v.end(), x) - v.begin();
+                            const size_t upper = std::upper_bound(v.begin() + first, v.end(), x) - v.begin();
+                            SDL_ASSERT(exact.lower_bound(x, first) == lower);
+                            SDL_ASSERT(inexact.lower_bound(x, first) == lower);
+                            SDL_ASSERT(exact.upper_bound(x, first) == upper);
+                        }
+                    }
+                }
+            public:
+                unit_test() {
+                    {
+                        const char key[] = { 1, 2, 3 };
+                        SDL_ASSERT(index_prefix::make_prefix(key, 3) == 0x0102030000000000ull);
+                        SDL_ASSERT(index_prefix::make_prefix(key, 0) == 0);
+                    }
+                    test({});
+                    test({ 5 });
+                    {
+                        index_prefix::vector_type v;
+                        for (uint64 i = 0; i < 500; ++i) {
+                            v.push_back(1000 + i * 3);
+                        }
+                        test(v);
+                        v.insert(v.begin() + 100, 20, v[100]); // equal prefixes
+                        test(v);
+                        v.push_back(uint64(1) << 62); // skewed
+                        test(v);
+                    }
+                }
+            };
+            static unit_test s_test;
+        }
+    } // db
+} // sdl
+#endif //#if SDL_DEBUG
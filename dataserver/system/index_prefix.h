@@ -0,0 +1,114 @@
+// index_prefix.h
+//
+#pragma once
+#ifndef __SDL_SYSTEM_INDEX_PREFIX_H__
+#define __SDL_SYSTEM_INDEX_PREFIX_H__
+
+#include "dataserver/system/page_type.h"
+
+namespace sdl { namespace db {
+
+// Dense array of key prefixes of index page rows in slot order, built once for hot index pages so that
+// search does not dereference slot offsets into the page for every probe. Prefix is big-endian value of
+// first 8 bytes of normalized first sub-key (see index_tree::normalize_part), so prefix order agrees with
+// key order; rows with equal prefix are resolved by full key compare unless prefix is exact (whole key).
+class index_prefix : noncopyable {
+public:
+    using value_type = uint64;
+    using vector_type = std::vector<value_type>;
+    enum { max_size = 8 }; // bytes of normalized key in prefix
+    enum { interpolation_steps = 3 };
+
+    index_prefix(vector_type && v, bool const exact)
+        : m_data(std::move(v)), m_exact(exact) {}
+
+    size_t size() const {
+        return m_data.size();
+    }
+    bool exact() const {
+        return m_exact;
+    }
+    value_type operator[](size_t const i) const {
+        SDL_ASSERT(i < size());
+        return m_data[i];
+    }
+    // prefix of normalized key of given size (only first max_size bytes are used)
+    static value_type make_prefix(const char * normalized, size_t size);
+
+    // first index in [first, size()) with prefix not less than value, or size();
+    // interpolation search is used for exact (integer) prefixes, then branch-free binary search
+    size_t lower_bound(value_type value, size_t first) const;
+
+    // first index in [first, size()) with prefix greater than value, or size()
+    size_t upper_bound(value_type value, size_t first) const;
+private:
+    vector_type const m_data;
+    bool const m_exact;
+};
+
+using shared_index_prefix = std::shared_ptr<index_prefix const>;
+using make_index_prefix = std::function<shared_index_prefix()>;
+
+inline index_prefix::value_type
+index_prefix::make_prefix(const char * const normalized, size_t const size)
+{
+    value_type result = 0;
+    for (size_t i = 0, end = a_min(size, size_t(max_size)); i < end; ++i) {
+        result |= value_type(uint8(normalized[i])) << (8 * (max_size - 1 - i));
+    }
+    return result;
+}
+
+inline size_t index_prefix::lower_bound(value_type const value, size_t first) const
+{
+    SDL_ASSERT(first <= size());
+    size_t last = size(); // answer is in [first, last]
+    if (m_exact) {
+        for (size_t step = 0; (step < interpolation_steps) && (last - first > 16); ++step) {
+            value_type const lo = m_data[first];
+            value_type const hi = m_data[last - 1];
+            if (value <= lo) return first;
+            if (hi < value) return last;
+            SDL_ASSERT(lo < hi);
+            size_t mid = first + static_cast<size_t>(double(value - lo) / double(hi - lo) * double(last - 1 - first));
+            mid = a_min(a_max(mid, first), last - 1);
+            if (m_data[mid] < value)
+                first = mid + 1;
+            else
+                last = mid;
+        }
+    }
+    value_type const * base = m_data.data() + first;
+    size_t count = last - first;
+    while (count > 1) {
+        const size_t half = count / 2;
+        base = (base[half] < value) ? (base + half) : base;
+        count -= half;
+    }
+    if (count && (*base < value)) {
+        ++base;
+    }
+    return base - m_data.data();
+}
+
+inline size_t index_prefix::upper_bound(value_type const value, size_t first) const
+{
+    SDL_ASSERT(first <= size());
+    size_t count = size() - first;
+    while (count) {
+        const size_t half = count / 2;
+        if (value < m_data[first + half]) {
+            count = half;
+        }
+        else {
+            first += half + 1;
+            count -= half + 1;
+        }
+    }
+    return first;
+}
+
+} // db
+} // sdl
+
+#endif // __SDL_SYSTEM_INDEX_PREFIX_H__
@@ -3,6 +3,9 @@
 #include "dataserver/system/index_tree.h"
 #include "dataserver/system/database.h"
 #include "dataserver/system/page_info.h"
+#if SDL_DEBUG
+#include <random>
+#endif
 
 namespace sdl { namespace db {
 
@@ -23,6 +26,8 @@ index_tree::index_page::index_page(index_tree const * t, page_head const * h, si
 
 index_tree::index_tree(database const * p, shared_cluster_index const & h)
     : this_db(p), cluster(h), key_length(h->key_length())
+    , m_parts(make_key_parts(*h))
+    , m_compare(make_key_compare(m_parts))
 {
     SDL_ASSERT(this_db && cluster && root());
     SDL_ASSERT(root()->is_index());
@@ -187,12 +192,31 @@ size_t index_tree::index_page::find_slot(key_mem const m) const
     SDL_ASSERT(mem_size(m));
     const index_page_key data(this->head);
     index_page_row_key const * const null = head->data.prevPage ? nullptr : index_page_key(this->head).front();
-    size_t i = data.lower_bound([this, &m, null](index_page_row_key const * const x) {
-        return (x == null) || tree->key_less(get_key(x), m);
-    });
+    const search_key key(tree, m);
+    size_t i;
+    if (shared_index_prefix const prefix = tree->load_prefix(this->head)) {
+        SDL_ASSERT(prefix->size() == data.size());
+        const index_prefix::value_type value = key.prefix();
+        i = prefix->lower_bound(value, null ? 1 : 0);
+        if (!prefix->exact()) { // rows with equal prefix
+            size_t last = prefix->upper_bound(value, i);
+            while (i < last) {
+                const size_t mid = i + (last - i) / 2;
+                if (key.compare(row_key(mid)) < 0)
+                    i = mid + 1;
+                else
+                    last = mid;
+            }
+        }
+    }
+    else {
+        i = data.lower_bound([this, &key, null](index_page_row_key const * const x) {
+            return (x == null) || (key.compare(get_key(x)) < 0);
+        });
+    }
     SDL_ASSERT(i <= data.size());
     if (i < data.size()) {
-        if (i && tree->key_less(m, row_key(i))) {
+        if (i && (key.compare(row_key(i)) > 0)) {
             --i;
         }
         return i;
@@ -293,6 +317,26 @@ pageFileID index_tree::max_page() const
     return id;
 }
 
+std::vector<pageFileID> index_tree::leaf_pages() const
+{
+    page_head const * head = root();
+    while (head->data.level > 1) { // leftmost page of level above leaf
+        head = this_db->load_page_head(index_page(this, head, 0).min_page());
+        if (!(head && head->is_index())) {
+            throw_error<index_tree_error>("bad index");
+        }
+    }
+    std::vector<pageFileID> result;
+    while (head) {
+        const index_page p(this, head, 0);
+        for (size_t i = 0, end = p.size(); i < end; ++i) {
+            result.push_back(p.row_page(i));
+        }
+        head = this_db->load_next_head(head);
+    }
+    return result;
+}
+
 int index_tree::sub_key_compare(size_t const i, key_mem const & x, key_mem const & y) const
 {
     SDL_ASSERT(mem_size(x) == mem_size(y));
@@ -355,24 +399,271 @@ int index_tree::sub_key_compare(size_t const i, key_mem const & x, key_mem const
     return 0; // keys are equal
 }
 
-bool index_tree::key_less(key_mem x, key_mem y) const
+namespace {
+
+template<class T>
+inline T load_key(const char * const p) {
+    T value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+template<class T>
+inline int compare_value(T const x, T const y) {
+    return (x < y) ? -1 : ((y < x) ? 1 : 0);
+}
+
+inline int memcmp_sign(const char * const x, const char * const y, size_t const size) {
+    const int val = ::memcmp(x, y, size);
+    return (val < 0) ? -1 : ((val > 0) ? 1 : 0);
+}
+
+template<class T>
+inline void store_big_endian(T const value, char * const dest) {
+    static_assert(std::is_unsigned<T>::value, "store_big_endian");
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        dest[i] = static_cast<char>(value >> (8 * (sizeof(T) - 1 - i)));
+    }
+}
+
+} // namespace
+
+index_tree::key_parts
+index_tree::make_key_parts(cluster_index const & cluster)
+{
+    key_parts result(cluster.size());
+    for (size_t i = 0; i < result.size(); ++i) {
+        result[i].type = cluster[i].type;
+        result[i].size = cluster.sub_key_length(i);
+        result[i].descending = cluster.is_descending(i);
+    }
+    return result;
+}
+
+index_tree::key_compare
+index_tree::make_key_compare(key_parts const & parts)
+{
+    if (parts.size() == 1) {
+        if ((parts[0].type == scalartype::t_int) && (parts[0].size == sizeof(int32)))
+            return key_compare::int32;
+        if ((parts[0].type == scalartype::t_bigint) && (parts[0].size == sizeof(int64)))
+            return key_compare::int64;
+    }
+    bool bytes = true;
+    for (key_part const & k : parts) {
+        if (!is_normalized(k)) {
+            return key_compare::generic;
+        }
+        bytes &= (k.type == scalartype::t_char) && !k.descending;
+    }
+    return bytes ? key_compare::bytes : key_compare::normalized;
+}
+
+bool index_tree::is_normalized(key_part const & k)
+{
+    switch (k.type) {
+    case scalartype::t_char:
+        return k.size != 0;
+    case scalartype::t_int:
+        return k.size == sizeof(int32);
+    case scalartype::t_bigint:
+        return k.size == sizeof(int64);
+    case scalartype::t_uniqueidentifier:
+        return k.size == sizeof(guid_t);
+    case scalartype::t_nchar:
+        return k.size && !(k.size % sizeof(nchar_t));
+    default:
+        return false;
+    }
+}
+
+index_prefix::value_type
+index_tree::first_prefix(key_part const & k, const char * const src)
+{
+    SDL_ASSERT(is_normalized(k));
+    key_part head = k;
+    if ((k.type == scalartype::t_char) || (k.type == scalartype::t_nchar)) { // normalized per byte or code unit
+        head.size = a_min(k.size, size_t(index_prefix::max_size));
+    }
+    char buf[sizeof(guid_t)];
+    SDL_ASSERT(head.size <= sizeof(buf));
+    normalize_part(head, src, buf);
+    return index_prefix::make_prefix(buf, head.size);
+}
+
+shared_index_prefix
+index_tree::load_prefix(page_head const * const head) const
+{
+    if (m_compare == key_compare::generic) {
+        return {};
+    }
+    return this_db->load_index_prefix(head, [this, head]() {
+        key_part const & k = m_parts[0];
+        const index_page_key data(head);
+        index_prefix::vector_type v(data.size());
+        for (size_t i = 0; i < v.size(); ++i) {
+            v[i] = first_prefix(k, &(data[i]->data.key));
+        }
+        const bool exact = (m_parts.size() == 1) && (k.size <= index_prefix::max_size);
+        return std::make_shared<index_prefix>(std::move(v), exact);
+    });
+}
+
+void index_tree::normalize_part(key_part const & k, const char * const src, char * const dest)
+{
+    switch (k.type) {
+    case scalartype::t_int:
+        store_big_endian(load_key<uint32>(src) ^ 0x80000000u, dest);
+        break;
+    case scalartype::t_bigint:
+        store_big_endian(load_key<uint64>(src) ^ 0x8000000000000000ull, dest);
+        break;
+    case scalartype::t_uniqueidentifier:
+        {   // same order as guid_t::compare
+            uint8 const * const order = guid_t::byte_order();
+            for (size_t i = 0; i < sizeof(guid_t); ++i) {
+                dest[i] = src[order[i]];
+            }
+        }
+        break;
+    case scalartype::t_nchar:
+        for (size_t i = 0; i < k.size; i += sizeof(nchar_t)) {
+            store_big_endian(load_key<uint16>(src + i), dest + i);
+        }
+        break;
+    default:
+        SDL_ASSERT(k.type == scalartype::t_char);
+        memcpy(dest, src, k.size);
+        break;
+    }
+    if (k.descending) {
+        for (size_t i = 0; i < k.size; ++i) {
+            dest[i] = static_cast<char>(~dest[i]);
+        }
+    }
+}
+
+void index_tree::normalize_key(key_mem const m, char * dest) const
+{
+    SDL_ASSERT(m_compare == key_compare::normalized);
+    SDL_ASSERT(mem_size(m) == this->key_length);
+    const char * src = m.first;
+    for (key_part const & k : m_parts) {
+        normalize_part(k, src, dest);
+        src += k.size;
+        dest += k.size;
+    }
+}
+
+int index_tree::compare_normalized(key_mem const m, const char * norm) const
+{
+    SDL_ASSERT(m_compare == key_compare::normalized);
+    SDL_ASSERT(mem_size(m) == this->key_length);
+    char buf[sizeof(guid_t)];
+    const char * src = m.first;
+    for (key_part const & k : m_parts) {
+        if ((k.type == scalartype::t_char) && !k.descending) {
+            if (const int val = memcmp_sign(src, norm, k.size)) {
+                return val;
+            }
+        }
+        else if (k.size <= sizeof(buf)) {
+            normalize_part(k, src, buf);
+            if (const int val = memcmp_sign(buf, norm, k.size)) {
+                return val;
+            }
+        }
+        else {
+            vector_buf<char, 64> long_buf(k.size);
+            normalize_part(k, src, long_buf.data());
+            if (const int val = memcmp_sign(long_buf.data(), norm, k.size)) {
+                return val;
+            }
+        }
+        src += k.size;
+        norm += k.size;
+    }
+    return 0; // keys are equal
+}
+
+int index_tree::compare_key(key_mem x, key_mem y) const
 {
     SDL_ASSERT(mem_size(x) == this->key_length);
     SDL_ASSERT(mem_size(y) == this->key_length);
-    for (size_t i = 0; i < cluster->size(); ++i) {
-        size_t const sz = cluster->sub_key_length(i);
+    switch (m_compare) {
+    case key_compare::int32: {
+            const int val = compare_value(load_key<int32>(x.first), load_key<int32>(y.first));
+            return m_parts[0].descending ? -val : val;
+        }
+    case key_compare::int64: {
+            const int val = compare_value(load_key<int64>(x.first), load_key<int64>(y.first));
+            return m_parts[0].descending ? -val : val;
+        }
+    case key_compare::bytes:
+        return memcmp_sign(x.first, y.first, this->key_length);
+    case key_compare::normalized: {
+            vector_buf<char, 64> norm(this->key_length);
+            normalize_key(y, norm.data());
+            return compare_normalized(x, norm.data());
+        }
+    default:
+        break;
+    }
+    for (size_t i = 0; i < m_parts.size(); ++i) { // key_compare::generic
+        size_t const sz = m_parts[i].size;
         x.second = x.first + sz;
         y.second = y.first + sz;
-        switch (sub_key_compare(i, x, y)) {
-        case -1 : return true;
-        case 1 : return false;
-        default:
-            break;
+        if (const int val = sub_key_compare(i, x, y)) {
+            return (val < 0) ? -1 : 1;
         }
         x.first = x.second;
         y.first = y.second;
     }
-    return false; // keys are equal
+    return 0; // keys are equal
+}
+
+index_tree::search_key::search_key(index_tree const * const t, key_mem const m)
+    : tree(t)
+    , key(m)
+    , norm((t->m_compare == key_compare::normalized) ? t->key_length : 0)
+{
+    SDL_ASSERT(mem_size(key) == tree->key_length);
+    switch (tree->m_compare) {
+    case key_compare::int32:
+        value = load_key<int32>(key.first);
+        break;
+    case key_compare::int64:
+        value = load_key<int64>(key.first);
+        break;
+    case key_compare::normalized:
+        tree->normalize_key(key, norm.data());
+        break;
+    default:
+        break;
+    }
+}
+
+int index_tree::search_key::compare(key_mem const row) const
+{
+    switch (tree->m_compare) {
+    case key_compare::int32: {
+            const int val = compare_value<int64>(load_key<int32>(row.first), value);
+            return tree->m_parts[0].descending ? -val : val;
+        }
+    case key_compare::int64: {
+            const int val = compare_value(load_key<int64>(row.first), value);
+            return tree->m_parts[0].descending ? -val : val;
+        }
+    case key_compare::normalized:
+        return tree->compare_normalized(row, norm.data());
+    default:
+        return tree->compare_key(row, key);
+    }
+}
+
+bool index_tree::key_less(key_mem const x, key_mem const y) const
+{
+    return compare_key(x, y) < 0;
 }
 
 bool index_tree::key_less(vector_mem_range_t const & x, key_mem y) const
@@ -424,3 +715,77 @@ bool index_tree::key_less(key_mem x, vector_mem_range_t const & y) const
 
 } // db
 } // sdl
+
+#if SDL_DEBUG
+namespace sdl {
+    namespace db {
+        namespace {
+            class unit_test {
+                template<class T>
+                static int compare(index_tree::key_part const & k, T const & x, T const & y) {
+                    SDL_ASSERT(k.size == sizeof(T));
+                    char nx[sizeof(T)], ny[sizeof(T)];
+                    index_tree::normalize_part(k, reinterpret_cast<const char *>(&x), nx);
+                    index_tree::normalize_part(k, reinterpret_cast<const char *>(&y), ny);
+                    const int val = ::memcmp(nx, ny, sizeof(T));
+                    return (val < 0) ? -1 : ((val > 0) ? 1 : 0);
+                }
+            public:
+                unit_test() {
+                    {
+                        const index_tree::key_part k{ scalartype::t_int, sizeof(int32), false };
+                        const int32 test[] = { std::numeric_limits<int32>::min(), -256, -1, 0, 1, 255, 256, std::numeric_limits<int32>::max() };
+                        for (size_t i = 0; i < count_of(test); ++i) {
+                        for (size_t j = 0; j < count_of(test); ++j) {
+                            SDL_ASSERT(compare(k, test[i], test[j]) == ((i < j) ? -1 : ((j < i) ? 1 : 0)));
+                            const index_tree::key_part desc{ scalartype::t_int, sizeof(int32), true };
+                            SDL_ASSERT(compare(desc, test[i], test[j]) == ((i < j) ? 1 : ((j < i) ? -1 : 0)));
+                        }}
+                    }
+                    {
+                        const index_tree::key_part k{ scalartype::t_bigint, sizeof(int64), false };
+                        const int64 test[] = { std::numeric_limits<int64>::min(), -(int64(1) << 40), -1, 0, 1, int64(1) << 32, std::numeric_limits<int64>::max() };
+                        for (size_t i = 0; i < count_of(test); ++i) {
+                        for (size_t j = 0; j < count_of(test); ++j) {
+                            SDL_ASSERT(compare(k, test[i], test[j]) == ((i < j) ? -1 : ((j < i) ? 1 : 0)));
+                        }}
+                    }
+                    {
+                        const index_tree::key_part k{ scalartype::t_uniqueidentifier, sizeof(guid_t), false };
+                        guid_t x{}, y{};
+                        x.a = 0xFFFFFFFF; y.k = 1; // last six bytes are most significant
+                        SDL_ASSERT(compare(k, x, y) < 0);
+                        SDL_ASSERT(guid_t::compare(x, y) < 0);
+                        y = x; y.a = 0xFFFFFFFE;
+                        SDL_ASSERT(compare(k, x, y) > 0);
+                        y = x;
+                        SDL_ASSERT(compare(k, x, y) == 0);
+                        SDL_ASSERT(guid_t::compare(x, y) == 0);
+                        y.b = 1; // first ten bytes are compared too
+                        SDL_ASSERT(guid_t::compare(x, y) < 0);
+                        std::mt19937 gen(43);
+                        for (size_t n = 0; n < 1000; ++n) {
+                            for (size_t i = 0; i < sizeof(guid_t); ++i) {
+                                reinterpret_cast<uint8 *>(&x)[i] = static_cast<uint8>(gen() % 3);
+                                reinterpret_cast<uint8 *>(&y)[i] = static_cast<uint8>(gen() % 3);
+                            }
+                            const int c = guid_t::compare(x, y);
+                            SDL_ASSERT(compare(k, x, y) == c);
+                            SDL_ASSERT((x < y) == (c < 0));
+                            SDL_ASSERT((x == y) == (c == 0));
+                        }
+                    }
+                    {
+                        const index_tree::key_part k{ scalartype::t_nchar, sizeof(nchar_t) * 2, false };
+                        const nchar_t x[2] = { { 0x0100 }, { 0x0001 } };
+                        const nchar_t y[2] = { { 0x00FF }, { 0xFFFF } };
+                        SDL_ASSERT(compare(k, x, y) > 0);
+                        SDL_ASSERT(nchar_compare(x, y) > 0);
+                    }
+                }
+            };
+            static unit_test s_test;
+        }
+    } // db
+} // sdl
+#endif //#if SDL_DEBUG
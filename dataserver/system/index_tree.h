@@ -5,6 +5,7 @@
 #define __SDL_SYSTEM_INDEX_TREE_H__
 
 #include "dataserver/system/primary_key.h"
+#include "dataserver/system/index_prefix.h"
 
 namespace sdl { namespace db { 
 
@@ -14,6 +15,16 @@ class index_tree: noncopyable {
 public:
     using key_mem = mem_range_t;
     using row_mem = std::pair<mem_range_t, pageFileID>;
+    struct key_part { // sub-key of index
+        scalartype::type type;
+        size_t size;
+        bool descending;
+    };
+    using key_parts = std::vector<key_part>;
+    // converts sub-key into memcmp-comparable form of the same size; type is int, bigint, uniqueidentifier, char or nchar
+    static void normalize_part(key_part const &, const char * src, char * dest);
+    static bool is_normalized(key_part const &); // normalize_part supports sub-key
+    static index_prefix::value_type first_prefix(key_part const &, const char * src); // prefix of normalized sub-key
 private:
     using index_tree_error = sdl_exception_t<index_tree>;
     using page_slot = std::pair<page_head const *, size_t>;
@@ -119,6 +130,30 @@ private:
         bool is_end(index_page const &) const;
     };
     int sub_key_compare(size_t, key_mem const &, key_mem const &) const;
+private:
+    // Comparator is chosen once per tree: integers for single int/bigint key, memcmp of raw key for char keys,
+    // otherwise memcmp of normalized keys (big-endian integers with inverted sign bit, GUID bytes in
+    // SQL Server order, nchar as big-endian code units, all bytes inverted for DESC column).
+    enum class key_compare { generic, int32, int64, bytes, normalized };
+    static key_parts make_key_parts(cluster_index const &);
+    static key_compare make_key_compare(key_parts const &);
+    void normalize_key(key_mem, char * dest) const; // dest size is key_length
+    int compare_key(key_mem, key_mem) const;
+    int compare_normalized(key_mem, const char * norm) const; // sign of (key - normalized key)
+    shared_index_prefix load_prefix(page_head const *) const; // nullptr if key is not normalized, page is not admitted or cache is full
+
+    class search_key : noncopyable { // key is converted once for binary search in index pages
+        index_tree const * const tree;
+        key_mem const key;
+        int64 value = 0;            // key_compare::int32, key_compare::int64
+        vector_buf<char, 64> norm;  // key_compare::normalized
+    public:
+        search_key(index_tree const *, key_mem);
+        int compare(key_mem) const; // sign of (row key - search key)
+        index_prefix::value_type prefix() const {
+            return first_prefix(tree->m_parts[0], key.first);
+        }
+    };
 public:
     using row_iterator_value = row_access::value_type;
     using page_iterator_value = page_access::value_type;
@@ -152,6 +187,9 @@ public:
     pageFileID min_page() const;
     pageFileID max_page() const;
 
+    // all leaf pages in key order; page ids are read from index level above leaf, leaf pages are not loaded
+    std::vector<pageFileID> leaf_pages() const;
+
     row_access const _rows{ this };
     page_access const _pages{ this };
 
@@ -161,6 +199,8 @@ private:
     database const * const this_db;
     shared_cluster_index const cluster;
     size_t const key_length;
+    key_parts const m_parts;
+    key_compare const m_compare;
 };
 
 using shared_index_tree = std::shared_ptr<index_tree>;
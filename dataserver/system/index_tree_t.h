@@ -6,6 +6,7 @@
 
 #include "dataserver/system/datapage.h"
 #include "dataserver/system/database_fwd.h"
+#include "dataserver/system/index_tree.h"
 
 namespace sdl { namespace db { namespace make {
 
@@ -140,6 +141,15 @@ private:
     static bool less_first(first_key const & x, first_key const & y) {
         return key_type::this_clustered::less_first(x, y);
     }
+    static db::index_tree::key_part first_part() {
+        using T0 = typename key_type::this_clustered::T0;
+        return { T0::col::type, sizeof(first_key), T0::col::order == sortorder::DESC };
+    }
+    static index_prefix::value_type first_prefix(first_key const & x) {
+        return db::index_tree::first_prefix(first_part(), reinterpret_cast<const char *>(&x));
+    }
+    static constexpr bool first_exact = (sizeof(first_key) <= index_prefix::max_size); // prefix is whole first key
+    shared_index_prefix load_prefix(page_head const *) const; // nullptr if first key is not normalized, page is not admitted or cache is full
     template<typename make_query_type>
     pageFileID first_page_clustered(first_key const &, make_query_type const &, bool_constant<false>) const;
     template<typename make_query_type>
@@ -156,6 +166,10 @@ public:
     pageFileID min_page() const;
     pageFileID max_page() const;
 
+    // leaf pages from first (which contains key) to last inclusive or to the end if last is null;
+    // page ids are read from index level above leaf, leaf pages are not loaded
+    std::vector<pageFileID> leaf_pages(key_ref, pageFileID const & first, pageFileID const & last) const;
+
     row_access const _rows{ this };
     page_access const _pages{ this };
 
@@ -129,11 +129,29 @@ size_t index_tree<KEY_TYPE>::index_page::find_slot(key_ref m) const
 {
     const index_page_key data(this->head);
     index_page_row_key const * const null = head->data.prevPage ? nullptr : index_page_key(this->head).front();
-    size_t i = data.lower_bound([this, &m, null](index_page_row_key const * const x) {
-        if (x == null)
-            return true;
-        return index_tree::key_less(get_key(x), m);
-    });
+    size_t i;
+    if (shared_index_prefix const prefix = tree->load_prefix(this->head)) {
+        SDL_ASSERT(prefix->size() == data.size());
+        const index_prefix::value_type value = index_tree::first_prefix(m._0);
+        i = prefix->lower_bound(value, null ? 1 : 0);
+        if (!prefix->exact()) { // rows with equal prefix
+            size_t last = prefix->upper_bound(value, i);
+            while (i < last) {
+                const size_t mid = i + (last - i) / 2;
+                if (index_tree::key_less(row_key(mid), m))
+                    i = mid + 1;
+                else
+                    last = mid;
+            }
+        }
+    }
+    else {
+        i = data.lower_bound([this, &m, null](index_page_row_key const * const x) {
+            if (x == null)
+                return true;
+            return index_tree::key_less(get_key(x), m);
+        });
+    }
     SDL_ASSERT(i <= data.size());
     if (i < data.size()) {
         if (i && index_tree::key_less(m, row_key(i))) {
@@ -150,11 +168,29 @@ size_t index_tree<KEY_TYPE>::index_page::first_slot(first_key const & m) const
 {
     const index_page_key data(this->head);
     index_page_row_key const * const null = head->data.prevPage ? nullptr : index_page_key(this->head).front();
-    size_t i = data.lower_bound([this, &m, null](index_page_row_key const * const x) {
-        if (x == null)
-            return true;
-        return index_tree::less_first(get_key(x)._0, m);
-    });
+    size_t i;
+    if (shared_index_prefix const prefix = tree->load_prefix(this->head)) {
+        SDL_ASSERT(prefix->size() == data.size());
+        const index_prefix::value_type value = index_tree::first_prefix(m);
+        i = prefix->lower_bound(value, null ? 1 : 0);
+        if (!index_tree::first_exact) { // rows with equal prefix
+            size_t last = prefix->upper_bound(value, i);
+            while (i < last) {
+                const size_t mid = i + (last - i) / 2;
+                if (index_tree::less_first(row_key(mid)._0, m))
+                    i = mid + 1;
+                else
+                    last = mid;
+            }
+        }
+    }
+    else {
+        i = data.lower_bound([this, &m, null](index_page_row_key const * const x) {
+            if (x == null)
+                return true;
+            return index_tree::less_first(get_key(x)._0, m);
+        });
+    }
     SDL_ASSERT(i <= data.size());
     if (i < data.size()) {
         if (i && index_tree::less_first(m, row_key(i)._0)) {
@@ -166,6 +202,23 @@ size_t index_tree<KEY_TYPE>::index_page::first_slot(first_key const & m) const
     return i - 1; // last slot
 }
 
+template<typename KEY_TYPE>
+shared_index_prefix index_tree<KEY_TYPE>::load_prefix(page_head const * const head) const
+{
+    if (!db::index_tree::is_normalized(first_part())) {
+        return {};
+    }
+    return fwd::load_index_prefix(this_db, head, [head]() {
+        const index_page_key data(head);
+        index_prefix::vector_type v(data.size());
+        for (size_t i = 0; i < v.size(); ++i) {
+            v[i] = first_prefix(data[i]->data.key._0);
+        }
+        const bool exact = (KEY_TYPE::this_clustered::index_size == 1) && first_exact;
+        return std::make_shared<index_prefix>(std::move(v), exact);
+    });
+}
+
 template<typename KEY_TYPE>
 pageFileID index_tree<KEY_TYPE>::find_page(key_ref m) const
 {
@@ -303,6 +356,42 @@ pageFileID index_tree<KEY_TYPE>::max_page() const
     return id;
 }
 
+template<typename KEY_TYPE>
+std::vector<pageFileID>
+index_tree<KEY_TYPE>::leaf_pages(key_ref key, pageFileID const & first, pageFileID const & last) const
+{
+    index_page p(this, root(), 0);
+    while (1) {
+        p.slot = p.find_slot(key);
+        if (auto const head = fwd::load_page_head(this_db, p.row_page(p.slot))) {
+            if (head->is_index()) {
+                p.head = head;
+                p.slot = 0;
+                continue;
+            }
+            SDL_ASSERT(head->is_data());
+            break;
+        }
+        throw_error<index_tree_error>("bad index");
+    }
+    while (p.row_page(p.slot) != first) { // equal keys may span pages
+        load_next_row(p);
+        if (is_end_index(p)) {
+            throw_error<index_tree_error>("leaf page not found");
+        }
+    }
+    std::vector<pageFileID> result;
+    while (!is_end_index(p)) {
+        result.push_back(p.row_page(p.slot));
+        if (result.back() == last) {
+            break;
+        }
+        load_next_row(p);
+    }
+    SDL_ASSERT(!last || (result.back() == last));
+    return result;
+}
+
 } // make
 } // db
 } // sdl
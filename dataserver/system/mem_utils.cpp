@@ -98,6 +98,33 @@ bool mem_utils::memcpy_n(void * const dest, vector_mem_range_t const & src, cons
     }
 }
 
+bool mem_utils::memcpy_at(void * const dest, vector_mem_range_t const & src, size_t offset, const size_t size)
+{
+    SDL_ASSERT(dest);
+    if (mem_size(src) < offset + size) {
+        SDL_ASSERT(0);
+        memset(dest, 0, size);
+        return false;
+    }
+    size_t count = size;
+    char * buf = reinterpret_cast<char *>(dest);
+    for (auto const & m : src) {
+        const size_t m_size = mem_size(m);
+        if (offset >= m_size) { // skip fragment
+            offset -= m_size;
+            continue;
+        }
+        const size_t n = a_min(count, m_size - offset);
+        memcpy(buf, m.first + offset, n);
+        count -= n;
+        if (!count) break;
+        buf += n;
+        offset = 0;
+    }
+    SDL_ASSERT(!count);
+    return true;
+}
+
 } // db
 } // sdl
 
@@ -139,6 +166,11 @@ namespace sdl {
                         SDL_ASSERT(mem_size(array) == d0.size() + d1.size());
                         auto const v = mem_utils::make_vector(array);
                         SDL_ASSERT(v.size() == mem_size(array));
+                        char buf[4];
+                        SDL_ASSERT(mem_utils::memcpy_at(buf, array, 3, sizeof(buf)));
+                        SDL_ASSERT(!memcmp(buf, "1122", sizeof(buf)));
+                        SDL_ASSERT(mem_utils::memcpy_at(buf, array, 11, sizeof(buf)));
+                        SDL_ASSERT(!memcmp(buf, "2222", sizeof(buf)));
                     }
                     A_STATIC_ASSERT_IS_POD(first_second<void *, int>);
                     {
@@ -154,6 +154,7 @@ struct mem_utils : is_static {
     static vector_char make_vector(vector_mem_range_t const &); // note performance!
     static vector_char make_vector_n(vector_mem_range_t const &, size_t); // note performance!
     static bool memcpy_n(void * dest, vector_mem_range_t const &, size_t);
+    static bool memcpy_at(void * dest, vector_mem_range_t const &, size_t offset, size_t); // copy from any fragment
 
     template<class T>
     static bool memcpy_n(T & dest, vector_mem_range_t const & src) {
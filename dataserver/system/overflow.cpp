@@ -249,6 +249,250 @@ text_pointer_data::text_pointer_data(
     SDL_ASSERT(mem_size_n(m_data));
 }
 
+//------------------------------------------------------------------
+
+lob_reader::lob_reader(vector_mem_range_t const & data)
+{
+    size_t last = 0;
+    for (auto const & m : data) {
+        if (mem_size(m)) {
+            m_seg.push_back({ recordID(), last, last + mem_size(m), m });
+            last += mem_size(m);
+        }
+    }
+}
+
+lob_reader::lob_reader(database const * const db, row_head const * const row,
+                       size_t const i, scalartype::type const col_type)
+    : m_db(db)
+{
+    SDL_ASSERT(m_db && row);
+    if (!row->has_variable()) {
+        return;
+    }
+    const variable_array vars(row);
+    if (i >= vars.size()) {
+        SDL_ASSERT(!"wrong var_offset");
+        return;
+    }
+    const mem_range_t m = vars.var_data(i);
+    const size_t len = mem_size(m);
+    if (!len) {
+        return;
+    }
+    if (vars.is_complex(i)) {
+        if (len == sizeof(text_pointer)) { // 16 bytes
+            if ((col_type == scalartype::t_text) ||
+                (col_type == scalartype::t_ntext) ||
+                (col_type == scalartype::t_image)) {
+                m_lob = true;
+                load_text_pointer(reinterpret_cast<text_pointer const *>(m.first));
+                return;
+            }
+        }
+        else if (len >= sizeof(overflow_page)) { // 24 bytes + 12 bytes * link_count
+            const auto type = vars.var_complextype(i);
+            if ((type == complextype::row_overflow) || (type == complextype::blob_inline_root)) {
+                auto const page = reinterpret_cast<overflow_page const *>(m.first);
+                auto const link = reinterpret_cast<overflow_link const *>(page + 1);
+                const size_t link_count = (len - sizeof(overflow_page)) / sizeof(overflow_link);
+                SDL_ASSERT(!((len - sizeof(overflow_page)) % sizeof(overflow_link)));
+                SDL_ASSERT((type == complextype::blob_inline_root) || !link_count);
+                m_lob = true;
+                push_back(page->row, page->length);
+                for (size_t j = 0; j < link_count; ++j) {
+                    push_back(link[j].row, link[j].size); // size is offset of link end
+                }
+                return;
+            }
+        }
+    }
+    m_seg.push_back({ recordID(), 0, len, m }); // in-row-data
+}
+
+void lob_reader::push_back(recordID const & row, size_t const last)
+{
+    const size_t first = length();
+    throw_error_if_not<lob_reader_error>(first <= last, "bad LOB length");
+    if (first < last) {
+        m_seg.push_back({ row, first, last, {} });
+    }
+}
+
+void lob_reader::load_text_pointer(text_pointer const * const text_ptr)
+{
+    auto const page_row = m_db->load_page_row(text_ptr->row);
+    throw_error_if_not<lob_reader_error>(page_row.first && page_row.second, "LOB root not found");
+    SDL_ASSERT(page_row.first->data.type == pageType::type::textmix);
+    mem_range_t const m = page_row.second->fixed_data();
+    const size_t sz = mem_size(m);
+    throw_error_if_not<lob_reader_error>(sz > sizeof(lob_head), "bad LOB root");
+    lob_head const * const lob = reinterpret_cast<lob_head const *>(m.first);
+    if (lob->type == lobtype::LARGE_ROOT_YUKON) {
+        LargeRootYukon const * const root = reinterpret_cast<LargeRootYukon const *>(m.first);
+        throw_error_if_not<lob_reader_error>((sz >= sizeof(LargeRootYukon)) &&
+            root->curlinks && (root->curlinks <= root->maxlinks) && (sz >= root->length()),
+            "bad LOB root");
+        for (auto const & slot : root->array()) {
+            push_back(slot.row, slot.size); // size is offset of slot end
+        }
+    }
+    else if (lob->type == lobtype::SMALL_ROOT) {
+        LobSmallRoot const * const root = reinterpret_cast<LobSmallRoot const *>(m.first);
+        const char * const p1 = m.first + sizeof(LobSmallRoot);
+        const char * const p2 = p1 + root->length;
+        throw_error_if_not<lob_reader_error>((sz > sizeof(LobSmallRoot)) && (p2 <= m.second), "bad LOB root");
+        m_seg.push_back({ recordID(), 0, root->length, { p1, p2 } });
+    }
+    else {
+        throw_error<lob_reader_error>("LOB root not supported");
+    }
+}
+
+// loads textmix DATA row or replaces texttree row with its slots
+void lob_reader::load_segment(size_t const i) const
+{
+    SDL_ASSERT(m_db && !m_seg[i].is_loaded());
+    segment const s = m_seg[i];
+    auto const page_row = m_db->load_page_row(s.row);
+    throw_error_if_not<lob_reader_error>(page_row.first && page_row.second, "LOB row not found");
+    mem_range_t const m = page_row.second->fixed_data();
+    const size_t sz = mem_size(m);
+    throw_error_if_not<lob_reader_error>(sz > sizeof(lob_head), "bad LOB row");
+    lob_head const * const lob = reinterpret_cast<lob_head const *>(m.first);
+    if ((page_row.first->data.type == pageType::type::textmix) && (lob->type == lobtype::DATA)) {
+        throw_error_if_not<lob_reader_error>(sz - sizeof(lob_head) == s.last - s.first, "bad LOB data length");
+        m_seg[i].data = { m.first + sizeof(lob_head), m.second };
+        return;
+    }
+    if ((page_row.first->data.type == pageType::type::texttree) && (lob->type == lobtype::INTERNAL)) {
+        TextTreeInternal const * const root = reinterpret_cast<TextTreeInternal const *>(m.first);
+        throw_error_if_not<lob_reader_error>((sz >= sizeof(TextTreeInternal)) &&
+            root->curlinks && (root->curlinks <= root->maxlinks) && (sz >= root->length()),
+            "bad LOB texttree");
+        std::vector<segment> slots;
+        slots.reserve(root->curlinks);
+        size_t first = s.first;
+        for (auto const & slot : root->array()) { // size is offset of slot end
+            const size_t last = s.first + static_cast<size_t>(slot.size);
+            throw_error_if_not<lob_reader_error>((first < last) && (last <= s.last), "bad LOB texttree");
+            slots.push_back({ slot.row, first, last, {} });
+            first = last;
+        }
+        throw_error_if_not<lob_reader_error>(first == s.last, "bad LOB texttree length");
+        m_seg.erase(m_seg.begin() + i);
+        m_seg.insert(m_seg.begin() + i, slots.begin(), slots.end());
+        return;
+    }
+    throw_error<lob_reader_error>("LOB row not supported");
+}
+
+size_t lob_reader::load_at(size_t const pos) const
+{
+    SDL_ASSERT(pos < length());
+    for (;;) {
+        const auto it = std::upper_bound(m_seg.begin(), m_seg.end(), pos,
+            [](size_t const pos, segment const & s) {
+                return pos < s.last;
+        });
+        SDL_ASSERT(it != m_seg.end());
+        SDL_ASSERT(it->first <= pos);
+        const size_t i = it - m_seg.begin();
+        if (it->is_loaded()) {
+            return i;
+        }
+        load_segment(i);
+    }
+}
+
+vector_mem_range_t lob_reader::data(size_t const offset, size_t const count) const
+{
+    vector_mem_range_t result;
+    for_each([&result](mem_range_t const & m) {
+        result.push_back(m);
+        return true;
+    }, offset, count);
+    return result;
+}
+
+size_t lob_reader::read(char * const dest, size_t const offset, size_t const count) const
+{
+    char * p = dest;
+    for_each([&p](mem_range_t const & m) {
+        memcpy(p, m.first, mem_size(m));
+        p += mem_size(m);
+        return true;
+    }, offset, count);
+    return p - dest;
+}
+
+std::string lob_reader::substr(size_t const offset, size_t const count) const
+{
+    std::string s;
+    if (offset < length()) {
+        s.resize(end_pos(offset, count) - offset);
+        const size_t n = read(&s[0], offset, s.size());
+        SDL_ASSERT(n == s.size());
+        (void)n;
+    }
+    return s;
+}
+
+bool lob_reader::starts_with(const char * const prefix, size_t const size) const
+{
+    if (size > length()) {
+        return false;
+    }
+    const char * p = prefix;
+    return !is_break(for_each([&p](mem_range_t const & m) {
+        if (memcmp(p, m.first, mem_size(m))) {
+            return false;
+        }
+        p += mem_size(m);
+        return true;
+    }, 0, size));
+}
+
 } // db
 } // sdl
 
+#if SDL_DEBUG
+namespace sdl {
+    namespace db {
+        namespace {
+            class unit_test {
+            public:
+                unit_test()
+                {
+                    const char text[] = "0123456789abcdefghij";
+                    vector_mem_range_t data;
+                    data.push_back({ text, text + 3 });
+                    data.push_back({ text + 3, text + 10 });
+                    data.push_back({ text + 10, text + 20 });
+                    const lob_reader lob(data);
+                    SDL_ASSERT(lob.length() == 20);
+                    SDL_ASSERT(!lob.is_lob());
+                    SDL_ASSERT(lob.substr(0) == text);
+                    SDL_ASSERT(lob.substr(2, 3) == "234");
+                    SDL_ASSERT(lob.substr(9, 100) == "9abcdefghij");
+                    SDL_ASSERT(lob.substr(20).empty());
+                    SDL_ASSERT(lob.data(5, 10).size() == 2);
+                    SDL_ASSERT(mem_size_n(lob.data(5, 10)) == 10);
+                    SDL_ASSERT(lob.starts_with("0123", 4));
+                    SDL_ASSERT(!lob.starts_with("0124", 4));
+                    SDL_ASSERT(!lob.starts_with(text, 21));
+                    size_t chunks = 0;
+                    lob.for_each([&chunks](mem_range_t const &) {
+                        return ++chunks < 2;
+                    });
+                    SDL_ASSERT(chunks == 2);
+                    char buf[8];
+                    SDL_ASSERT(lob.read(buf, 18, sizeof(buf)) == 2);
+                    SDL_ASSERT(lob_reader().empty());
+                }
+            };
+            static unit_test s_test;
+        }
+    } // db
+} // sdl
+#endif //#if SDL_DEBUG
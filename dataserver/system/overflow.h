@@ -63,6 +63,76 @@ public:
     text_pointer_data(database const *, text_pointer const *);
 };
 
+// Lazy reader of variable column data which can be stored off-row (text_pointer, row-overflow, blob inline root).
+// Length is taken from pointers where it is encoded, LOB pages are loaded only for the requested range
+// and LOB roots (texttree) are expanded on demand. Memory ranges point to pages like vector_mem_range_t
+// returned by database::var_data. Reader is not thread-safe, it caches loaded rows.
+class lob_reader {
+    using lob_reader_error = sdl_exception_t<lob_reader>;
+public:
+    static constexpr size_t npos = size_t(-1);
+    lob_reader() = default;
+    lob_reader(database const *, row_head const *, size_t var_index, scalartype::type); // throws if LOB root is not supported
+    explicit lob_reader(vector_mem_range_t const &); // data already loaded
+    lob_reader(lob_reader &&) = default;
+    lob_reader & operator=(lob_reader &&) = default;
+    size_t length() const { // bytes
+        return m_seg.empty() ? 0 : m_seg.back().last;
+    }
+    bool empty() const {
+        return m_seg.empty();
+    }
+    bool is_lob() const { // data is stored off-row
+        return m_lob;
+    }
+    template<class fun_type> // fun(mem_range_t) returns bool or break_or_continue
+    break_or_continue for_each(fun_type &&, size_t offset = 0, size_t count = npos) const;
+    vector_mem_range_t data(size_t offset = 0, size_t count = npos) const;
+    size_t read(char * dest, size_t offset, size_t count) const; // returns bytes copied
+    std::string substr(size_t offset, size_t count = npos) const;
+    bool starts_with(const char *, size_t) const;
+private:
+    struct segment {
+        recordID row;       // LOB row, not used if data is loaded
+        size_t first;       // offset in column data
+        size_t last;
+        mem_range_t data;   // loaded memory
+        bool is_loaded() const {
+            return data.first != nullptr;
+        }
+    };
+    void push_back(recordID const &, size_t last);
+    void load_text_pointer(text_pointer const *);
+    size_t load_at(size_t pos) const; // returns index of loaded segment which contains pos
+    void load_segment(size_t) const;
+    size_t end_pos(size_t offset, size_t count) const {
+        return (count < length() - offset) ? (offset + count) : length();
+    }
+private:
+    database const * m_db = nullptr;
+    bool m_lob = false;
+    mutable std::vector<segment> m_seg;
+};
+
+template<class fun_type>
+break_or_continue lob_reader::for_each(fun_type && fun, size_t const offset, size_t const count) const
+{
+    if (offset < length()) {
+        const size_t end = end_pos(offset, count);
+        size_t pos = offset;
+        while (pos < end) {
+            segment const & s = m_seg[load_at(pos)];
+            const size_t last = a_min(end, s.last);
+            const mem_range_t m(s.data.first + (pos - s.first), s.data.first + (last - s.first));
+            if (is_break(make_break_or_continue(fun(m)))) {
+                return bc::break_;
+            }
+            pos = last;
+        }
+    }
+    return bc::continue_;
+}
+
 } // db
 } // sdl
 
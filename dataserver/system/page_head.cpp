@@ -130,6 +130,19 @@ bool row_data::is_fixed(size_t const i) const
 //--------------------------------------------------------------
 //https://en.wikipedia.org/wiki/Cyclic_redundancy_check
 
+namespace {
+
+// XOR of 128 words of sector as 64 words of 64 bits, no branches in loop (vectorized by compiler)
+inline uint32 sector_xor(uint64 const * const p) {
+    uint64 x = 0;
+    for (size_t j = 0; j < 64; ++j) {
+        x ^= p[j];
+    }
+    return static_cast<uint32>(x) ^ static_cast<uint32>(x >> 32);
+}
+
+} // namespace
+
 int32 page_head::checksum(page_head const * const head)
 {
     SDL_ASSERT(head);
@@ -137,22 +150,23 @@ int32 page_head::checksum(page_head const * const head)
     enum { sectnum = 16 };
     enum { elemnum = 128 };
     static_assert(offsetof(page_head, data.tornBits) == 15 * sizeof(uint32), "");
+    static_assert(page_head::head_size == 24 * sizeof(uint32), "");
     using sectors = uint32[sectnum][elemnum];
     static_assert(sizeof(sectors) == page_head::page_size, "");
-    uint32 const * p = reinterpret_cast<uint32 const *>(head);
-    uint32 const * const tornBits = p + 15; // this field will be discarded in algorithm
-    SDL_ASSERT((uint32)head->data.tornBits == *tornBits);
-    uint32 const * const body = reinterpret_cast<uint32 const *>(page_head::body(head));
+    uint32 const * const p = reinterpret_cast<uint32 const *>(head);
+    SDL_ASSERT((uint32)head->data.tornBits == p[15]);
+    uint64 const * const p64 = reinterpret_cast<uint64 const *>(head);
     uint32 uchecksum = 0;
     for (uint32 i = 0; i < sectnum; ++i) {
-        uint32 overall = 0;
-        for (uint32 j = 0; j < elemnum; ++j, ++p) {
-            if ((p < tornBits) || (p >= body)) { // ignore tornBits and reserved
-                overall ^= *p;
-            }
-        }
-        uchecksum ^= a_rotl32(overall, seed - i);
+        uchecksum ^= a_rotl32(sector_xor(p64 + i * elemnum / 2), seed - i);
+    }
+    // tornBits and reserved (words 15..23) are discarded in algorithm:
+    // remove them from first sector, rotation is distributive over XOR
+    uint32 discard = 0;
+    for (size_t j = 15; j < 24; ++j) {
+        discard ^= p[j];
     }
+    uchecksum ^= a_rotl32(discard, seed);
     const int32 & checksum = reinterpret_cast<int32&>(uchecksum);
     SDL_ASSERT(!head->data.tornBits || (checksum == head->data.tornBits));
     return checksum;
@@ -214,6 +228,71 @@ namespace sdl {
                         SDL_TRACE("sizeof(size_t) == ", sizeof(size_t)); // must be 8 for 64-bit
                     }
                     A_STATIC_ASSERT_64_BIT;
+                    test_checksum();
+                    test_row_view();
+                }
+                static int32 checksum_reference(page_head const * const head) { // per-word loop
+                    uint32 const * p = reinterpret_cast<uint32 const *>(head);
+                    uint32 const * const tornBits = p + 15;
+                    uint32 const * const body = reinterpret_cast<uint32 const *>(page_head::body(head));
+                    uint32 uchecksum = 0;
+                    for (uint32 i = 0; i < 16; ++i) {
+                        uint32 overall = 0;
+                        for (uint32 j = 0; j < 128; ++j, ++p) {
+                            if ((p < tornBits) || (p >= body)) {
+                                overall ^= *p;
+                            }
+                        }
+                        uchecksum ^= a_rotl32(overall, 15 - i);
+                    }
+                    return static_cast<int32>(uchecksum);
+                }
+                static void test_checksum() {
+                    std::vector<uint64> buf(page_head::page_size / sizeof(uint64));
+                    page_head * const head = reinterpret_cast<page_head *>(buf.data());
+                    uint32 * const p = reinterpret_cast<uint32 *>(buf.data());
+                    uint32 r = 1;
+                    for (size_t test = 0; test < 4; ++test) {
+                        for (size_t i = 0; i < page_head::page_size / sizeof(uint32); ++i) {
+                            r = r * 1664525 + 1013904223; // LCG
+                            p[i] = r;
+                        }
+                        head->data.tornBits = 0;
+                        const int32 expect = checksum_reference(head);
+                        SDL_ASSERT(page_head::checksum(head) == expect);
+                        head->data.tornBits = expect;
+                        SDL_ASSERT(page_head::checksum(head) == expect);
+                        p[16] ^= r; // reserved is ignored
+                        SDL_ASSERT(page_head::checksum(head) == expect);
+                        p[24] ^= 1; // body is not ignored
+                        SDL_ASSERT(checksum_reference(head) != expect);
+                    }
+                }
+                static void test_row_view() {
+                    const uint8 row[] = {
+                        0x30, 0, 8, 0,          // has_null, has_variable, fixedlen = 8
+                        42, 0, 0, 0,            // int32 column
+                        4, 0, 0x04,             // 4 columns, column [2] is NULL
+                        2, 0, 20, 0, 22, 0x80,  // 2 variable columns, second is complex
+                        'a', 'b', 'c', 'd', 'e' };
+                    row_head const * const head = reinterpret_cast<row_head const *>(row);
+                    const null_bitmap nulls(head);
+                    const variable_array vars(head);
+                    const row_view_t<4, 2> view(head);
+                    for (size_t i = 0; i < 4; ++i) {
+                        SDL_ASSERT(view.is_null(i) == nulls[i]);
+                    }
+                    SDL_ASSERT(view.var_count() == vars.size());
+                    for (size_t i = 0; i < 2; ++i) {
+                        SDL_ASSERT(view.var_data(i) == vars.var_data(i));
+                        SDL_ASSERT(view.is_complex(i) == vars.is_complex(i));
+                    }
+                    SDL_ASSERT(mem_size(view.var_data(0)) == 3);
+                    SDL_ASSERT(view.is_complex(1));
+                    const row_view_t<6, 3> wide(head); // columns added after row was written
+                    SDL_ASSERT(wide.is_null(4) && wide.is_null(5));
+                    SDL_ASSERT(wide.var_count() == 2);
+                    SDL_ASSERT(mem_size(wide.var_data(2)) == 0);
                 }
                 A_STATIC_ASSERT_IS_POD(row_head);
                 A_STATIC_ASSERT_IS_POD(overflow_page);
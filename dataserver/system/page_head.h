@@ -525,6 +525,68 @@ public:
     }
 };
 
+// null bitmap and variable offsets of a row parsed once for access to many columns;
+// null_size and var_size are known at compile time (e.g. from maketable columns),
+// columns missing in record (added after row was written) are read as NULL
+template<size_t null_size, size_t var_size>
+class row_view_t {
+    static constexpr size_t null_bytes = (null_size + 7) / 8;
+    row_head const * m_row = nullptr;
+    const char * m_var_begin = nullptr;         // start of variable data
+    uint16 m_null_count = 0;                    // columns in null bitmap
+    uint16 m_var_count = 0;                     // variable columns in record
+    uint8 m_null[null_bytes ? null_bytes : 1]{};
+    uint16 m_var_end[var_size ? var_size : 1];  // offsets with high-bit
+public:
+    explicit row_view_t(row_head const * const row) : m_row(row) {
+        SDL_ASSERT(m_row);
+        const char * p = row_head::begin(m_row) + m_row->data.fixedlen;
+        if (m_row->has_null()) {
+            m_null_count = *reinterpret_cast<uint16 const *>(p);
+            p += sizeof(uint16);
+            const size_t bytes = (m_null_count + 7) / 8;
+            memcpy(m_null, p, a_min(bytes, size_t(null_bytes)));
+            for (size_t i = m_null_count; i < null_size; ++i) { // missing columns
+                m_null[i >> 3] |= uint8(1 << (i & 7));
+            }
+            p += bytes;
+        }
+        if (var_size && m_row->has_variable()) {
+            m_var_count = *reinterpret_cast<uint16 const *>(p);
+            p += sizeof(uint16);
+            memcpy(m_var_end, p, a_min(size_t(m_var_count), size_t(var_size)) * sizeof(uint16));
+            p += m_var_count * sizeof(uint16);
+        }
+        m_var_begin = p;
+    }
+    row_head const * head() const {
+        return m_row;
+    }
+    bool is_null(size_t const place) const {
+        SDL_ASSERT(place < null_size);
+        return (m_null[place >> 3] >> (place & 7)) & 1;
+    }
+    size_t var_count() const {
+        return a_min(size_t(m_var_count), size_t(var_size));
+    }
+    bool is_complex(size_t const i) const {
+        SDL_ASSERT(i < var_count());
+        return variable_array::is_highbit(m_var_end[i]);
+    }
+    mem_range_t var_data(size_t const i) const { // same as variable_array::var_data
+        if (i < var_count()) {
+            const char * const start = row_head::begin(m_row);
+            const char * const first = i ? (start + variable_array::highbit_off(m_var_end[i - 1])) : m_var_begin;
+            const char * const last = start + variable_array::highbit_off(m_var_end[i]);
+            if (first <= last) {
+                return { first, last };
+            }
+            SDL_ASSERT(!"var_data");
+        }
+        return{};
+    }
+};
+
 struct page_head_meta: is_static {
 
     typedef_col_type_n(page_head, headerVersion);
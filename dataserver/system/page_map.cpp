@@ -4,18 +4,23 @@
 
 namespace sdl { namespace db {
 
-PageMapping::PageMapping(const std::string & fname)
+PageMapping::PageMapping(const std::string & fname, database_cfg const & cfg)
     : init_thread_id(std::this_thread::get_id())
 {
     static_assert(page_size == 8 * 1024, "");
     static_assert(page_size == (1 << 13), ""); // 8192 = 2^13
-    if (m_fmap.CreateMapView(fname.c_str())) {
+    const bool populate = cfg.map_populate &&
+        (FileMapping::GetFileSize(fname) <= uint64(cfg.map_populate) * megabyte<1>::value);
+    if (m_fmap.CreateMapView(fname.c_str(), populate)) {
         const uint64 sz = m_fmap.GetFileSize();
         const uint64 pp = sz / page_size;
         SDL_ASSERT(!(sz % page_size));
         SDL_ASSERT(pp < size_t(-1));
         throw_error_if<PageMapping_error>((sz % page_size)!=0, "bad file size");
         m_pageCount = static_cast<size_t>(pp);
+        if (cfg.advice != map_advice::normal) {
+            m_fmap.Advise(0, sz, cfg.advice);
+        }
     }
     else {
         SDL_WARNING(false);
@@ -5,7 +5,7 @@
 #define __SDL_SYSTEM_PAGE_MAP_H__
 
 #include "dataserver/system/page_head.h"
-#include "dataserver/filesys/file_map.h"
+#include "dataserver/system/database_cfg.h"
 #include <thread>
 
 namespace sdl { namespace db {
@@ -15,7 +15,7 @@ class PageMapping : noncopyable {
     using thread_id = std::thread::id;
 public:
     const thread_id init_thread_id;
-    explicit PageMapping(const std::string & fname);
+    explicit PageMapping(const std::string & fname, database_cfg const & = {});
     bool is_open() const {
         return m_fmap.IsFileMapped();
     }
@@ -30,6 +30,12 @@ public:
     }
     page_head const * lock_page(pageIndex) const; // load_page
     bool unlock_page(pageIndex) const;
+    void prefetch(pageIndex, size_t count) const; // read-ahead hint for count pages
+    bool advise(pageIndex, size_t count, map_advice) const;
+    bool lock(pageIndex, size_t count, bool) const; // mlock (munlock) pages
+    static page_faults get_page_faults() {
+        return FileMapping::GetPageFaults();
+    }
 private:
     using PageMapping_error = sdl_exception_t<PageMapping>;
     size_t m_pageCount = 0;
@@ -53,6 +59,26 @@ inline bool PageMapping::unlock_page(pageIndex const id) const {
     return false;
 }
 
+inline void PageMapping::prefetch(pageIndex const i, size_t const count) const {
+    advise(i, count, map_advice::willneed);
+}
+
+inline bool PageMapping::advise(pageIndex const i, size_t const count, map_advice const advice) const {
+    const size_t page = i.value();
+    if (page < m_pageCount) {
+        return m_fmap.Advise(uint64(page) * page_size, uint64(a_min(count, m_pageCount - page)) * page_size, advice);
+    }
+    return false;
+}
+
+inline bool PageMapping::lock(pageIndex const i, size_t const count, bool const value) const {
+    const size_t page = i.value();
+    if (page < m_pageCount) {
+        return m_fmap.Lock(uint64(page) * page_size, uint64(a_min(count, m_pageCount - page)) * page_size, value);
+    }
+    return false;
+}
+
 } // db
 } // sdl
 
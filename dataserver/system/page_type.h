@@ -353,9 +353,22 @@ struct guid_t // 16 bytes
     uint8 j; // 5
     uint8 k; // 6
 
-    // SQL Server behavior : in the last six bytes of a value are most significant.
+    // SQL Server behavior : in the last six bytes of a value are most significant,
+    // then bytes 8-9, 6-7, 4-5 and 0-3; bytes of each group are compared in memory order
+    static uint8 const * byte_order() {
+        static const uint8 order[16] = { 10, 11, 12, 13, 14, 15, 8, 9, 6, 7, 4, 5, 0, 1, 2, 3 };
+        return order;
+    }
     static int compare(guid_t const & x, guid_t const & y) {
-        return ::memcmp(&x.f, &y.f, 6);
+        uint8 const * const px = reinterpret_cast<uint8 const *>(&x);
+        uint8 const * const py = reinterpret_cast<uint8 const *>(&y);
+        uint8 const * const order = byte_order();
+        for (size_t i = 0; i < 16; ++i) {
+            if (px[order[i]] != py[order[i]]) {
+                return (px[order[i]] < py[order[i]]) ? -1 : 1;
+            }
+        }
+        return 0;
     }
 };
 
@@ -402,6 +415,8 @@ struct pageFileID // 6 bytes
     page32 pageId;  // 4 bytes : PageID
     file16 fileId;  // 2 bytes : FileID
 
+    enum { primary_file = 1 }; // FileID of primary data file (.mdf)
+
     bool is_null() const {
         SDL_ASSERT(fileId || !pageId); // 0:0 if is_null
         return 0 == fileId;
@@ -415,7 +430,7 @@ struct pageFileID // 6 bytes
         if (pageId < y.pageId) return -1;
         return (y.pageId < pageId) ? 1 : 0;
     }
-    static pageFileID init(page32 const pageId, file16 const fileId = 1) {
+    static pageFileID init(page32 const pageId, file16 const fileId = primary_file) {
         SDL_ASSERT(fileId || !pageId); // 0:0 if is_null
         return { pageId, fileId };
     }
@@ -0,0 +1,147 @@
+// pfs_bitmap.cpp
+//
+#include "dataserver/system/pfs_bitmap.h"
+#include "dataserver/common/algorithm.h"
+
+namespace sdl { namespace db {
+
+namespace {
+
+using algo::bit_scan_forward;
+using algo::bit_count;
+
+// mask of bits [first, last) of word, 0 <= first < last <= 64
+inline uint64 bit_mask(size_t const first, size_t const last) {
+    SDL_ASSERT(first < last);
+    SDL_ASSERT(last <= 64);
+    const uint64 hi = (last < 64) ? ((uint64(1) << last) - 1) : ~uint64(0);
+    return hi & ~((uint64(1) << first) - 1);
+}
+
+} // namespace
+
+pfs_bitmap::pfs_bitmap(size_t const page_count)
+    : m_page_count(page_count)
+    , m_interval_count((page_count + pfs_size - 1) / pfs_size)
+    , m_bits(new std::atomic<word_type>[(page_count + word_bits - 1) / word_bits])
+    , m_loaded(new std::atomic<bool>[m_interval_count])
+{
+    const size_t words = (page_count + word_bits - 1) / word_bits;
+    for (size_t i = 0; i < words; ++i) {
+        m_bits[i].store(0, std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < m_interval_count; ++i) {
+        m_loaded[i].store(false, std::memory_order_relaxed);
+    }
+}
+
+void pfs_bitmap::load(size_t const i, pfs_page_row const & row)
+{
+    SDL_ASSERT(i < m_interval_count);
+    if (is_loaded(i)) {
+        return;
+    }
+    const size_t first = i * pfs_size;
+    const size_t last = a_min(first + pfs_size, m_page_count);
+    word_type w = 0;
+    size_t w_index = first / word_bits;
+    for (size_t p = first; p < last; ++p) {
+        if (p / word_bits != w_index) {
+            if (w) {
+                m_bits[w_index].fetch_or(w, std::memory_order_relaxed);
+            }
+            w_index = p / word_bits;
+            w = 0;
+        }
+        if (row[p - first].is_allocated()) {
+            w |= word_type(1) << (p % word_bits);
+        }
+    }
+    if (w) {
+        m_bits[w_index].fetch_or(w, std::memory_order_relaxed);
+    }
+    m_loaded[i].store(true, std::memory_order_release); // same bits can be loaded twice by concurrent threads
+}
+
+size_t pfs_bitmap::find_next(size_t first, size_t const last) const
+{
+    SDL_ASSERT(last <= m_page_count);
+    while (first < last) {
+        const size_t w_index = first / word_bits;
+        const size_t w_last = a_min(last - w_index * word_bits, size_t(word_bits));
+        const word_type w = word(w_index) & bit_mask(first % word_bits, w_last);
+        if (w) {
+            return w_index * word_bits + bit_scan_forward(w);
+        }
+        first = (w_index + 1) * word_bits;
+    }
+    return last;
+}
+
+size_t pfs_bitmap::count(size_t first, size_t const last) const
+{
+    SDL_ASSERT(last <= m_page_count);
+    size_t result = 0;
+    while (first < last) {
+        const size_t w_index = first / word_bits;
+        const size_t w_last = a_min(last - w_index * word_bits, size_t(word_bits));
+        result += bit_count(word(w_index) & bit_mask(first % word_bits, w_last));
+        first = (w_index + 1) * word_bits;
+    }
+    return result;
+}
+
+} // db
+} // sdl
+
+#if SDL_DEBUG
+namespace sdl {
+    namespace db {
+        namespace {
+            class unit_test {
+            public:
+                unit_test()
+                {
+                    const size_t page_count = pfs_bitmap::pfs_size * 2 + 100;
+                    pfs_bitmap test(page_count);
+                    SDL_ASSERT(test.interval_count() == 3);
+                    std::vector<char> raw(sizeof(pfs_page_row));
+                    pfs_page_row & row = *reinterpret_cast<pfs_page_row *>(raw.data());
+                    std::vector<bool> expect(page_count);
+                    for (size_t i = 0; i < test.interval_count(); ++i) {
+                        for (size_t j = 0; j < pfs_bitmap::pfs_size; ++j) {
+                            const size_t p = i * pfs_bitmap::pfs_size + j;
+                            const bool b = ((p % 7) == 0) || ((p / 500) % 3 == 1);
+                            row.data.body[j].byte = 0;
+                            row.data.body[j].b.allocated = b;
+                            if (p < page_count) {
+                                expect[p] = b;
+                            }
+                        }
+                        SDL_ASSERT(!test.is_loaded(i));
+                        test.load(i, row);
+                        SDL_ASSERT(test.is_loaded(i));
+                    }
+                    size_t total = 0;
+                    for (size_t p = 0; p < page_count; ++p) {
+                        SDL_ASSERT(test.is_allocated(p) == expect[p]);
+                        total += expect[p];
+                    }
+                    SDL_ASSERT(test.count(0, page_count) == total);
+                    SDL_ASSERT(test.count(10, 10) == 0);
+                    size_t found = 0;
+                    for (size_t p = test.find_next(0, page_count); p < page_count; p = test.find_next(p + 1, page_count)) {
+                        SDL_ASSERT(expect[p]);
+                        ++found;
+                    }
+                    SDL_ASSERT(found == total);
+                    SDL_ASSERT(test.find_next(501, 505) == 501);
+                    SDL_ASSERT(test.find_next(1, 7) == 7);
+                    SDL_ASSERT(test.find_next(1, 6) == 6);
+                }
+            };
+            static unit_test s_test;
+        }
+    } // db
+} // sdl
+#endif //#if SDL_DEBUG
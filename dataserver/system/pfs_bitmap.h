@@ -0,0 +1,56 @@
+// pfs_bitmap.h
+//
+#pragma once
+#ifndef __SDL_SYSTEM_PFS_BITMAP_H__
+#define __SDL_SYSTEM_PFS_BITMAP_H__
+
+#include "dataserver/sysobj/pfs_page.h"
+
+namespace sdl { namespace db {
+
+// allocation bitmap of database file, 1 bit per page (16 MB per TB);
+// filled lazily per PFS interval (pfs_size pages described by one PFS page)
+class pfs_bitmap : noncopyable {
+    using word_type = uint64;
+    enum { word_bits = 64 };
+public:
+    enum { pfs_size = pfs_page_row::pfs_size };
+    explicit pfs_bitmap(size_t page_count);
+    size_t page_count() const {
+        return m_page_count;
+    }
+    size_t interval_count() const {
+        return m_interval_count;
+    }
+    static size_t interval(size_t const pageId) {
+        return pageId / pfs_size;
+    }
+    bool is_loaded(size_t const i) const {
+        SDL_ASSERT(i < m_interval_count);
+        return m_loaded[i].load(std::memory_order_acquire);
+    }
+    void load(size_t interval, pfs_page_row const &); // thread-safe
+    bool is_allocated(size_t const pageId) const { // interval must be loaded
+        SDL_ASSERT(pageId < m_page_count);
+        SDL_ASSERT(is_loaded(interval(pageId)));
+        return (word(pageId / word_bits) >> (pageId % word_bits)) & 1;
+    }
+    // first allocated page in range [first, last) or last if not found; intervals must be loaded
+    size_t find_next(size_t first, size_t last) const;
+    // number of allocated pages in range [first, last); intervals must be loaded
+    size_t count(size_t first, size_t last) const;
+private:
+    word_type word(size_t const i) const {
+        return m_bits[i].load(std::memory_order_relaxed);
+    }
+private:
+    size_t const m_page_count;
+    size_t const m_interval_count;
+    std::unique_ptr<std::atomic<word_type>[]> m_bits; // intervals share boundary words
+    std::unique_ptr<std::atomic<bool>[]> m_loaded;
+};
+
+} // db
+} // sdl
+
+#endif // __SDL_SYSTEM_PFS_BITMAP_H__
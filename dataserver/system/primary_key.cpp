@@ -44,6 +44,164 @@ cluster_index::cluster_index(
     SDL_ASSERT(m_key_length);
 }
 
+secondary_index::secondary_index(
+    page_head const * const p,
+    sysidxstats_row const * const stat,
+    shared_usertable const & s,
+    column_index && key,
+    column_order && ord,
+    column_index const & included,
+    shared_cluster_index const & cluster)
+    : m_root(p), idxstat(stat)
+    , m_schema(s)
+    , m_index(std::move(key))
+    , m_order(std::move(ord))
+    , m_cluster(cluster)
+{
+    SDL_ASSERT(m_root && idxstat && m_schema);
+    SDL_ASSERT(m_root->is_index());
+    SDL_ASSERT(!idxstat->is_clustered());
+    SDL_ASSERT(this->size() && (m_order.size() == m_index.size()));
+
+    std::vector<size_t> key_offset(size());
+    for (size_t i = 0, end = size(); i < end; ++i) {
+        key_offset[i] = 1 + m_key_length;
+        m_key_length += (*this)[i].fixed_size();
+    }
+    if (m_cluster) { // columns of cluster key are not repeated in bookmark
+        m_cluster_offset.resize(m_cluster->size());
+        for (size_t i = 0, end = m_cluster->size(); i < end; ++i) {
+            auto const found = std::find(m_index.begin(), m_index.end(), m_cluster->col_ind(i));
+            if (found != m_index.end()) {
+                m_cluster_offset[i] = key_offset[found - m_index.begin()];
+            }
+            else {
+                m_cluster_offset[i] = 1 + m_key_length + m_bookmark_length;
+                m_bookmark_length += m_cluster->sub_key_length(i);
+            }
+        }
+    }
+    else {
+        m_bookmark_length = sizeof(recordID);
+    }
+    size_t included_length = 0;
+    for (size_t const i : included) {
+        if (m_schema->is_fixed(i)) {
+            included_length += (*m_schema)[i].fixed_size();
+        }
+    }
+    m_layout.key_size = (*this)[0].fixed_size();
+    m_layout.leaf_fixed = m_key_length + m_bookmark_length + included_length;
+    m_layout.node_fixed = m_key_length + (is_unique() ? 0 : m_bookmark_length) + sizeof(pageFileID);
+    m_layout.descending = (sortorder::DESC == col_ord(0));
+    SDL_ASSERT(m_key_length && m_bookmark_length);
+}
+
+recordID secondary_index::get_RID(row_head const * const row) const
+{
+    SDL_ASSERT(is_heap());
+    recordID id;
+    memcpy(&id, reinterpret_cast<const char *>(row) + 1 + m_key_length, sizeof(id));
+    return id;
+}
+
+void secondary_index::get_cluster_key(row_head const * const row, char * dest) const
+{
+    SDL_ASSERT(!is_heap());
+    const char * const p = reinterpret_cast<const char *>(row);
+    for (size_t i = 0, end = m_cluster_offset.size(); i < end; ++i) {
+        const size_t len = m_cluster->sub_key_length(i);
+        memcpy(dest, p + m_cluster_offset[i], len);
+        dest += len;
+    }
+}
+
 } // db
 } // sdl
 
+#if SDL_DEBUG
+namespace sdl {
+    namespace db {
+        namespace {
+            class unit_test {
+                static pageFileID make_page(uint32 const id) {
+                    pageFileID page{};
+                    if (id) {
+                        page.pageId = id;
+                        page.fileId = 1;
+                    }
+                    return page;
+                }
+                struct test_page {
+                    union {
+                        page_head head;
+                        char raw[page_head::page_size];
+                    };
+                    test_page(uint32 const id, uint8 const level) {
+                        memset(raw, 0, sizeof(raw));
+                        head.data.type = pageType::init(pageType::type::index);
+                        head.data.level = level;
+                        head.data.pageId = make_page(id);
+                        head.data.freeData = page_head::head_size;
+                    }
+                    void push_back(int32 const key, uint8 const status, uint32 const child) { // key, RID or child page
+                        char * const row = raw + head.data.freeData;
+                        row[0] = char(status);
+                        memcpy(row + 1, &key, sizeof(key));
+                        const pageFileID page = make_page(child);
+                        memcpy(row + 1 + sizeof(key) + sizeof(recordID), &page, sizeof(page));
+                        reinterpret_cast<uint16 *>(raw + page_head::page_size)[-1 - int(head.data.slotCnt++)] = head.data.freeData;
+                        head.data.freeData += 32;
+                    }
+                };
+            public:
+                unit_test()
+                {
+                    secondary_index::tree_layout t; // int key and RID, not unique
+                    t.key_size = sizeof(int32);
+                    t.leaf_fixed = t.key_size + sizeof(recordID);
+                    t.node_fixed = t.leaf_fixed + sizeof(pageFileID);
+                    enum { index_row = 3 << 1, ghost_row = 5 << 1 };
+                    test_page root(1, 1), leaf1(2, 0), leaf2(3, 0);
+                    root.push_back(0, index_row, 2);
+                    root.push_back(5, index_row, 3);
+                    for (int32 i : { 1, 3, 5, 5 }) {
+                        leaf1.push_back(i, index_row, 0);
+                    }
+                    for (int32 i : { 5, 6, 7, 9 }) {
+                        leaf2.push_back(i, (i == 7) ? ghost_row : index_row, 0);
+                    }
+                    leaf1.head.data.nextPage = make_page(3);
+                    auto const load = [&leaf1, &leaf2](pageFileID const & id) -> page_head const * {
+                        return (id.pageId == 2) ? &leaf1.head : ((id.pageId == 3) ? &leaf2.head : nullptr);
+                    };
+                    auto const key = [](mem_range_t const & m) {
+                        int32 v;
+                        memcpy(&v, m.first, sizeof(v));
+                        return v;
+                    };
+                    auto const range = [&t, &root, &load, &key](int32 const lo, int32 const hi) {
+                        std::vector<int32> result;
+                        secondary_index::scan_range(t, &root.head, load,
+                            [lo, &key](mem_range_t const & m) { return key(m) < lo; },
+                            [hi, &key](mem_range_t const & m) { return key(m) > hi; },
+                            [&result, &key](row_head const * row) {
+                                const char * const p = reinterpret_cast<const char *>(row);
+                                result.push_back(key({ p + 1, p + 5 }));
+                                return true;
+                            });
+                        return result;
+                    };
+                    SDL_ASSERT(range(5, 5) == std::vector<int32>({ 5, 5, 5 }));
+                    SDL_ASSERT(range(2, 6) == std::vector<int32>({ 3, 5, 5, 5, 6 }));
+                    SDL_ASSERT(range(6, 9) == std::vector<int32>({ 6, 9 }));
+                    SDL_ASSERT(range(0, 100).size() == 7);
+                    SDL_ASSERT(range(10, 100).empty());
+                    SDL_ASSERT(range(-5, 0).empty());
+                }
+            };
+            static unit_test s_test;
+        }
+    } // db
+} // sdl
+#endif //#if SDL_DEBUG
@@ -128,6 +128,189 @@ private:
 using unique_cluster_index = std::unique_ptr<cluster_index>;
 using shared_cluster_index = std::shared_ptr<cluster_index>;
 
+// Non-clustered index with fixed-length key columns.
+// Fixed data of leaf row: key columns, bookmark (columns of cluster key which are not in key or RID of heap row),
+// included columns; fixed data of non-leaf row: key columns, bookmark (if index is not unique), child page.
+class secondary_index: noncopyable {
+    using secondary_index_error = sdl_exception_t<secondary_index>;
+public:
+    using column = usertable::column;
+    using column_ref = column const &;
+    using column_index = std::vector<size_t>;
+    using column_order = std::vector<sortorder>;
+    struct tree_layout { // sizes of fixed data after status byte of index row
+        size_t key_size = 0;        // first key column
+        size_t leaf_fixed = 0;      // fixed data of leaf row
+        size_t node_fixed = 0;      // fixed data of non-leaf row including child page
+        bool descending = false;    // order of first key column
+    };
+public:
+    secondary_index(page_head const *, sysidxstats_row const *, shared_usertable const &,
+        column_index && key, column_order &&, column_index const & included,
+        shared_cluster_index const &);
+
+    page_head const * root() const {
+        return m_root;
+    }
+    schobj_id get_id() const {
+        return m_schema->get_id();
+    }
+    index_id get_indid() const {
+        return idxstat->data.indid;
+    }
+    std::string name() const {
+        return col_name_t(idxstat);
+    }
+    bool is_unique() const {
+        return idxstat->IsUnique();
+    }
+    bool is_heap() const { // bookmark is RID
+        return !m_cluster;
+    }
+    size_t size() const {
+        return m_index.size();
+    }
+    size_t col_ind(size_t i) const {
+        SDL_ASSERT(i < size());
+        return m_index[i];
+    }
+    sortorder col_ord(size_t i) const {
+        SDL_ASSERT(i < size());
+        return m_order[i];
+    }
+    column_ref operator[](size_t i) const {
+        SDL_ASSERT(i < size());
+        return (*m_schema)[m_index[i]];
+    }
+    size_t key_length() const {
+        return m_key_length;
+    }
+    size_t bookmark_length() const {
+        return m_bookmark_length;
+    }
+    tree_layout const & layout() const {
+        return m_layout;
+    }
+    recordID get_RID(row_head const *) const; // is_heap()
+    void get_cluster_key(row_head const *, char * dest) const; // dest size is cluster_index::key_length()
+
+    // calls fun(row_head const *) for leaf rows with first key column in range, in index order;
+    // rows before range (before(mem_range_t) == true) are skipped, scan stops at first row after range
+    // (after(mem_range_t) == true); rows with NULL key are not selected; load(pageFileID) returns page_head const *;
+    // fun returns bool or break_or_continue
+    template<class load_type, class before_type, class after_type, class fun_type> static
+    break_or_continue scan_range(tree_layout const &, page_head const * root,
+        load_type &&, before_type &&, after_type &&, fun_type &&);
+
+    template<class load_type, class before_type, class after_type, class fun_type>
+    break_or_continue scan_range(load_type && load, before_type && before, after_type && after, fun_type && fun) const {
+        return scan_range(m_layout, m_root, load, before, after, fun);
+    }
+private:
+    static const char * row_data(page_head const * p, size_t const slot) {
+        return reinterpret_cast<const char *>(cast::page_row<row_head>(p, slot_array(p)[slot]));
+    }
+    static bool is_index_row(const char * row) {
+        return reinterpret_cast<row_head const *>(row)->is_index_record();
+    }
+    static mem_range_t first_key(tree_layout const & t, const char * row) {
+        return { row + 1, row + 1 + t.key_size };
+    }
+    static bool is_key_null(const char * row, size_t const fixed) {
+        if (reinterpret_cast<row_head const *>(row)->has_null()) {
+            const char * const p = row + 1 + fixed; // null bitmap after fixed data
+            return (reinterpret_cast<uint16 const *>(p)[0] > 0) && (p[2] & 1);
+        }
+        return false;
+    }
+    static pageFileID child_page(tree_layout const & t, const char * row) {
+        pageFileID id;
+        memcpy(&id, row + 1 + t.node_fixed - sizeof(pageFileID), sizeof(id));
+        return id;
+    }
+private:
+    page_head const * const m_root;
+    sysidxstats_row const * const idxstat;
+    shared_usertable const m_schema;
+    column_index const m_index;
+    column_order const m_order;
+    shared_cluster_index const m_cluster;
+    size_t m_key_length = 0;                    // key columns memory size
+    size_t m_bookmark_length = 0;               // bookmark columns (not in key) or RID memory size
+    std::vector<size_t> m_cluster_offset;       // offsets of cluster key columns in leaf row
+    tree_layout m_layout;
+};
+
+using shared_secondary_index = std::shared_ptr<secondary_index>;
+using vector_secondary_index = std::vector<shared_secondary_index>;
+using shared_secondary_indexes = std::shared_ptr<vector_secondary_index>;
+
+template<class load_type, class before_type, class after_type, class fun_type>
+break_or_continue secondary_index::scan_range(tree_layout const & t, page_head const * page,
+    load_type && load, before_type && before, after_type && after, fun_type && fun)
+{
+    auto const is_before = [&t, &before](const char * const row, size_t const fixed) {
+        if (is_key_null(row, fixed)) {
+            return !t.descending; // NULL is less than any value
+        }
+        return before(first_key(t, row));
+    };
+    auto const lower_slot = [&is_before](page_head const * const p, size_t const first, size_t const fixed) {
+        size_t lo = first, hi = slot_array::size(p); // is_before is true for [first, lo)
+        while (lo < hi) {
+            const size_t mid = lo + (hi - lo) / 2;
+            if (is_before(row_data(p, mid), fixed))
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    };
+    SDL_ASSERT(page && page->is_index());
+    while (page->data.level) { // key of slot 0 is less than keys of child page
+        if (!slot_array::size(page)) {
+            return bc::continue_;
+        }
+        const size_t slot = lower_slot(page, 1, t.node_fixed) - 1;
+        page = load(child_page(t, row_data(page, slot)));
+        if (!page) {
+            throw_error<secondary_index_error>("child page not found");
+        }
+    }
+    size_t slot = lower_slot(page, 0, t.leaf_fixed);
+    for (;;) {
+        for (const size_t end = slot_array::size(page); slot < end; ++slot) {
+            const char * const row = row_data(page, slot);
+            if (!is_index_row(row)) { // ghost
+                continue;
+            }
+            if (is_key_null(row, t.leaf_fixed)) {
+                if (t.descending)
+                    return bc::continue_; // NULL keys are at the end
+                continue;
+            }
+            const mem_range_t key = first_key(t, row);
+            if (before(key)) {
+                continue;
+            }
+            if (after(key)) {
+                return bc::continue_;
+            }
+            if (is_break(make_break_or_continue(fun(reinterpret_cast<row_head const *>(row))))) {
+                return bc::break_;
+            }
+        }
+        if (page->data.nextPage.is_null()) {
+            break;
+        }
+        if (!(page = load(page->data.nextPage))) {
+            throw_error<secondary_index_error>("next page not found");
+        }
+        slot = 0;
+    }
+    return bc::continue_;
+}
+
 } // db
 } // sdl
 
@@ -0,0 +1,200 @@
+// to_buffer.cpp
+//
+#include "dataserver/system/to_buffer.h"
+#include "dataserver/common/format.h"
+
+namespace sdl { namespace db {
+
+namespace {
+
+inline char * write_digits(char * const end, uint64 value) { // writes backwards, returns first char
+    char * p = end;
+    do {
+        *--p = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value);
+    return p;
+}
+
+inline void append_02d(std::string & dest, unsigned const value) {
+    SDL_ASSERT(value < 100);
+    const char buf[2] = { static_cast<char>('0' + value / 10), static_cast<char>('0' + value % 10) };
+    dest.append(buf, 2);
+}
+
+inline void append_hex(std::string & dest, uint32 value) { // same as "%x"
+    char buf[8];
+    char * const end = buf + count_of(buf);
+    char * p = end;
+    do {
+        *--p = "0123456789abcdef"[value & 0xF];
+        value >>= 4;
+    } while (value);
+    dest.append(p, end);
+}
+
+} // namespace
+
+void to_buffer::append(std::string & dest, uint64 const value)
+{
+    char buf[24];
+    char * const end = buf + count_of(buf);
+    dest.append(write_digits(end, value), end);
+}
+
+void to_buffer::append(std::string & dest, int64 const value)
+{
+    char buf[24];
+    char * const end = buf + count_of(buf);
+    if (value < 0) {
+        char * const p = write_digits(end, uint64(0) - static_cast<uint64>(value));
+        *(p - 1) = '-';
+        dest.append(p - 1, end);
+    }
+    else {
+        dest.append(write_digits(end, static_cast<uint64>(value)), end);
+    }
+}
+
+void to_buffer::append(std::string & dest, double const value)
+{
+    char buf[64];
+    if (int p = to_string::precision()) {
+        dest += format_double(buf, value, p);
+    }
+    else {
+        dest += format_s(buf, "%g", value); // as std::stringstream
+    }
+}
+
+void to_buffer::append(std::string & dest, float const value)
+{
+    char buf[64];
+    dest += format_s(buf, "%g", static_cast<double>(value)); // as std::stringstream
+}
+
+void to_buffer::append(std::string & dest, datetime_t const & src)
+{
+    if (src.is_null()) {
+        return;
+    }
+    const gregorian_t d = src.gregorian();
+    const clocktime_t t = src.clocktime();
+    if ((d.year < 0) || (d.year > 9999)) {
+        SDL_ASSERT(0);
+        dest += to_string::type(src);
+        return;
+    }
+    append(dest, static_cast<int64>(d.year));
+    dest += '-';
+    append_02d(dest, d.month);
+    dest += '-';
+    append_02d(dest, d.day);
+    dest += ' ';
+    append_02d(dest, t.hour);
+    dest += ':';
+    append_02d(dest, t.min);
+    dest += ':';
+    append_02d(dest, t.sec);
+    dest += '.';
+    const char ms[3] = {
+        static_cast<char>('0' + t.milliseconds / 100),
+        static_cast<char>('0' + t.milliseconds / 10 % 10),
+        static_cast<char>('0' + t.milliseconds % 10) };
+    dest.append(ms, 3);
+}
+
+void to_buffer::append(std::string & dest, smalldatetime_t const d)
+{
+    dest += "[day:";
+    append(dest, static_cast<uint64>(d.day));
+    dest += " min:";
+    append(dest, static_cast<uint64>(d.min));
+    dest += ']';
+}
+
+void to_buffer::append(std::string & dest, guid_t const & g)
+{
+    append_hex(dest, g.a); dest += '-';
+    append_hex(dest, g.b); dest += '-';
+    append_hex(dest, g.c); dest += '-';
+    append_hex(dest, g.d);
+    append_hex(dest, g.e); dest += '-';
+    append_hex(dest, g.f);
+    append_hex(dest, g.g);
+    append_hex(dest, g.h);
+    append_hex(dest, g.i);
+    append_hex(dest, g.j);
+    append_hex(dest, g.k);
+}
+
+void to_buffer::append(std::string & dest, nchar_range const & p)
+{
+    for (nchar_t const * it = p.first; it != p.second; ++it) {
+        const char c = *reinterpret_cast<char const *>(it);
+        if (c)
+            dest += c;
+        else
+            break;
+    }
+}
+
+} // db
+} // sdl
+
+#if SDL_DEBUG
+namespace sdl {
+    namespace db {
+        namespace {
+            class unit_test {
+            public:
+                unit_test()
+                {
+                    std::string s("x");
+                    for (int64 const v : { int64(0), int64(-1), int64(42), int64(-1234567890123), 
+                        std::numeric_limits<int64>::min(), std::numeric_limits<int64>::max() }) {
+                        s.resize(1);
+                        to_buffer::append(s, v);
+                        SDL_ASSERT(s.substr(1) == to_string::type(v));
+                    }
+                    s.clear();
+                    to_buffer::append(s, std::numeric_limits<uint64>::max());
+                    SDL_ASSERT(s == to_string::type(std::numeric_limits<uint64>::max()));
+                    for (double const v : { 0.0, 1.5, -2.25, 1e10, 123.456789, 1.0/3 }) {
+                        s.clear();
+                        to_buffer::append(s, v);
+                        SDL_ASSERT(s == to_string::type(v));
+                        s.clear();
+                        to_buffer::append(s, static_cast<float>(v));
+                        SDL_ASSERT(s == to_string::type(static_cast<float>(v)));
+                    }
+                    {
+                        const datetime_t d = datetime_t::set_unix_time(1474363553);
+                        s.clear();
+                        to_buffer::append(s, d);
+                        SDL_ASSERT(s == to_string::type(d));
+                    }
+                    {
+                        guid_t g{};
+                        g.a = 0x12ab; g.c = 7; g.k = 0xff;
+                        s.clear();
+                        to_buffer::append(s, g);
+                        SDL_ASSERT(s == to_string::type(g));
+                        smalldatetime_t const sd = { 10, 20 };
+                        s.clear();
+                        to_buffer::append(s, sd);
+                        SDL_ASSERT(s == to_string::type(sd));
+                    }
+                    {
+                        const nchar_t w[] = { {'a'}, {'b'}, {0}, {'c'} };
+                        s.clear();
+                        to_buffer::append(s, nchar_range(w, w + count_of(w)));
+                        SDL_ASSERT(s == to_string::type(nchar_range(w, w + count_of(w))));
+                    }
+                }
+            };
+            static unit_test s_test;
+        }
+    } // db
+} // sdl
+#endif //#if SDL_DEBUG
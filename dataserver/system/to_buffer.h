@@ -0,0 +1,42 @@
+// to_buffer.h
+//
+#pragma once
+#ifndef __SDL_SYSTEM_TO_BUFFER_H__
+#define __SDL_SYSTEM_TO_BUFFER_H__
+
+#include "dataserver/system/page_info.h"
+
+namespace sdl { namespace db {
+
+// appends value to reusable output buffer without temporary strings;
+// text is the same as returned by to_string::type
+struct to_buffer : is_static {
+    static void append(std::string &, int64);
+    static void append(std::string &, uint64);
+    static void append(std::string & dest, int32 const value) {
+        append(dest, static_cast<int64>(value));
+    }
+    static void append(std::string & dest, int16 const value) {
+        append(dest, static_cast<int64>(value));
+    }
+    static void append(std::string & dest, uint32 const value) {
+        append(dest, static_cast<uint64>(value));
+    }
+    static void append(std::string & dest, uint8 const value) {
+        append(dest, static_cast<uint64>(value));
+    }
+    static void append(std::string &, double); // uses to_string::precision
+    static void append(std::string &, float);
+    static void append(std::string &, datetime_t const &);
+    static void append(std::string &, smalldatetime_t);
+    static void append(std::string &, guid_t const &);
+    static void append(std::string & dest, mem_range_t const & m) {
+        dest.append(m.first, m.second);
+    }
+    static void append(std::string &, nchar_range const &); // low byte of nchar until '\0'
+};
+
+} // db
+} // sdl
+
+#endif // __SDL_SYSTEM_TO_BUFFER_H__
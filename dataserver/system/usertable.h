@@ -116,6 +116,16 @@ public:
             return c.name == name;
         });
     }
+    // index of column for each name, size() if not found;
+    // resolved once per query instead of record_type::operator[] for every record
+    std::vector<size_t> find(std::vector<std::string> const & names) const {
+        std::vector<size_t> result;
+        result.reserve(names.size());
+        for (auto const & name : names) {
+            result.push_back(find(name));
+        }
+        return result;
+    }
     size_t find_geography() const;
     bool is_geography() const {
         return find_geography() < schema().size();
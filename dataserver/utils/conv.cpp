@@ -13,8 +13,6 @@
 namespace sdl { namespace db { namespace {
 
 #define is_static_windows_cp1251  1
-#if is_static_windows_cp1251    // setlocale = "Russian"
-
 static const uint8 table_cp1251_to_utf8[256][4] = {
 {0},{1},{2},{3},{4},{5},{6},{7},{8},{9},{10},{11},{12},{13},{14},{15},{16}, // 0..16
 {17},{18},{19},{20},{21},{22},{23},{24},{25},{26},{27},{28},{29},{30},{31},{32}, // 17..32
@@ -34,6 +32,8 @@ static const uint8 table_cp1251_to_utf8[256][4] = {
 {209,129},{209,130},{209,131},{209,132},{209,133},{209,134},{209,135},{209,136},{209,137},{209,138},{209,139},{209,140},{209,141},{209,142},{209,143}, // 241..255
 };
 
+#if is_static_windows_cp1251    // setlocale = "Russian"
+
 static const uint16 table_cp1251_to_wide[256] = {
 0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16, // 0..16
 17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,32, // 17..32
@@ -120,35 +120,12 @@ size_t length_char_utf8(const char c) {
 }
 #endif
 
-size_t length_utf8(std::string const & s) {
-    size_t count = 0;
-    for (const char c : s) {
-        for (const uint8 v : table_cp1251_to_utf8[(uint8)c]) {
-            if (v)
-                ++count;
-            else
-                break;
-        }
-    }
-    return count;
-}
-
 } // namespace
 
 std::string conv::cp1251_to_utf8(std::string const & s)
 {
-    std::string result(length_utf8(s), '\0');
-    size_t i = 0;
-    for (char c : s) {
-        for (const uint8 v : table_cp1251_to_utf8[(uint8)c]) {
-            if (v) {
-                SDL_ASSERT(i < result.size());
-                result[i++] = static_cast<char>(v);
-            }
-            else
-                break;
-        }
-    }
+    std::string result(cp1251_utf8_max(s.size()), '\0');
+    result.resize(cp1251_to_utf8(&result[0], s.data(), s.data() + s.size()));
     return result;
 }
 
@@ -190,6 +167,183 @@ std::string conv::cp1251_to_utf8(std::string const & s)
 #endif // #if defined(SDL_OS_UNIX)
 #endif // is_static_windows_cp1251
 
+namespace {
+
+struct cp1251_utf8_length_t {
+    uint8 value[256]; // length of UTF-8 sequence, '\0' is skipped
+    cp1251_utf8_length_t() {
+        for (size_t i = 0; i < 256; ++i) {
+            uint8 const * const v = table_cp1251_to_utf8[i];
+            SDL_ASSERT(!v[3]);
+            value[i] = uint8((v[0] != 0) + (v[1] != 0) + (v[2] != 0));
+        }
+    }
+};
+
+inline uint8 const * cp1251_utf8_length() { // initialized on first use, can be called from static unit tests
+    static const cp1251_utf8_length_t table;
+    return table.value;
+}
+
+inline bool is_ascii_8(const char * const p) { // 8 chars in range [1..127]
+    enum : uint64 { low = 0x0101010101010101ULL, high = 0x8080808080808080ULL };
+    uint64 v;
+    memcpy(&v, p, sizeof(v));
+    return !((v | (v - low)) & high);
+}
+
+char * cp1251_to_utf8_n(char * dest, const char * first, const char * const last)
+{
+    uint8 const * const length = cp1251_utf8_length();
+    while (first < last) {
+        if ((last - first >= 8) && is_ascii_8(first)) {
+            memcpy(dest, first, 8);
+            dest += 8;
+            first += 8;
+            continue;
+        }
+        const uint8 c = static_cast<uint8>(*first++);
+        memcpy(dest, table_cp1251_to_utf8[c], 3); // dest has space of 3 bytes per char
+        dest += length[c];
+    }
+    return dest;
+}
+
+// UTF-16LE decoder which accepts input by fragments;
+// code unit or surrogate pair can be split between fragments;
+// illegal sequences are skipped like sdl::locale::utf with method_type::skip
+class utf16_to_utf8_t : noncopyable {
+    char * m_dest;
+    uint16 m_surrogate = 0; // pending high surrogate
+    uint16 m_byte = 0;      // pending low byte of code unit
+    bool m_has_byte = false;
+public:
+    explicit utf16_to_utf8_t(char * dest) : m_dest(dest) {}
+    char * dest() const {
+        SDL_ASSERT(!m_has_byte);
+        return m_dest;
+    }
+    void append(const char * first, const char * const last) {
+        if (m_has_byte && (first < last)) {
+            m_has_byte = false;
+            code_unit(uint16(m_byte | (uint16(static_cast<uint8>(*first++)) << 8)));
+        }
+        enum : uint64 { not_ascii = 0xFF80FF80FF80FF80ULL };
+        while (last - first >= 2) {
+            if (!m_surrogate && (last - first >= 8)) { // 4 code units
+                uint64 v;
+                memcpy(&v, first, sizeof(v));
+                if (!(v & not_ascii)) {
+                    m_dest[0] = static_cast<char>(v);
+                    m_dest[1] = static_cast<char>(v >> 16);
+                    m_dest[2] = static_cast<char>(v >> 32);
+                    m_dest[3] = static_cast<char>(v >> 48);
+                    m_dest += 4;
+                    first += 8;
+                    continue;
+                }
+            }
+            code_unit(uint16(static_cast<uint8>(first[0]) | (uint16(static_cast<uint8>(first[1])) << 8)));
+            first += 2;
+        }
+        if (first < last) {
+            m_byte = static_cast<uint8>(*first);
+            m_has_byte = true;
+        }
+    }
+private:
+    void code_unit(uint16 const w) {
+        if (m_surrogate) {
+            const uint32 w1 = m_surrogate;
+            m_surrogate = 0;
+            if ((w >= 0xDC00) && (w <= 0xDFFF)) {
+                code_point(0x10000 + (((w1 - 0xD800) << 10) | (w - 0xDC00)));
+            }
+            return; // illegal pair is skipped
+        }
+        if ((w < 0xD800) || (w > 0xDFFF)) {
+            code_point(w);
+        }
+        else if (w <= 0xDBFF) {
+            m_surrogate = w;
+        }
+    }
+    void code_point(uint32 const c) {
+        if (c < 0x80) {
+            *m_dest++ = static_cast<char>(c);
+        }
+        else if (c < 0x800) {
+            m_dest[0] = static_cast<char>(0xC0 | (c >> 6));
+            m_dest[1] = static_cast<char>(0x80 | (c & 0x3F));
+            m_dest += 2;
+        }
+        else if (c < 0x10000) {
+            m_dest[0] = static_cast<char>(0xE0 | (c >> 12));
+            m_dest[1] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            m_dest[2] = static_cast<char>(0x80 | (c & 0x3F));
+            m_dest += 3;
+        }
+        else {
+            m_dest[0] = static_cast<char>(0xF0 | (c >> 18));
+            m_dest[1] = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            m_dest[2] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            m_dest[3] = static_cast<char>(0x80 | (c & 0x3F));
+            m_dest += 4;
+        }
+    }
+};
+
+} // namespace
+
+size_t conv::cp1251_to_utf8(char * const dest, const char * const first, const char * const last)
+{
+    SDL_ASSERT(first <= last);
+    return cp1251_to_utf8_n(dest, first, last) - dest;
+}
+
+size_t conv::cp1251_to_utf8(char * const dest, vector_mem_range_t const & data)
+{
+    char * p = dest;
+    for (auto const & m : data) {
+        p = cp1251_to_utf8_n(p, m.first, m.second);
+    }
+    return p - dest;
+}
+
+size_t conv::nchar_to_utf8(char * const dest, vector_mem_range_t const & data)
+{
+    if (is_odd(mem_size(data))) {
+        SDL_ASSERT(0);
+        return 0;
+    }
+    utf16_to_utf8_t decoder(dest);
+    for (auto const & m : data) {
+        decoder.append(m.first, m.second);
+    }
+    return decoder.dest() - dest;
+}
+
+void conv::append_cp1251_to_utf8(std::string & s, vector_mem_range_t const & data)
+{
+    const size_t old = s.size();
+    s.resize(old + cp1251_utf8_max(mem_size(data)));
+    s.resize(old + cp1251_to_utf8(&s[old], data));
+}
+
+void conv::append_nchar_to_utf8(std::string & s, vector_mem_range_t const & data)
+{
+    const size_t old = s.size();
+    s.resize(old + nchar_utf8_max(mem_size(data)));
+    s.resize(old + nchar_to_utf8(&s[old], data));
+}
+
+std::string conv::cp1251_to_utf8(vector_mem_range_t const & data)
+{
+    std::string s;
+    append_cp1251_to_utf8(s, data);
+    return s;
+}
+
 std::wstring conv::utf8_to_wide(std::string const & s)
 {
     if (s.empty()) 
@@ -206,7 +360,9 @@ std::string conv::wide_to_utf8(std::wstring const & s)
 
 std::string conv::nchar_to_utf8(vector_mem_range_t const & data)
 {
-    return nchar_to_string<std::string>(data);
+    std::string s;
+    append_nchar_to_utf8(s, data);
+    return s;
 }
 
 std::wstring conv::nchar_to_wide(vector_mem_range_t const & data)
@@ -268,8 +424,52 @@ namespace sdl { namespace db { namespace {
                 table_cp1251_to_wide();
 #endif
             }
+            test_transcode();
         }
     private:
+        static vector_mem_range_t split(std::string const & s, size_t const step) {
+            vector_mem_range_t data;
+            for (size_t i = 0; i < s.size(); i += step) {
+                data.push_back({ s.data() + i, s.data() + a_min(i + step, s.size()) });
+            }
+            return data;
+        }
+        void test_transcode() {
+            std::string cp1251;
+            for (size_t i = 0; i < 600; ++i) {
+                cp1251 += static_cast<char>((i % 5) ? ('a' + i % 26) : (0xC0 + i % 64));
+            }
+            for (size_t i = 0; i < 256; ++i) {
+                const std::string s1(1, static_cast<char>(i));
+                std::string expect;
+                for (const uint8 v : db::table_cp1251_to_utf8[i]) {
+                    if (!v) break;
+                    expect += static_cast<char>(v);
+                }
+                SDL_ASSERT(conv::cp1251_to_utf8(s1) == expect);
+                cp1251 += s1;
+            }
+            const std::string utf8 = conv::cp1251_to_utf8(cp1251);
+            SDL_ASSERT(utf8.size() > cp1251.size());
+            std::string buf("prefix");
+            for (size_t step : { 1, 3, 7, 8, 64, 1000 }) {
+                buf.resize(6);
+                conv::append_cp1251_to_utf8(buf, split(cp1251, step));
+                SDL_ASSERT(buf.substr(6) == utf8);
+            }
+            const uint16 utf16[] = { 'H', 'i', 0x41F, 0x440, 0x438, 0x20AC, ' ',
+                0xD83D, 0xDE00,         // surrogate pair
+                'a', 'b', 'c', 'd',
+                0xDC00, 'x',            // illegal low surrogate
+                0xD800, 'y', 'z',       // illegal high surrogate
+                0, 0x7F, 0x80, 0x7FF, 0x800, 0xFFFF, 'e', 'n', 'd', 0xDBFF, 0xDFFF };
+            const std::string nchar(reinterpret_cast<const char *>(utf16), sizeof(utf16));
+            const std::string expect = nchar_to_string<std::string>(split(nchar, nchar.size()));
+            SDL_ASSERT(!expect.empty());
+            for (size_t step = 1; step <= nchar.size(); ++step) {
+                SDL_ASSERT(conv::nchar_to_utf8(split(nchar, step)) == expect);
+            }
+        }
         void test_conv() {
             const auto old = conv::method_stop();
             conv::method_stop(true);
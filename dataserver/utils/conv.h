@@ -11,11 +11,25 @@ namespace sdl { namespace db {
 struct conv : is_static {
     static std::wstring cp1251_to_wide(std::string const &); // https://en.wikipedia.org/wiki/Windows-1251
     static std::string cp1251_to_utf8(std::string const &);
+    static std::string cp1251_to_utf8(vector_mem_range_t const &);
     static std::wstring utf8_to_wide(std::string const &);
     static std::string wide_to_utf8(std::wstring const &);
     static std::string nchar_to_utf8(vector_mem_range_t const &);
     static std::wstring nchar_to_wide(vector_mem_range_t const &);
     static bool is_utf8(std::string const &);
+public: // table-driven transcoders into caller buffer, no allocation and no lock, input can be fragmented
+    static constexpr size_t cp1251_utf8_max(size_t const bytes) { // capacity of dest
+        return bytes * 3;
+    }
+    static constexpr size_t nchar_utf8_max(size_t const bytes) { // capacity of dest, UTF-16LE
+        return bytes / 2 * 3;
+    }
+    static size_t cp1251_to_utf8(char * dest, const char * first, const char * last); // returns bytes written
+    static size_t cp1251_to_utf8(char * dest, vector_mem_range_t const &);
+    static size_t nchar_to_utf8(char * dest, vector_mem_range_t const &);
+    static void append_cp1251_to_utf8(std::string &, vector_mem_range_t const &); // reuses capacity of string
+    static void append_nchar_to_utf8(std::string &, vector_mem_range_t const &);
+public:
     static bool method_stop();
     static void method_stop(bool);
 #if SDL_DEBUG // reserved
@@ -29,72 +29,44 @@ public:
     }
 };
 
-class make_iconv_t : noncopyable {
-    using shared_iconv_t = std::shared_ptr<h_iconv_t>;
-    shared_iconv_t m_current;
-private:
-    make_iconv_t() = default;
-    shared_iconv_t make() {
-        shared_iconv_t p = m_current; m_current.reset();
-        if (!p.unique()) { // empty pointers are never unique 
-            reset_new(p, "UTF-8", "WINDOWS-1251");
-        }
-        SDL_ASSERT(p.unique());
-        return p;
-    }
-    void push(shared_iconv_t && p) {
-        m_current = std::move(p);
-    }
-public:
-    static make_iconv_t & instance() {
-        static make_iconv_t obj;
-        return obj;
-    }
-    class lock_iconv_t : noncopyable {
-        make_iconv_t & parent;
-        shared_iconv_t value;
-    public:
-        explicit lock_iconv_t(make_iconv_t & p): parent(p){
-            value = parent.make();
-            SDL_ASSERT(value.get());
-        }
-        ~lock_iconv_t(){
-            parent.push(std::move(value));
-        }
-        bool is_open() const {
-            return value->is_open();
-        }
-        iconv_t handle() const {
-            return value->handle();
-        }
-    };
-};
+namespace {
+
+// iconv handle is not shared between threads, so no lock is needed
+h_iconv_t & thread_iconv_cp1251() {
+    thread_local h_iconv_t cd("UTF-8", "WINDOWS-1251");
+    return cd;
+}
+
+h_iconv_t & thread_iconv_utf16() {
+    thread_local h_iconv_t cd("UTF-8", "UTF-16LE");
+    return cd;
+}
 
 // http://man7.org/linux/man-pages/man3/iconv.3.html
-std::string iconv_cp1251_to_utf8(const std::string & s)
+std::string iconv_to_utf8(h_iconv_t & cd, const char * const data, size_t const size)
 {
-    if (s.empty())
+    if (!size)
         return {};
  
-    make_iconv_t::lock_iconv_t lock(make_iconv_t::instance());
-    if (!lock.is_open()) {
+    if (!cd.is_open()) {
         SDL_ASSERT(0);
         return {};
     }
 
     for (size_t i = 1; i < 3; ++i) {
 
-        const char * inbuf = s.data();
-        size_t inbytesleft = s.size();
-        SDL_ASSERT(*inbuf);
+        iconv(cd.handle(), nullptr, nullptr, nullptr, nullptr); // reset conversion state
 
-        const size_t bufsize = (s.size() + 1) << i; // * 2, * 4
+        const char * inbuf = data;
+        size_t inbytesleft = size;
+
+        const size_t bufsize = (size + 1) << i; // * 2, * 4
         std::unique_ptr<char[]> buf (new char[bufsize]);
         char * outbuf = buf.get();    
         size_t outbytesleft = bufsize;
     
         // iconv returns the number of characters converted in a nonreversible way during this call
-        const auto ret = iconv(lock.handle(),
+        const auto ret = iconv(cd.handle(),
             (char **)(&inbuf),  // the address of a variable that points to the first character of the input sequence
             &inbytesleft,       // indicates the number of bytes in that buffer
             &outbuf,            // the address of a variable that points to the first byte available in the output buffer
@@ -102,7 +74,7 @@ std::string iconv_cp1251_to_utf8(const std::string & s)
         A_STATIC_CHECK_TYPE(const size_t, ret);
 
         if (ret != (size_t)(-1)) {
-            SDL_ASSERT(ret <= s.size());
+            SDL_ASSERT(ret <= size);
             SDL_ASSERT(outbytesleft <= bufsize);
             if (outbytesleft < bufsize) {
                 return std::string(buf.get(), bufsize - outbytesleft);
@@ -118,6 +90,20 @@ std::string iconv_cp1251_to_utf8(const std::string & s)
     return{};
 }
 
+} // namespace
+
+std::string iconv_cp1251_to_utf8(const std::string & s)
+{
+    SDL_ASSERT(s.empty() || s[0]);
+    return iconv_to_utf8(thread_iconv_cp1251(), s.data(), s.size());
+}
+
+std::string iconv_utf16_to_utf8(const char * const data, size_t const size)
+{
+    SDL_ASSERT(!is_odd(size));
+    return iconv_to_utf8(thread_iconv_utf16(), data, size);
+}
+
 } // unix_
 } // db
 } // sdl
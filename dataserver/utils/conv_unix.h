@@ -10,7 +10,9 @@
 
 namespace sdl { namespace db { namespace unix_ {
 
+// iconv handles are created once per thread
 std::string iconv_cp1251_to_utf8(const std::string &);
+std::string iconv_utf16_to_utf8(const char *, size_t); // UTF-16LE
 
 } // unix_
 } // db